@@ -3,48 +3,53 @@
 #include "state.hpp"
 
 
-Algorithm::Result::Type AStar::update()
+template<typename Policy>
+Algorithm::Result::Type AStar<Policy>::update()
 {
-    if(open.empty())
+    // Skip the stale entries of already examined nodes.
+    // Only open lists with duplicates (see open_list.hpp) leave them behind.
+    node_index node_idx;
+    do
     {
-        result.type = Result::Type::FAILURE;
-        return Result::Type::FAILURE;
-    }
+        if(open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
 
-    auto [approx_dist, node_idx] = open.top();
-    open.pop();
+        node_idx = open.top().second;
+        open.pop();
+    }
+    while(nodes[node_idx].status() == InternalNode::Status::EXAMINED);
 
-    auto [x, y] = Util::expand(state->width, node_idx);
+    auto [x, y] = layout.expand(node_idx);
     auto& node = nodes[node_idx];
 
-    if(node.status == InternalNode::Status::EXAMINED)
-    {
-        // Skip this node by calling the update()-function again
-        return update();
-    }
-
-    node.status = InternalNode::Status::EXAMINED;
+    node.set_status(InternalNode::Status::EXAMINED);
+    // Copied, as touching the neighbours may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
     result.expanded++;
 
-    // Is the current node the first node? If not, set it to EXPANDED
-    if(node.prev != NULL_NODE_IDX)
-    {
-        state->map[node_idx] = Node::EXPANDED_1;
-    }
+    Observer::expanded(*state, layout.map_index(node_idx));
 
     std::pair<node_index, dir_t> neighbours[8];
-    auto amount_neighbours = Util::get_neighbours(neighbours, *state, x, y);
+    auto amount_neighbours = Util::get_neighbours(neighbours, grid, layout, x, y);
 
     for(int i = 0; i < amount_neighbours; ++i)
     {
         auto [neighbour_idx, dir] = neighbours[i];
-        auto& neighbour = nodes[neighbour_idx];
-        Util::lazy_initialize(curr_run_id, neighbour);
-        auto [neighbour_x, neighbour_y] = Util::expand(state->width, neighbour_idx);
+        if constexpr(Policy::goal_bounding)
+        {
+            if(!bounds.contains(x, y, dir, state->end.x, state->end.y))
+                continue;
+        }
+
+        auto& neighbour = nodes.touch(neighbour_idx);
+        auto [neighbour_x, neighbour_y] = layout.expand(neighbour_idx);
         
         // All perpendicular neighbours are one unit of distance away
-        // and all the diagonal neigbours are sqrt(2) units of distance away.
-        float new_dist = node.distance + (dir->straight ? 1.0f : SQRT_2);
+        // and all the diagonal neigbours are sqrt(2) units of distance away (see cost.hpp).
+        distance_t new_dist = node_distance + Cost::move(dir);
         if(new_dist < neighbour.distance)
         {
             // We have found a new, more optimized way to reach this node.
@@ -52,31 +57,53 @@ Algorithm::Result::Type AStar::update()
             // The used heuristic is manhattan distance |x1 - x2| + |y1 - y2|.
 
             neighbour.distance = new_dist;
-            neighbour.prev = node_idx;
+            nodes.parent(neighbour_idx) = node_idx;
 
             // Check if the neigbour is the end
             if(neighbour_x == state->end.x && neighbour_y == state->end.y)
             {
                 // End & path found!
-                Util::build_path<InternalNode>(*state, &nodes[0], result);
-                result.length = neighbour.distance;
+                Util::build_path<Observer>(*state, layout, nodes.parents(), result);
+                result.length = Cost::to_float(neighbour.distance);
                 result.type = Result::Type::SUCCESS;
 
                 return Result::Type::SUCCESS;
             }
             else
             {
-                state->map[neighbour_idx] = Node::EXAMINED_1;
+                Observer::examined(*state, layout.map_index(neighbour_idx));
             }
 
-            neighbour.status = InternalNode::Status::UNEXAMINED;
-            float approx_total_path_length =
-                new_dist + Util::diagonal_distance(neighbour_x, neighbour_y, state->end.x, state->end.y);
-            open.emplace(approx_total_path_length, neighbour_idx);
+            neighbour.set_status(InternalNode::Status::UNEXAMINED);
+            distance_t approx_total_path_length =
+                new_dist + heuristic(neighbour_x, neighbour_y, state->end.x, state->end.y);
+            open.push(approx_total_path_length, neighbour_idx);
         }
 
         result.examined++;
     }
 
     return Result::Type::EXECUTING;
-}
\ No newline at end of file
+}
+
+template class AStar<HeadlessPolicy>;
+template class AStar<VisualPolicy>;
+template class AStar<PowerOfTwoStride<HeadlessPolicy>>;
+template class AStar<IntegerCost<HeadlessPolicy>>;
+template class AStar<IntegerCost<VisualPolicy>>;
+template class AStar<IndexedOpenList<HeadlessPolicy>>;
+template class AStar<IndexedOpenList<VisualPolicy>>;
+template class AStar<RadixOpenList<IntegerCost<HeadlessPolicy>>>;
+template class AStar<RadixOpenList<IntegerCost<VisualPolicy>>>;
+template class AStar<NarrowStamps<HeadlessPolicy>>;
+template class AStar<HashedNodes<HeadlessPolicy>>;
+template class AStar<HashedNodes<VisualPolicy>>;
+template class AStar<AdaptiveNodes<HeadlessPolicy>>;
+template class AStar<GoalBounding<HeadlessPolicy>>;
+template class AStar<GoalBounding<VisualPolicy>>;
+template class AStar<DifferentialHeuristic<HeadlessPolicy>>;
+template class AStar<DifferentialHeuristic<VisualPolicy>>;
+template class AStar<DifferentialHeuristic<HeadlessPolicy, 4>>;
+template class AStar<DifferentialHeuristic<VisualPolicy, 4>>;
+template class AStar<DifferentialHeuristic<HeadlessPolicy, 16>>;
+template class AStar<DifferentialHeuristic<VisualPolicy, 16>>;
\ No newline at end of file
@@ -9,11 +9,20 @@
 #include "state.hpp"
 #include "algorithms/common.hpp"
 #include "algorithms/util.hpp"
+#include "algorithms/policies.hpp"
 
-class AStar : public CommonAlgorithm
+template<typename Policy = HeadlessPolicy>
+class AStar : public CommonAlgorithm<Policy>
 {
 public:
     Algorithm::Result::Type update();
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open, Base::bounds, Base::heuristic;
 };
 
 #endif
\ No newline at end of file
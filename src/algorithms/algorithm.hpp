@@ -1,6 +1,11 @@
 #ifndef ALGORITHM_HPP
 #define ALGORITHM_HPP
 
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "state.hpp"
@@ -43,6 +48,56 @@ public:
      */
     virtual Result get_result() { return result; }
 
+    /**
+     * Gets the amount of memory (in bytes) currently allocated for the internal search structures of the algorithm,
+     * for example the node records. Used for benchmarking.
+     */
+    virtual size_t get_memory_usage() { return 0; }
+
+    /**
+     * Gets the time (in microseconds) spent on preprocessing the map of the last init(),
+     * or 0 if the algorithm does no preprocessing or the preprocessed data was loaded (see load_preprocessed()).
+     */
+    virtual double get_preprocessing_time() { return 0; }
+
+    /**
+     * Gets the amount of memory (in bytes) taken by the preprocessed data of the current map.
+     * Also included in get_memory_usage().
+     */
+    virtual size_t get_preprocessed_memory_usage() { return 0; }
+
+    /**
+     * Gets algorithm-specific statistics of the preprocessed data of the current map as (name, value) pairs,
+     * for example the amount of shortcuts added by a contraction hierarchy. Used for benchmarking.
+     */
+    virtual std::vector<std::pair<std::string, double>> get_preprocessed_statistics() { return {}; }
+
+    /**
+     * Writes the preprocessed data of the map of the last init() into the stream.
+     *
+     * The algorithms that preprocess the map do it in init(), on the first query of a map and whenever its walls change
+     * (see State::revision), and keep the data for the next queries. The data is only valid for the walls it was made for,
+     * so the saved data is checked against the map when it is loaded (see PreprocessedKey).
+     *
+     * @returns Whether anything was written, i.e. false if the algorithm does no preprocessing.
+     */
+    virtual bool save_preprocessed(std::ostream& /*out*/) { return false; }
+
+    /**
+     * Reads preprocessed data written by save_preprocessed(), so that the next init() with the state does not preprocess again.
+     *
+     * @returns Whether the data was loaded. False if the data is invalid or was made for another map.
+     */
+    virtual bool load_preprocessed(const State& /*state*/, std::istream& /*in*/) { return false; }
+
+    /**
+     * Repairs the preprocessed data of the map of the last init() after a single cell (x, y) became a wall or stopped being one,
+     * with the State::revision incremented once for the change. Called for every such change, before the next init().
+     *
+     * @returns Whether the data was repaired. If not, the next init() preprocesses the map again as usual.
+     */
+    virtual bool update_preprocessed(const State& /*state*/, int /*x*/, int /*y*/) { return false; }
+
 protected:
     State* state;
     
@@ -1,43 +1,44 @@
 #include "algorithms/bbfs.hpp"
 
-void BBFS::init(State* s)
+template<typename Policy>
+void BBFS<Policy>::init(State* s)
 {
     state = s;
-    curr_run_id++;
+    grid.update(*s, Policy::precompute_successors);
     result = Algorithm::Result{};
 
     best_start_to_mid_node = NULL_NODE_IDX;
     best_end_to_mid_node   = NULL_NODE_IDX;
-    best_path_distance = std::numeric_limits<float>::infinity();
+    best_path_distance = INFINITE_DISTANCE;
 
     // Initialize the nodes vector.
-    if(nodes.capacity() != s->map.size())
-    {
-        nodes = std::vector<BBFSInternal>(s->map.size());
-    }
+    layout.init(s->width, s->height);
+    nodes.begin_run(layout.size(), {s, s->revision});
+    parents.lease(layout.size(), {s, s->revision});
 
     start_queue = std::queue<node_index>();
     end_queue   = std::queue<node_index>();
 
-    auto start_index = Util::flatten(s->width, s->begin.x, s->begin.y);
-    auto& start_node = nodes[start_index];
-    Util::lazy_initialize(curr_run_id, start_node);
-    start_node.distance = 0.0f;
-    start_node.status = BBFSInternal::Status::SEARCHED_START;
+    auto start_index = layout.flatten(s->begin.x, s->begin.y);
+    auto& start_node = nodes.touch(start_index);
+    start_node.distance = 0;
+    start_node.set_status(BBFSInternal::Status::SEARCHED_START);
+    parents[start_index] = NULL_NODE_IDX;
     start_queue.push(start_index);
 
-    auto end_index = Util::flatten(s->width, s->end.x, s->end.y);
-    auto& end_node = nodes[end_index];
-    Util::lazy_initialize(curr_run_id, end_node);
-    end_node.distance = 0.0f;
-    end_node.status = BBFSInternal::Status::SEARCHED_END;
+    auto end_index = layout.flatten(s->end.x, s->end.y);
+    auto& end_node = nodes.touch(end_index);
+    end_node.distance = 0;
+    end_node.set_status(BBFSInternal::Status::SEARCHED_END);
+    parents[end_index] = NULL_NODE_IDX;
     end_queue.push(end_index);
 }
 
-Algorithm::Result::Type BBFS::update()
+template<typename Policy>
+Algorithm::Result::Type BBFS<Policy>::update()
 {
-    lowest_end_distance   = std::numeric_limits<float>::infinity();
-    lowest_start_distance = std::numeric_limits<float>::infinity();
+    lowest_end_distance   = INFINITE_DISTANCE;
+    lowest_start_distance = INFINITE_DISTANCE;
 
     std::pair<node_index, dir_t> neighbours[8];
 
@@ -50,34 +51,29 @@ Algorithm::Result::Type BBFS::update()
         {
             auto node_idx = q.front();
             auto& node = nodes[node_idx];
-            auto [x, y] = Util::expand(state->width, node_idx);
+            auto [x, y] = layout.expand(node_idx);
 
             if(start)
                 lowest_start_distance = std::min(lowest_start_distance, node.distance);
             else
                 lowest_end_distance = std::min(lowest_end_distance, node.distance);
 
-            if(node.prev != NULL_NODE_IDX)
-            {
-                state->map[node_idx] = Node::EXPANDED_1;
-            }
+            Observer::expanded(*state, layout.map_index(node_idx));
 
-            auto amount_neighbours = Util::get_neighbours(neighbours, *state, x, y);
+            auto amount_neighbours = Util::get_neighbours(neighbours, grid, layout, x, y);
 
             for(int i = 0; i < amount_neighbours; ++i)
             {
                 auto [neighbour_idx, dir] = neighbours[i];
-                auto& neighbour = nodes[neighbour_idx];
-
-                Util::lazy_initialize(curr_run_id, neighbour);
+                auto& neighbour = nodes.touch(neighbour_idx);
 
-                auto [neighbour_x, neighbour_y] = Util::expand(state->width, neighbour_idx);
-                float new_dist = node.distance + (dir->straight ? 1.0f : SQRT_2);
+                auto [neighbour_x, neighbour_y] = layout.expand(neighbour_idx);
+                distance_t new_dist = node.distance + Cost::move(dir);
 
-                if(!start && neighbour.status == BBFSInternal::Status::SEARCHED_START
-                 || start && neighbour.status == BBFSInternal::Status::SEARCHED_END)
+                if(!start && neighbour.status() == BBFSInternal::Status::SEARCHED_START
+                 || start && neighbour.status() == BBFSInternal::Status::SEARCHED_END)
                 {
-                    float new_path_dist = new_dist + neighbour.distance;
+                    distance_t new_path_dist = new_dist + neighbour.distance;
                     if(new_path_dist < best_path_distance)
                     {
                         best_path_distance     = new_path_dist;
@@ -88,13 +84,13 @@ Algorithm::Result::Type BBFS::update()
                 else if(new_dist < neighbour.distance)
                 {
                     neighbour.distance = new_dist;
-                    neighbour.prev = node_idx;
-                    if(neighbour.status == BBFSInternal::Status::UNSEARCHED)
+                    parents[neighbour_idx] = node_idx;
+                    if(neighbour.status() == BBFSInternal::Status::UNSEARCHED)
                     {
                         q.push(neighbour_idx);
-                        neighbour.status = start ? BBFSInternal::Status::SEARCHED_START : BBFSInternal::SEARCHED_END;
+                        neighbour.set_status(start ? BBFSInternal::Status::SEARCHED_START : BBFSInternal::SEARCHED_END);
 
-                        state->map[neighbour_idx] = Node::EXAMINED_1;
+                        Observer::examined(*state, layout.map_index(neighbour_idx));
                     }
                     else
                     {
@@ -108,19 +104,23 @@ Algorithm::Result::Type BBFS::update()
         }
     }
 
-    if(best_path_distance == std::numeric_limits<float>::infinity()
-    && lowest_start_distance == std::numeric_limits<float>::infinity()
-    && lowest_end_distance == std::numeric_limits<float>::infinity())
+    if(best_path_distance == INFINITE_DISTANCE
+    && lowest_start_distance == INFINITE_DISTANCE
+    && lowest_end_distance == INFINITE_DISTANCE)
     {
         return Algorithm::Result::FAILURE;
     }
 
-    if(lowest_start_distance + lowest_end_distance > best_path_distance)
+    // The infinite distances are compared separately, as adding them would overflow integer distances.
+    if(best_path_distance != INFINITE_DISTANCE
+    && (lowest_start_distance == INFINITE_DISTANCE
+     || lowest_end_distance == INFINITE_DISTANCE
+     || lowest_start_distance + lowest_end_distance > best_path_distance))
     {
         // End found!
-        Util::format_bidirectional_nodes(&nodes[0], best_start_to_mid_node, best_end_to_mid_node);
-        Util::build_path<BBFSInternal>(*state, &nodes[0], result);
-        result.length = best_path_distance;
+        Util::format_bidirectional_nodes(&parents[0], best_start_to_mid_node, best_end_to_mid_node);
+        Util::build_path<Observer>(*state, layout, &parents[0], result);
+        result.length = Cost::to_float(best_path_distance);
         result.type = Result::Type::SUCCESS;
 
         return Algorithm::Result::SUCCESS;
@@ -129,7 +129,16 @@ Algorithm::Result::Type BBFS::update()
     return Algorithm::Result::EXECUTING;
 }
 
-void BBFS::recursive_update(node_index idx, bool start)
+template<typename Policy>
+size_t BBFS<Policy>::get_memory_usage()
+{
+    return nodes.get_memory_usage()
+        + parents.get_memory_usage()
+        + grid.get_memory_usage();
+}
+
+template<typename Policy>
+void BBFS<Policy>::recursive_update(node_index idx, bool start)
 {
     /*
     * Uncomment to add optimality but decrease performance significantly.
@@ -148,9 +157,9 @@ void BBFS::recursive_update(node_index idx, bool start)
         {
             auto node_idx = q.front();
             auto& node = nodes[node_idx];
-            auto [x, y] = Util::expand(state->width, node_idx);
+            auto [x, y] = layout.expand(node_idx);
 
-            auto amount_neighbours = Util::get_neighbours(neighbours, *state, x, y);
+            auto amount_neighbours = Util::get_neighbours(neighbours, grid, layout, x, y);
 
             for(int i = 0; i < amount_neighbours; ++i)
             {
@@ -159,13 +168,13 @@ void BBFS::recursive_update(node_index idx, bool start)
 
                 check_node_initialized(neighbour);
 
-                auto [neighbour_x, neighbour_y] = Util::expand(state->width, neighbour_idx);
-                float new_dist = node.distance + (dir->straight ? 1.0f : SQRT_2);
+                auto [neighbour_x, neighbour_y] = layout.expand(neighbour_idx);
+                distance_t new_dist = node.distance + Cost::move(dir);
 
-                if(!start && neighbour.status == BBFSInternal::Status::SEARCHED_START
-                    || start && neighbour.status == BBFSInternal::Status::SEARCHED_END)
+                if(!start && neighbour.status() == BBFSInternal::Status::SEARCHED_START
+                    || start && neighbour.status() == BBFSInternal::Status::SEARCHED_END)
                 {
-                    float new_path_dist = new_dist + neighbour.distance;
+                    distance_t new_path_dist = new_dist + neighbour.distance;
                     if(new_path_dist < best_path_distance)
                     {
                         best_path_distance     = new_path_dist;
@@ -173,10 +182,10 @@ void BBFS::recursive_update(node_index idx, bool start)
                         best_end_to_mid_node   = start ? neighbour_idx : node_idx;
                     }
                 }
-                else if(new_dist < neighbour.distance && neighbour.status != BBFSInternal::Status::UNSEARCHED)
+                else if(new_dist < neighbour.distance && neighbour.status() != BBFSInternal::Status::UNSEARCHED)
                 {
                     neighbour.distance = new_dist;
-                    neighbour.prev = node_idx;
+                    parents[neighbour_idx] = node_idx;
                     q.push(neighbour_idx);
                 }
             }
@@ -184,4 +193,8 @@ void BBFS::recursive_update(node_index idx, bool start)
         }
     }
     */
-}
\ No newline at end of file
+}
+
+template class BBFS<HeadlessPolicy>;
+template class BBFS<VisualPolicy>;
+template class BBFS<IntegerCost<HeadlessPolicy>>;
\ No newline at end of file
@@ -5,45 +5,51 @@
 #include <queue>
 #include "algorithms/algorithm.hpp"
 #include "algorithms/util.hpp"
-
-struct BBFSInternal
-{
-    enum Status : uint8_t
-    {
-        UNSEARCHED      = 0,
-        SEARCHED_START  = 1,
-        SEARCHED_END    = 2
-    };
-
-    node_index prev = NULL_NODE_IDX;
-    float distance = std::numeric_limits<float>::max();
-    uint32_t last_run = 0;
-
-    Status status = UNSEARCHED;
-};
+#include "algorithms/search_node.hpp"
+#include "algorithms/scratch_arena.hpp"
+#include "algorithms/policies.hpp"
 
 /**
  * Bidirectional Breadth-First Search
  */
+template<typename Policy = HeadlessPolicy>
 class BBFS : public Algorithm
 {
 public:
     void init(State* state);
     Result::Type update();
+    size_t get_memory_usage();
 
 private:
-    uint32_t curr_run_id = 0;
+    using Observer = typename Policy::Observer;
+    using Cost = typename Policy::Cost;
+    using distance_t = typename Cost::distance_t;
+
+    struct BBFSInternal : SearchNode<distance_t, typename Policy::Stamp>
+    {
+        enum Status : uint8_t
+        {
+            UNSEARCHED      = 0,
+            SEARCHED_START  = 1,
+            SEARCHED_END    = 2
+        };
+    };
+
+    static constexpr distance_t INFINITE_DISTANCE = BBFSInternal::INFINITE_DISTANCE;
 
-    std::vector<BBFSInternal> nodes;
+    ScratchArena<BBFSInternal> nodes;
+    ScratchBuffer<node_index> parents;
+    Grid grid;
+    typename Policy::Layout layout;
 
     std::queue<node_index> start_queue;
     std::queue<node_index> end_queue;
 
     node_index best_start_to_mid_node = NULL_NODE_IDX;
     node_index best_end_to_mid_node   = NULL_NODE_IDX;
-    float best_path_distance = std::numeric_limits<float>::infinity();
-    float lowest_start_distance;
-    float lowest_end_distance;
+    distance_t best_path_distance = INFINITE_DISTANCE;
+    distance_t lowest_start_distance;
+    distance_t lowest_end_distance;
 
     void recursive_update(node_index idx, bool start);
 };
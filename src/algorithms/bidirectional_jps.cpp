@@ -0,0 +1,189 @@
+#include "algorithms/bidirectional_jps.hpp"
+#include "state.hpp"
+
+#include <algorithm>
+#include <utility>
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::init(State* s)
+{
+    Base::init(s);
+
+    best_length = InternalNode::INFINITE_DISTANCE;
+    meeting = NULL_NODE_IDX;
+
+    backward_nodes.begin_run(layout.size(), {s, s->revision});
+    backward_open.init(layout.size());
+
+    auto end_index = layout.flatten(s->end.x, s->end.y);
+    backward_nodes.touch(end_index).distance = 0;
+    backward_nodes.parent(end_index) = NULL_NODE_IDX;
+    backward_open.push(Cost::heuristic(s->end.x, s->end.y, s->begin.x, s->begin.y), end_index);
+
+    // The searches meet right away if the beginning is the end.
+    meet(false, end_index, 0);
+}
+
+template<typename Policy>
+Algorithm::Result::Type BidirectionalJumpPointSearch<Policy>::update()
+{
+    skip_examined(true);
+    skip_examined(false);
+
+    if(open.empty() || backward_open.empty()
+    || best_length <= open.top().first || best_length <= backward_open.top().first)
+    {
+        if(meeting == NULL_NODE_IDX)
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        build_path();
+        result.length = Cost::to_float(best_length);
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    expand(open.size() <= backward_open.size());
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::skip_examined(bool forward)
+{
+    auto& side_nodes = nodes_of(forward);
+    auto& side_open = open_of(forward);
+    while(!side_open.empty() && side_nodes[side_open.top().second].status() == InternalNode::Status::EXAMINED)
+        side_open.pop();
+}
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::expand(bool forward)
+{
+    auto& side_nodes = nodes_of(forward);
+    auto& side_open = open_of(forward);
+
+    node_index node_idx = side_open.top().second;
+    side_open.pop();
+
+    auto [x, y] = layout.expand(node_idx);
+    auto& node = side_nodes[node_idx];
+
+    node.set_status(InternalNode::Status::EXAMINED);
+    // Copied, as jumping may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
+
+    // The jump point may have become useless after it was added to the open list.
+    if(!is_promising(forward, x, y, node_distance))
+        return;
+
+    result.expanded++;
+
+    Observer::expanded(*state, layout.map_index(node_idx), forward);
+
+    const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+    for(int i = 0; i < successors.amount; ++i)
+        jump(forward, node_idx, directions[successors.directions[i]], node_distance);
+}
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::jump(bool forward, node_index prev, dir_t dir, distance_t distance)
+{
+    auto& side_nodes = nodes_of(forward);
+    Point target = forward ? state->end : state->begin;
+
+    auto [x, y] = layout.expand(prev);
+    auto [dx, dy] = dir->movement;
+
+    while(true)
+    {
+        result.examined++;
+
+        x += dx;
+        y += dy;
+        auto node_idx = layout.flatten(x, y);
+        auto& node = side_nodes.touch(node_idx);
+
+        distance += Cost::move(dir);
+        if(distance >= node.distance)
+            return;
+
+        node.distance = distance;
+        side_nodes.parent(node_idx) = prev;
+
+        meet(forward, node_idx, distance);
+        if(x == target.x && y == target.y)
+            return;
+
+        Observer::examined(*state, layout.map_index(node_idx), forward);
+
+        if(dir->straight)
+        {
+            if(Util::has_forced_neighbour(grid, x, y, dir))
+            {
+                distance_t f = distance + Cost::heuristic(x, y, target.x, target.y);
+                if(f < best_length && is_promising(forward, x, y, distance))
+                    open_of(forward).push(f, node_idx);
+                return;
+            }
+        }
+        else
+        {
+            // The components are straight, so this goes at most one call deep.
+            for(dir_t component : {dir->components.first, dir->components.second})
+            {
+                if(Util::is_move_valid(grid, x, y, component))
+                    jump(forward, node_idx, component, distance);
+            }
+        }
+
+        if(!Util::is_move_valid(grid, x, y, dir))
+            return;
+        prev = node_idx;
+    }
+}
+
+template<typename Policy>
+bool BidirectionalJumpPointSearch<Policy>::is_promising(bool forward, int x, int y, distance_t distance)
+{
+    Point other_target = forward ? state->begin : state->end;
+    return distance + open_of(!forward).top().first - Cost::heuristic(x, y, other_target.x, other_target.y) < best_length;
+}
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::meet(bool forward, node_index idx, distance_t distance)
+{
+    // Every touched node has a finite distance, so the sum cannot overflow the integer distances.
+    auto other = nodes_of(!forward).lookup(idx);
+    if(other != nullptr && distance + other->distance < best_length)
+    {
+        best_length = distance + other->distance;
+        meeting = idx;
+    }
+}
+
+template<typename Policy>
+void BidirectionalJumpPointSearch<Policy>::build_path()
+{
+    // The backward half becomes a part of the forward nodes, pointing towards the end.
+    // Both halves are shortest paths, so they share no cells other than the meeting cell.
+    for(node_index idx = backward_nodes.parent(meeting); idx != NULL_NODE_IDX; idx = backward_nodes.parent(idx))
+        nodes.touch(idx);
+
+    Util::format_bidirectional_nodes(nodes.parents(), backward_nodes.parents(), meeting, backward_nodes.parent(meeting));
+    Util::build_jump_path<Observer>(*state, layout, nodes.parents(), result);
+}
+
+template<typename Policy>
+size_t BidirectionalJumpPointSearch<Policy>::get_memory_usage()
+{
+    return Base::get_memory_usage()
+        + backward_nodes.get_memory_usage()
+        + backward_open.get_memory_usage();
+}
+
+template class BidirectionalJumpPointSearch<HeadlessPolicy>;
+template class BidirectionalJumpPointSearch<VisualPolicy>;
+template class BidirectionalJumpPointSearch<IntegerCost<HeadlessPolicy>>;
+template class BidirectionalJumpPointSearch<HashedNodes<HeadlessPolicy>>;
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef BIDIRECTIONAL_JPS_HPP
+#define BIDIRECTIONAL_JPS_HPP
+
+#include "algorithms/common.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Bidirectional Jump Point Search: two JumpPointSearch frontiers, one from the beginning towards the end
+ * and one from the end towards the beginning. The moves are symmetric, so the backward search is a plain JPS with the ends swapped.
+ *
+ * Like the jumps of JumpPointSearch, the jumps of both searches record every cell they pass with its distance,
+ * so the searches meet on any cell that lies on the jump segments of both, not only on the jump points.
+ * The shortest path through a meeting cell is its forward distance plus its backward distance.
+ *
+ * The result is optimal: each search on its own is an A* search with a consistent heuristic,
+ * so no path is shorter than the lowest f value in either open list. The search stops as soon as
+ * the shortest path found through the meeting cells is not longer than that. Jump points that cannot lead to
+ * a shorter path, judged by their f value and by the frontier of the other search (see is_promising()),
+ * are neither added to the open lists nor expanded.
+ * The smaller open list is expanded first, so the search grows faster from the end that is less constrained,
+ * e.g. out of a dead end of a maze.
+ *
+ * The path is stitched together at the best meeting cell with Util::format_bidirectional_nodes().
+ */
+template<typename Policy = HeadlessPolicy>
+class BidirectionalJumpPointSearch : public CommonAlgorithm<Policy>
+{
+public:
+    void init(State* state);
+    Algorithm::Result::Type update();
+    size_t get_memory_usage();
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open;
+    using NodeStore = typename Policy::template NodeStore<InternalNode>;
+    using OpenList = typename Policy::template OpenList<distance_t>;
+
+    /**
+     * The nodes and the open list of the search from the end. The search from the beginning uses those of CommonAlgorithm.
+     */
+    NodeStore backward_nodes;
+    OpenList backward_open;
+
+    // The shortest path found so far and the cell where its halves meet
+    distance_t best_length = InternalNode::INFINITE_DISTANCE;
+    node_index meeting = NULL_NODE_IDX;
+
+    NodeStore& nodes_of(bool forward)
+    {
+        return forward ? nodes : backward_nodes;
+    }
+
+    OpenList& open_of(bool forward)
+    {
+        return forward ? open : backward_open;
+    }
+
+    /**
+     * Pops the entries of already examined nodes from the top of the open list.
+     */
+    void skip_examined(bool forward);
+
+    /**
+     * Expands the node at the top of the open list of the search.
+     */
+    void expand(bool forward);
+
+    /**
+     * The "jump" function of JumpPointSearch, with the end of the search selected by forward:
+     * jumps in the direction, records the cells passed and checks each of them for a meeting with the other search.
+     *
+     * @param prev The node from which to jump forward
+     * @param dir The direction of the jump
+     * @param distance The distance from the beginning of the search so far
+     */
+    void jump(bool forward, node_index prev, dir_t dir, distance_t distance);
+
+    /**
+     * Can a path through the cell be shorter than the shortest path so far?
+     * The rest of any such path passes the frontier of the other search, so it is at least as long as
+     * the lowest f value of the other search minus the heuristic from the cell towards the end of the other search
+     * (the "pruning" of NBA*, Pijls and Post, 2009). The open list of the other search must not be empty.
+     *
+     * @param distance The distance of the cell in the search selected by forward
+     */
+    bool is_promising(bool forward, int x, int y, distance_t distance);
+
+    /**
+     * Updates the shortest path if the other search has reached the cell and the path through it is shorter.
+     *
+     * @param distance The distance of the cell in the search selected by forward
+     */
+    void meet(bool forward, node_index idx, distance_t distance);
+
+    /**
+     * Builds the path through the meeting cell into the result.
+     */
+    void build_path();
+};
+
+#endif
\ No newline at end of file
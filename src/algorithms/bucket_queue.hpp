@@ -1,9 +1,15 @@
 #ifndef BUCKET_QUEUE
 #define BUCKET_QUEUE
 
+#include <bit>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cassert>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 /**
  * Simple, crude bucket queue.
@@ -321,4 +327,226 @@ private:
     int realloc_amount = 0;
 };
 
+/**
+ * Bucket queue, version 2.
+ * Has the same interface and usage rules as BucketQueue above, with the following differences:
+ *
+ * -----------------------------
+ * Usage notes:
+ *
+ * The keys can be of any arithmetic type (e.g. the distance_t of a cost model, see cost.hpp).
+ *
+ * The amount of buckets is rounded up to a power of two, at most 64.
+ * Use for_cost() to size the interval and the amount of buckets from a cost model.
+ *
+ * Values below curr_value are put into the lowest bucket instead of asserting.
+ *
+ * Like in BucketQueue, elements within a single bucket are popped in FIFO order.
+ *
+ *
+ * -----------------------------
+ * Implementation notes:
+ *
+ * Each bucket is its own std::vector, so a full bucket only grows itself instead of reallocating and copying the whole ring.
+ * Elements are popped from the read position of the bucket. When a bucket becomes empty, it is rewound to the beginning.
+ * clear() keeps the capacity of the buckets, so after a few queries no memory is allocated at all.
+ * get_realloc_amount() counts the growths of single buckets.
+ *
+ * The nonempty buckets are tracked in a 64-bit occupancy bitmap. Instead of walking the empty buckets one by one,
+ * the next nonempty bucket is found with a single count-trailing-zeros of the bitmap.
+ */
+template<typename T, typename Key = float>
+class BucketQueueV2
+{
+public:
+    struct Element
+    {
+        Key value;
+        T object;
+
+        bool operator==(const Element&) const = default;
+        bool operator!=(const Element&) const = default;
+    };
+
+    BucketQueueV2() {}
+    BucketQueueV2(Key interval, uint32_t bucket_amount)
+    {
+        resize(interval, bucket_amount);
+    }
+
+    /**
+     * Creates a queue sized for a search with the cost model Cost (see cost.hpp).
+     *
+     * With a consistent heuristic, the key of a successor is at most two moves larger than the key of its parent
+     * (the distance increases by one move, the heuristic by at most one move).
+     * The amount of buckets is chosen so that two diagonal moves and some slack always fit into the window.
+     *
+     * @param buckets_per_move The amount of buckets per straight move, i.e. the inverse of the precision of the queue.
+     */
+    template<typename Cost>
+    static BucketQueueV2 for_cost(uint32_t buckets_per_move = 10)
+    {
+        Key interval = Cost::STRAIGHT / (Key)buckets_per_move;
+        if constexpr(std::is_integral_v<Key>)
+            interval = std::max<Key>(interval, 1);
+
+        uint32_t bucket_amount = (uint32_t)std::ceil(2.0 * Cost::DIAGONAL / interval) + 2;
+        return BucketQueueV2(interval, bucket_amount);
+    }
+
+    /**
+     * Sets the interval and the amount of buckets, and empties the queue.
+     */
+    void resize(Key interval, uint32_t bucket_amount)
+    {
+        assert(bucket_amount <= 64);
+        this->interval = interval;
+        this->bucket_amount = std::bit_ceil(std::max(bucket_amount, 1u));
+        this->mask = this->bucket_amount - 1;
+        buckets.resize(this->bucket_amount);
+        clear();
+    }
+
+    /**
+     * Checks if the queue is empty.
+     */
+    bool empty() const
+    {
+        return occupied == 0;
+    }
+
+    Element top() const
+    {
+        assert(!empty());
+        auto& bucket = buckets[read_curr];
+        return bucket.elements[bucket.read];
+    }
+
+    Element pop()
+    {
+        assert(!empty());
+
+        auto& bucket = buckets[read_curr];
+        Element e = bucket.elements[bucket.read++];
+
+        if(bucket.read == bucket.elements.size())
+        {
+            bucket.elements.clear();
+            bucket.read = 0;
+            occupied &= ~(uint64_t{1} << read_curr);
+            if(occupied != 0)
+                read_curr = next_occupied(read_curr);
+        }
+
+        return e;
+    }
+
+    void push(Key value, T object)
+    {
+        if(!has_curr_value)
+        {
+            curr_value = value;
+            has_curr_value = true;
+        }
+
+        uint32_t offset = value > curr_value ? (uint32_t)((value - curr_value) / interval) : 0;
+        assert(offset < bucket_amount);
+
+        uint32_t index = (write_curr + offset) & mask;
+        auto& elements = buckets[index].elements;
+        if(elements.size() == elements.capacity())
+        {
+            realloc_amount++;
+        }
+        elements.push_back({value, object});
+
+        if(empty() || ((index - write_curr) & mask) < ((read_curr - write_curr) & mask))
+        {
+            // The new element is in the lowest bucket
+            read_curr = index;
+        }
+        occupied |= uint64_t{1} << index;
+    }
+
+    void update_write()
+    {
+        if(empty())
+        {
+            has_curr_value = false;
+        }
+        else
+        {
+            curr_value += interval * (Key)((read_curr - write_curr) & mask);
+        }
+        write_curr = read_curr;
+    }
+
+    void clear()
+    {
+        for(auto& bucket : buckets)
+        {
+            bucket.elements.clear();
+            bucket.read = 0;
+        }
+        occupied = 0;
+        has_curr_value = false;
+        read_curr = 0;
+        write_curr = 0;
+    }
+
+    int get_realloc_amount()
+    {
+        return realloc_amount;
+    }
+
+    Key get_curr_value() { return curr_value; }
+
+    Key get_interval() { return interval; }
+
+    uint32_t get_bucket_amount() { return bucket_amount; }
+
+    /**
+     * Gets the amount of memory used by the buckets in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        size_t bytes = 0;
+        for(auto& bucket : buckets)
+            bytes += bucket.elements.capacity() * sizeof(Element);
+        return bytes;
+    }
+
+private:
+    struct Bucket
+    {
+        std::vector<Element> elements;
+        uint32_t read = 0;
+    };
+
+    /**
+     * Finds the first nonempty bucket at or after the index, wrapping around the ring.
+     * The queue must not be empty.
+     */
+    inline uint32_t next_occupied(uint32_t index) const
+    {
+        uint64_t ahead = occupied >> index;
+        if(ahead != 0)
+            return index + std::countr_zero(ahead);
+        return std::countr_zero(occupied);
+    }
+
+    Key curr_value = 0;
+    bool has_curr_value = false;
+    uint32_t read_curr = 0;
+    uint32_t write_curr = 0;
+
+    Key interval = 1;
+    uint32_t bucket_amount = 0;
+    uint32_t mask = 0;
+
+    uint64_t occupied = 0;
+    std::vector<Bucket> buckets;
+    int realloc_amount = 0;
+};
+
 #endif
\ No newline at end of file
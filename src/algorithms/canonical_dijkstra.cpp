@@ -0,0 +1,163 @@
+#include "algorithms/canonical_dijkstra.hpp"
+#include "state.hpp"
+
+#include <algorithm>
+#include <limits>
+
+template<typename Policy>
+void CanonicalDijkstra<Policy>::init(State* s)
+{
+    Base::init(s);
+
+    // Ordered by the distance alone: the open list is started again without the heuristic of the beginning.
+    auto start_index = layout.flatten(s->begin.x, s->begin.y);
+    open.init(layout.size());
+    open.push(0, start_index);
+}
+
+template<typename Policy>
+Algorithm::Result::Type CanonicalDijkstra<Policy>::update()
+{
+    // Skip the stale entries of already examined nodes, like in JumpPointSearch.
+    node_index node_idx;
+    do
+    {
+        if(open.empty())
+        {
+            if(!get_path(state->end, result.path))
+            {
+                result.type = Result::Type::FAILURE;
+                return Result::Type::FAILURE;
+            }
+
+            for(auto point : result.path)
+                Observer::path(*state, layout.map_index(layout.flatten(point.x, point.y)));
+            result.length = get_distance(state->end.x, state->end.y);
+            result.type = Result::Type::SUCCESS;
+            return Result::Type::SUCCESS;
+        }
+
+        node_idx = open.top().second;
+        open.pop();
+    }
+    while(nodes[node_idx].status() == InternalNode::Status::EXAMINED);
+
+    auto [x, y] = layout.expand(node_idx);
+    auto& node = nodes[node_idx];
+
+    node.set_status(InternalNode::Status::EXAMINED);
+    result.expanded++;
+    // Copied, as jumping may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
+
+    Observer::expanded(*state, layout.map_index(node_idx));
+
+    const SuccessorList& successors = successor_lists[canonical_directions(node_idx, x, y)];
+    for(int i = 0; i < successors.amount; ++i)
+        jump(node_idx, directions[successors.directions[i]], node_distance);
+
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void CanonicalDijkstra<Policy>::jump(node_index prev, dir_t dir, distance_t distance)
+{
+    auto [x, y] = layout.expand(prev);
+    auto [dx, dy] = dir->movement;
+
+    while(true)
+    {
+        result.examined++;
+
+        x += dx;
+        y += dy;
+        auto node_idx = layout.flatten(x, y);
+        auto& node = nodes.touch(node_idx);
+
+        distance += Cost::move(dir);
+        if(distance >= node.distance)
+            return;
+
+        node.distance = distance;
+        nodes.parent(node_idx) = prev;
+
+        Observer::examined(*state, layout.map_index(node_idx));
+
+        if(dir->straight)
+        {
+            if(Util::has_forced_neighbour(grid, x, y, dir))
+            {
+                open.push(distance, node_idx);
+                return;
+            }
+        }
+        else
+        {
+            // The components are straight, so this goes at most one call deep.
+            for(dir_t component : {dir->components.first, dir->components.second})
+            {
+                if(Util::is_move_valid(grid, x, y, component))
+                    jump(node_idx, component, distance);
+            }
+        }
+
+        if(!Util::is_move_valid(grid, x, y, dir))
+            return;
+        prev = node_idx;
+    }
+}
+
+template<typename Policy>
+void CanonicalDijkstra<Policy>::compute(State* s)
+{
+    init(s);
+    while(update() == Result::Type::EXECUTING) {}
+}
+
+template<typename Policy>
+float CanonicalDijkstra<Policy>::get_distance(int x, int y)
+{
+    auto node = nodes.lookup(layout.flatten(x, y));
+    if(node == nullptr)
+        return std::numeric_limits<float>::infinity();
+    return Cost::to_float(node->distance);
+}
+
+template<typename Policy>
+dir_t CanonicalDijkstra<Policy>::get_parent_direction(int x, int y)
+{
+    auto node_idx = layout.flatten(x, y);
+    if(nodes.lookup(node_idx) == nullptr || nodes.parent(node_idx) == NULL_NODE_IDX)
+        return nullptr;
+
+    // The jumps record every cell, so the parent is always a neighbour.
+    auto [parent_x, parent_y] = layout.expand(nodes.parent(node_idx));
+    std::pair<int, int> movement{x - parent_x, y - parent_y};
+    for(int i = 0; i < 8; ++i)
+    {
+        if(directions[i]->movement == movement)
+            return directions[i];
+    }
+    return nullptr;
+}
+
+template<typename Policy>
+bool CanonicalDijkstra<Policy>::get_path(Point target, std::vector<Point>& path)
+{
+    path.clear();
+    auto node_idx = layout.flatten(target.x, target.y);
+    if(nodes.lookup(node_idx) == nullptr)
+        return false;
+
+    for(; nodes.parent(node_idx) != NULL_NODE_IDX; node_idx = nodes.parent(node_idx))
+    {
+        auto [x, y] = layout.expand(node_idx);
+        path.push_back({x, y});
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+template class CanonicalDijkstra<HeadlessPolicy>;
+template class CanonicalDijkstra<VisualPolicy>;
+template class CanonicalDijkstra<IntegerCost<HeadlessPolicy>>;
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef CANONICAL_DIJKSTRA_HPP
+#define CANONICAL_DIJKSTRA_HPP
+
+#include <vector>
+
+#include "algorithms/common.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Canonical Dijkstra, as described in Sturtevant and Rabin, 2016 ("Canonical Orderings on Grids"):
+ * a Dijkstra search from the beginning over the whole map, which computes the distance of every reachable cell.
+ *
+ * The search is ordered like JumpPointSearch, without a heuristic and without stopping at the end:
+ * each expanded jump point only jumps in its canonical directions (see Util::canonical_successors()),
+ * the jumps record every cell they pass with its distance and parent, and a straight jump stops at a cell with
+ * a forced neighbour (see forced[][]), which becomes a jump point. Every cell is thus reached along a canonical path,
+ * but only the jump points go through the open list.
+ *
+ * When the search is complete, the result is the path to the end (or FAILURE if the end cannot be reached),
+ * and the fields of the whole map can be read with get_distance(), get_parent_direction() and get_path().
+ * The fields are kept in the node store of the algorithm, so they are valid until the next init().
+ * The node records are reused from run to run like in the other algorithms (see ScratchArena),
+ * so computing the fields from many sources does not allocate anything after the first run.
+ */
+template<typename Policy = HeadlessPolicy>
+class CanonicalDijkstra : public CommonAlgorithm<Policy>
+{
+public:
+    void init(State* state);
+    Algorithm::Result::Type update();
+
+    /**
+     * Computes the fields of the state from its beginning in one go, i.e. init() and update() until the search is complete.
+     */
+    void compute(State* state);
+
+    /**
+     * Gets the distance from the beginning to the cell (x, y), or infinity if the cell cannot be reached.
+     */
+    float get_distance(int x, int y);
+
+    /**
+     * Gets the direction of the last move of a shortest path from the beginning to the cell (x, y),
+     * or nullptr for the beginning and the cells that cannot be reached.
+     */
+    dir_t get_parent_direction(int x, int y);
+
+    /**
+     * Gets a shortest path from the beginning to the target, like Algorithm::Result::path:
+     * without the beginning, with the target.
+     *
+     * @returns Whether the target can be reached.
+     */
+    bool get_path(Point target, std::vector<Point>& path);
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open, Base::canonical_directions;
+
+    /**
+     * The "jump" function of JumpPointSearch without an end: jumps in the direction and records the cells passed,
+     * stopping at walls, at cells already reached with a lower distance and at cells with forced neighbours.
+     *
+     * @param prev The node from which to jump forward
+     * @param dir The direction of the jump
+     * @param distance The distance of prev
+     */
+    void jump(node_index prev, dir_t dir, distance_t distance);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "algorithms/ch_search.hpp"
+#include "algorithms/cost.hpp"
+
+#include <algorithm>
+
+template<typename Policy>
+void ContractionHierarchySearch<Policy>::init(State* s)
+{
+    state = s;
+    grid.update(*s);
+    hierarchy.update(*s, grid);
+
+    result = Algorithm::Result{};
+    best_distance = INFINITE_DISTANCE;
+    meeting_node = ContractionHierarchy::NO_NODE;
+
+    size_t node_count = hierarchy.get_node_count();
+    forward_nodes.begin_run(node_count, {s, s->revision});
+    backward_nodes.begin_run(node_count, {s, s->revision});
+    forward_open.init(node_count);
+    backward_open.init(node_count);
+
+    // With an empty open list the search fails on the first update.
+    uint32_t begin = hierarchy.get_node(s->begin.x, s->begin.y);
+    uint32_t end = hierarchy.get_node(s->end.x, s->end.y);
+    if(begin == ContractionHierarchy::NO_NODE || end == ContractionHierarchy::NO_NODE)
+        return;
+
+    forward_nodes.touch(begin).distance = 0;
+    forward_nodes.parent(begin) = NULL_NODE_IDX;
+    forward_open.push(0, begin);
+    backward_nodes.touch(end).distance = 0;
+    backward_nodes.parent(end) = NULL_NODE_IDX;
+    backward_open.push(0, end);
+}
+
+template<typename Policy>
+Algorithm::Result::Type ContractionHierarchySearch<Policy>::update()
+{
+    distance_t forward_key = forward_open.empty() ? INFINITE_DISTANCE : forward_open.top().first;
+    distance_t backward_key = backward_open.empty() ? INFINITE_DISTANCE : backward_open.top().first;
+
+    // Neither side can reach a node with a shorter path through it anymore.
+    if(std::min(forward_key, backward_key) >= best_distance)
+    {
+        if(meeting_node == ContractionHierarchy::NO_NODE)
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        build_path();
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    settle(forward_key <= backward_key);
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void ContractionHierarchySearch<Policy>::settle(bool forward)
+{
+    auto& nodes = forward ? forward_nodes : backward_nodes;
+    auto& other_nodes = forward ? backward_nodes : forward_nodes;
+    auto& open = forward ? forward_open : backward_open;
+
+    uint32_t node = open.top().second;
+    open.pop();
+
+    // Skip the stale entries of already settled nodes, like in AStar.
+    auto& record = nodes[node];
+    if(record.status() == CHNode::Status::EXAMINED)
+        return;
+    record.set_status(CHNode::Status::EXAMINED);
+    // Copied, as touching the neighbours may move the record (see node_store.hpp)
+    distance_t distance = record.distance;
+
+    result.expanded++;
+    Point cell = hierarchy.get_cell(node);
+    Observer::expanded(*state, cell.y * state->width + cell.x, forward);
+
+    CHNode* other = other_nodes.lookup(node);
+    if(other != nullptr && other->distance != INFINITE_DISTANCE && distance + other->distance < best_distance)
+    {
+        best_distance = distance + other->distance;
+        meeting_node = node;
+    }
+
+    // Stall-on-demand: the graph is undirected, so the upward edges of the node also lead into it from above.
+    // If one of them gives a shorter path to the node, its distance is not the shortest one and it does not need to be expanded.
+    auto [first, last] = hierarchy.get_upward_edges(node);
+    for(auto edge = first; edge != last; ++edge)
+    {
+        CHNode* higher = nodes.lookup(edge->to);
+        if(higher != nullptr && higher->distance != INFINITE_DISTANCE && higher->distance + edge->cost < distance)
+            return;
+    }
+
+    for(auto edge = first; edge != last; ++edge)
+    {
+        result.examined++;
+        distance_t new_distance = distance + edge->cost;
+        auto& neighbour = nodes.touch(edge->to);
+        if(new_distance < neighbour.distance)
+        {
+            neighbour.distance = new_distance;
+            nodes.parent(edge->to) = node;
+            open.push(new_distance, edge->to);
+
+            Point neighbour_cell = hierarchy.get_cell(edge->to);
+            Observer::examined(*state, neighbour_cell.y * state->width + neighbour_cell.x, forward);
+        }
+    }
+}
+
+template<typename Policy>
+void ContractionHierarchySearch<Policy>::build_path()
+{
+    // The upward path from the beginning to the meeting node, then the downward path to the end
+    chain.clear();
+    for(node_index node = meeting_node; node != NULL_NODE_IDX; node = forward_nodes.parent(node))
+        chain.push_back(node);
+    std::reverse(chain.begin(), chain.end());
+    for(node_index node = backward_nodes.parent(meeting_node); node != NULL_NODE_IDX; node = backward_nodes.parent(node))
+        chain.push_back(node);
+
+    hierarchy.unpack(chain, result.path);
+
+    for(auto point : result.path)
+        Observer::path(*state, point.y * state->width + point.x);
+
+    result.length = OctileIntegerCost<>::to_float(best_distance);
+}
+
+template<typename Policy>
+size_t ContractionHierarchySearch<Policy>::get_memory_usage()
+{
+    return forward_nodes.get_memory_usage()
+        + backward_nodes.get_memory_usage()
+        + forward_open.get_memory_usage()
+        + backward_open.get_memory_usage()
+        + grid.get_memory_usage()
+        + get_preprocessed_memory_usage();
+}
+
+template<typename Policy>
+double ContractionHierarchySearch<Policy>::get_preprocessing_time()
+{
+    return hierarchy.get_build_time();
+}
+
+template<typename Policy>
+size_t ContractionHierarchySearch<Policy>::get_preprocessed_memory_usage()
+{
+    return hierarchy.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> ContractionHierarchySearch<Policy>::get_preprocessed_statistics()
+{
+    return {
+        {"nodes", hierarchy.get_node_count()},
+        {"edges", hierarchy.get_edge_count()},
+        {"shortcuts", hierarchy.get_shortcut_count()}
+    };
+}
+
+template<typename Policy>
+bool ContractionHierarchySearch<Policy>::save_preprocessed(std::ostream& out)
+{
+    return hierarchy.save(out);
+}
+
+template<typename Policy>
+bool ContractionHierarchySearch<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return hierarchy.load(s, in);
+}
+
+template class ContractionHierarchySearch<HeadlessPolicy>;
+template class ContractionHierarchySearch<VisualPolicy>;
\ No newline at end of file
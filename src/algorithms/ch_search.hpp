@@ -0,0 +1,84 @@
+#ifndef CH_SEARCH_HPP
+#define CH_SEARCH_HPP
+
+#include <vector>
+
+#include "algorithms/algorithm.hpp"
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Point-to-point queries over a contraction hierarchy of the map (see contraction_hierarchy.hpp).
+ *
+ * The query is a bidirectional Dijkstra search that only follows the upward edges, i.e. edges to nodes of higher rank,
+ * from both the beginning and the end. One node is settled per update(), from the side with the lower distance.
+ * Whenever a node is settled by one side and reached by the other, the path through it is a candidate.
+ * The search stops once neither side can find a shorter one, and the path is unpacked from the shortcuts.
+ *
+ * The searches only see a small part of the hierarchy near the top, regardless of the distance,
+ * but the hierarchy has to be built for the map first, which takes seconds on large maps. The results are optimal.
+ */
+template<typename Policy = HeadlessPolicy>
+class ContractionHierarchySearch : public Algorithm
+{
+public:
+    void init(State* state);
+    Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+
+    const ContractionHierarchy& get_hierarchy() const
+    {
+        return hierarchy;
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+
+    using distance_t = ContractionHierarchy::distance_t;
+
+    struct CHNode : SearchNode<distance_t, typename Policy::Stamp>
+    {
+        enum Status : uint8_t
+        {
+            UNEXAMINED,
+            EXAMINED
+        };
+    };
+
+    static constexpr distance_t INFINITE_DISTANCE = CHNode::INFINITE_DISTANCE;
+
+    Grid grid;
+    ContractionHierarchy hierarchy;
+
+    // The searches from the beginning and from the end, by node (i.e. rank)
+    typename Policy::template NodeStore<CHNode> forward_nodes;
+    typename Policy::template NodeStore<CHNode> backward_nodes;
+    typename Policy::template OpenList<distance_t> forward_open;
+    typename Policy::template OpenList<distance_t> backward_open;
+
+    distance_t best_distance = INFINITE_DISTANCE;
+    uint32_t meeting_node = ContractionHierarchy::NO_NODE;
+
+    // The nodes of the path before unpacking
+    std::vector<uint32_t> chain;
+
+    /**
+     * Settles the next node of the search in the direction.
+     */
+    void settle(bool forward);
+
+    /**
+     * Unpacks the path through the meeting node into the result.
+     */
+    void build_path();
+};
+
+#endif
\ No newline at end of file
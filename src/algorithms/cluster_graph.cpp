@@ -0,0 +1,258 @@
+#include "algorithms/cluster_graph.hpp"
+#include "algorithms/cost.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/**
+ * The header of the saved graph after the common header (see PreprocessedKey).
+ */
+struct ClusterGraphHeader
+{
+    int32_t cluster_size;
+    uint32_t node_count;
+    uint32_t edge_count;
+};
+
+static constexpr char CLUSTER_GRAPH_MAGIC[4] = {'H', 'P', 'A', '*'};
+static constexpr uint32_t CLUSTER_GRAPH_VERSION = 3;
+
+void ClusterGraph::ClusterSearch::run(const ClusterGraph& graph, const Grid& grid, int x, int y)
+{
+    using Cost = OctileIntegerCost<>;
+
+    bounds = graph.get_bounds(graph.get_cluster(x, y));
+    int width = bounds.right - bounds.left;
+    distances.assign(width * (bounds.bottom - bounds.top), UNREACHABLE);
+
+    node_index source_idx = (y - bounds.top) * width + x - bounds.left;
+    distances[source_idx] = 0;
+    open.init(0);
+    open.push(0, source_idx);
+
+    while(!open.empty())
+    {
+        auto [distance, idx] = open.top();
+        open.pop();
+        if(distance > distances[idx])
+            continue;
+
+        int cell_x = bounds.left + idx % width;
+        int cell_y = bounds.top + idx / width;
+
+        const SuccessorList& successors = successor_lists[grid.successors(cell_x, cell_y)];
+        for(int i = 0; i < successors.amount; ++i)
+        {
+            dir_t dir = directions[successors.directions[i]];
+            auto [dx, dy] = dir->movement;
+            if(!bounds.contains(cell_x + dx, cell_y + dy))
+                continue;
+
+            node_index neighbour_idx = idx + dy * width + dx;
+            distance_t new_distance = distance + Cost::move(dir);
+            if(new_distance < distances[neighbour_idx])
+            {
+                distances[neighbour_idx] = new_distance;
+                open.push(new_distance, neighbour_idx);
+            }
+        }
+    }
+}
+
+bool ClusterGraph::update(const State& s, const Grid& grid, int size)
+{
+    build_time = 0;
+    if(key.is_current(s, grid) && cluster_size == size)
+        return false;
+
+    build(s, grid, size);
+    return true;
+}
+
+void ClusterGraph::add_entrances(const Grid& grid, int x, int y, int dx, int dy, int along_x, int along_y, int length,
+                                 std::vector<std::pair<uint32_t, uint32_t>>& crossings) const
+{
+    auto add_crossing = [&](int i)
+    {
+        int cell_x = x + along_x * i;
+        int cell_y = y + along_y * i;
+        crossings.push_back({cell_y * key.width + cell_x, (cell_y + dy) * key.width + cell_x + dx});
+    };
+
+    int run_start = -1;
+    for(int i = 0; i <= length; ++i)
+    {
+        int cell_x = x + along_x * i;
+        int cell_y = y + along_y * i;
+        bool open = i < length && grid.is_empty(cell_x, cell_y) && grid.is_empty(cell_x + dx, cell_y + dy);
+
+        if(open && run_start < 0)
+        {
+            run_start = i;
+        }
+        else if(!open && run_start >= 0)
+        {
+            int run_length = i - run_start;
+            if(run_length < MAX_ENTRANCE_WIDTH)
+            {
+                add_crossing(run_start + run_length / 2);
+            }
+            else
+            {
+                add_crossing(run_start);
+                add_crossing(i - 1);
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void ClusterGraph::build(const State& s, const Grid& grid, int size)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    cluster_size = size;
+    key.set(s, grid);
+    clusters_x = (key.width + cluster_size - 1) / cluster_size;
+    clusters_y = (key.height + cluster_size - 1) / cluster_size;
+    int cluster_count = clusters_x * clusters_y;
+
+    // The crossings of the borders on the right and below each cluster
+    std::vector<std::pair<uint32_t, uint32_t>> crossings;
+    for(int cluster = 0; cluster < cluster_count; ++cluster)
+    {
+        Bounds bounds = get_bounds(cluster);
+        if(bounds.right < key.width)
+            add_entrances(grid, bounds.right - 1, bounds.top, 1, 0, 0, 1, bounds.bottom - bounds.top, crossings);
+        if(bounds.bottom < key.height)
+            add_entrances(grid, bounds.left, bounds.bottom - 1, 0, 1, 1, 0, bounds.right - bounds.left, crossings);
+    }
+
+    // The nodes, ordered by their clusters
+    auto by_cluster = [&](uint32_t a, uint32_t b)
+    {
+        int cluster_a = get_cluster(a % key.width, a / key.width);
+        int cluster_b = get_cluster(b % key.width, b / key.width);
+        return cluster_a != cluster_b ? cluster_a < cluster_b : a < b;
+    };
+    node_cells.clear();
+    for(auto [a, b] : crossings)
+    {
+        node_cells.push_back(a);
+        node_cells.push_back(b);
+    }
+    std::sort(node_cells.begin(), node_cells.end(), by_cluster);
+    node_cells.erase(std::unique(node_cells.begin(), node_cells.end()), node_cells.end());
+
+    auto node_of = [&](uint32_t cell)
+    {
+        return uint32_t(std::lower_bound(node_cells.begin(), node_cells.end(), cell, by_cluster) - node_cells.begin());
+    };
+
+    cluster_offsets.assign(cluster_count + 1, 0);
+    for(auto cell : node_cells)
+        cluster_offsets[get_cluster(cell % key.width, cell / key.width) + 1]++;
+    for(int cluster = 0; cluster < cluster_count; ++cluster)
+        cluster_offsets[cluster + 1] += cluster_offsets[cluster];
+
+    std::vector<std::vector<Edge>> adjacency(node_cells.size());
+    for(auto [a, b] : crossings)
+    {
+        uint32_t node_a = node_of(a);
+        uint32_t node_b = node_of(b);
+        adjacency[node_a].push_back({node_b, OctileIntegerCost<>::STRAIGHT});
+        adjacency[node_b].push_back({node_a, OctileIntegerCost<>::STRAIGHT});
+    }
+
+    // Each thread takes the next cluster. Every cluster only writes the edges of its own nodes, so no locking is needed.
+    std::atomic<int> next_cluster = 0;
+    auto work = [&]()
+    {
+        ClusterSearch search;
+        for(int cluster = next_cluster++; cluster < cluster_count; cluster = next_cluster++)
+        {
+            auto [first, last] = get_cluster_nodes(cluster);
+            for(uint32_t from = first; from < last; ++from)
+            {
+                Point cell = get_cell(from);
+                search.run(*this, grid, cell.x, cell.y);
+                for(uint32_t to = first; to < last; ++to)
+                {
+                    Point other = get_cell(to);
+                    distance_t distance = search.get_distance(other.x, other.y);
+                    if(to != from && distance != UNREACHABLE)
+                        adjacency[from].push_back({to, distance});
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned int i = 1; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        threads.emplace_back(work);
+    work();
+    for(auto& thread : threads)
+        thread.join();
+
+    edge_offsets.assign(node_cells.size() + 1, 0);
+    edges.clear();
+    for(size_t node = 0; node < node_cells.size(); ++node)
+    {
+        edges.insert(edges.end(), adjacency[node].begin(), adjacency[node].end());
+        edge_offsets[node + 1] = edges.size();
+    }
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool ClusterGraph::save(std::ostream& out) const
+{
+    if(!key.write(out, CLUSTER_GRAPH_MAGIC, CLUSTER_GRAPH_VERSION))
+        return false;
+
+    ClusterGraphHeader header{cluster_size, uint32_t(node_cells.size()), uint32_t(edges.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(node_cells.data()), node_cells.size() * sizeof(node_cells[0]));
+    out.write(reinterpret_cast<const char*>(cluster_offsets.data()), cluster_offsets.size() * sizeof(cluster_offsets[0]));
+    out.write(reinterpret_cast<const char*>(edge_offsets.data()), edge_offsets.size() * sizeof(edge_offsets[0]));
+    out.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(edges[0]));
+    return out.good();
+}
+
+bool ClusterGraph::load(const State& s, int size, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, CLUSTER_GRAPH_MAGIC, CLUSTER_GRAPH_VERSION))
+        return false;
+
+    ClusterGraphHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good() || header.cluster_size != size)
+        return false;
+
+    int loaded_clusters_x = (s.width + size - 1) / size;
+    int loaded_clusters_y = (s.height + size - 1) / size;
+
+    std::vector<uint32_t> loaded_cells(header.node_count);
+    std::vector<uint32_t> loaded_cluster_offsets(loaded_clusters_x * loaded_clusters_y + 1);
+    std::vector<uint32_t> loaded_edge_offsets(header.node_count + 1);
+    std::vector<Edge> loaded_edges(header.edge_count);
+    in.read(reinterpret_cast<char*>(loaded_cells.data()), loaded_cells.size() * sizeof(loaded_cells[0]));
+    in.read(reinterpret_cast<char*>(loaded_cluster_offsets.data()), loaded_cluster_offsets.size() * sizeof(loaded_cluster_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_edge_offsets.data()), loaded_edge_offsets.size() * sizeof(loaded_edge_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_edges.data()), loaded_edges.size() * sizeof(loaded_edges[0]));
+    if(!in.good())
+        return false;
+
+    node_cells = std::move(loaded_cells);
+    cluster_offsets = std::move(loaded_cluster_offsets);
+    edge_offsets = std::move(loaded_edge_offsets);
+    edges = std::move(loaded_edges);
+    cluster_size = size;
+    clusters_x = loaded_clusters_x;
+    clusters_y = loaded_clusters_y;
+    key = loaded_key;
+    build_time = 0;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#ifndef CLUSTER_GRAPH_HPP
+#define CLUSTER_GRAPH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+#include "algorithms/radix_heap.hpp"
+#include "algorithms/util.hpp"
+
+/**
+ * The abstract graph of HPA*, as described in Botea et al., 2004 ("Near Optimal Hierarchical Path-Finding").
+ *
+ * The map is divided into square clusters of cluster_size x cluster_size cells (smaller at the right and bottom edges).
+ * Along the border between two neighbouring clusters, every maximal run of cells that are empty on both sides is an entrance.
+ * An entrance shorter than MAX_ENTRANCE_WIDTH is crossed in its middle, a longer one at both of its ends.
+ * The two cells of each crossing are the nodes of the graph, connected by a straight move across the border.
+ * Within each cluster, every pair of its nodes is connected by an edge with the length of the shortest path
+ * between them that stays inside the cluster, if there is one.
+ *
+ * The nodes are numbered cluster by cluster, so the nodes of a cluster are a range of node ids (see get_cluster_nodes()).
+ * The lengths are in the units and the type of OctileIntegerCost, so that they are exact.
+ *
+ * The graph is built with one Dijkstra search per node, limited to the cluster of the node,
+ * i.e. in O(n * k) time for a map of n cells and k nodes per cluster. The clusters are distributed over all hardware threads.
+ */
+class ClusterGraph
+{
+public:
+    /**
+     * The entrances at least this long are crossed at both ends instead of the middle.
+     */
+    static constexpr int MAX_ENTRANCE_WIDTH = 6;
+
+    using distance_t = OctileIntegerCost<>::distance_t;
+
+    static constexpr distance_t UNREACHABLE = std::numeric_limits<distance_t>::max();
+
+    struct Edge
+    {
+        uint32_t to;
+        distance_t cost;
+    };
+
+    /**
+     * The bounds of a cluster: the cells left <= x < right, top <= y < bottom.
+     */
+    struct Bounds
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+
+        bool contains(int x, int y) const
+        {
+            return x >= left && x < right && y >= top && y < bottom;
+        }
+    };
+
+    /**
+     * A Dijkstra search from a cell over the cells of its cluster, with its own buffers.
+     * Used for connecting the nodes of a cluster, and the beginning and the end of a query to the graph.
+     */
+    class ClusterSearch
+    {
+    public:
+        /**
+         * Computes the distances from (x, y) to every cell of its cluster, moving only inside the cluster.
+         */
+        void run(const ClusterGraph& graph, const Grid& grid, int x, int y);
+
+        /**
+         * Gets the distance from the source of the last run to (x, y), which must be inside the same cluster, or UNREACHABLE.
+         */
+        distance_t get_distance(int x, int y) const
+        {
+            return distances[(y - bounds.top) * (bounds.right - bounds.left) + x - bounds.left];
+        }
+
+    private:
+        Bounds bounds;
+        std::vector<distance_t> distances;
+        RadixHeap<distance_t> open;
+    };
+
+    /**
+     * Builds the graph of the state, unless it is already up to date (the same state, revision, size and cluster size).
+     * The grid must be up to date.
+     *
+     * @returns Whether the graph was built.
+     */
+    bool update(const State& state, const Grid& grid, int cluster_size);
+
+    /**
+     * Builds the graph of the state. The grid must be up to date.
+     */
+    void build(const State& state, const Grid& grid, int cluster_size);
+
+    int get_cluster_size() const
+    {
+        return cluster_size;
+    }
+
+    /**
+     * Gets the cluster of the cell (x, y).
+     */
+    int get_cluster(int x, int y) const
+    {
+        return (y / cluster_size) * clusters_x + x / cluster_size;
+    }
+
+    Bounds get_bounds(int cluster) const
+    {
+        int left = (cluster % clusters_x) * cluster_size;
+        int top = (cluster / clusters_x) * cluster_size;
+        return {left, top, std::min(left + cluster_size, key.width), std::min(top + cluster_size, key.height)};
+    }
+
+    /**
+     * Gets the range [first, last) of the ids of the nodes in the cluster.
+     */
+    std::pair<uint32_t, uint32_t> get_cluster_nodes(int cluster) const
+    {
+        return {cluster_offsets[cluster], cluster_offsets[cluster + 1]};
+    }
+
+    size_t get_node_count() const
+    {
+        return node_cells.size();
+    }
+
+    /**
+     * Gets the cell of the node.
+     */
+    Point get_cell(uint32_t node) const
+    {
+        return {int(node_cells[node] % key.width), int(node_cells[node] / key.width)};
+    }
+
+    /**
+     * Gets the range [first, last) of the edges from the node.
+     */
+    std::pair<const Edge*, const Edge*> get_edges(uint32_t node) const
+    {
+        return {edges.data() + edge_offsets[node], edges.data() + edge_offsets[node + 1]};
+    }
+
+    size_t get_edge_count() const
+    {
+        return edges.size();
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the graph during the last update(), or 0 if it was up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the graph in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return node_cells.capacity() * sizeof(node_cells[0])
+            + cluster_offsets.capacity() * sizeof(cluster_offsets[0])
+            + edge_offsets.capacity() * sizeof(edge_offsets[0])
+            + edges.capacity() * sizeof(edges[0]);
+    }
+
+    /**
+     * Writes the graph into the stream.
+     *
+     * @returns Whether the graph was written. False if it has not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads a graph written by save(), so that the next update() with the state and cluster size does not build it again.
+     *
+     * @returns Whether the graph was loaded. False if the data is invalid or was made for another map or cluster size.
+     */
+    bool load(const State& state, int cluster_size, std::istream& in);
+
+private:
+    int cluster_size = 0;
+    int clusters_x = 0;
+    int clusters_y = 0;
+
+    // The map index (y * width + x) of the cell of each node
+    std::vector<uint32_t> node_cells;
+
+    // The nodes of cluster c are [cluster_offsets[c], cluster_offsets[c + 1])
+    std::vector<uint32_t> cluster_offsets;
+
+    // The edges from node i are edges[edge_offsets[i]] to edges[edge_offsets[i + 1] - 1]
+    std::vector<uint32_t> edge_offsets;
+    std::vector<Edge> edges;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+
+    /**
+     * Adds the crossings of the border between the cells (x, y) and (x + dx, y + dy), for length cells along (along_x, along_y).
+     */
+    void add_entrances(const Grid& grid, int x, int y, int dx, int dy, int along_x, int along_y, int length,
+                       std::vector<std::pair<uint32_t, uint32_t>>& crossings) const;
+};
+
+#endif
\ No newline at end of file
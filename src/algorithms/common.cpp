@@ -1,23 +1,123 @@
 #include "algorithms/common.hpp"
 #include <cstring>
 
-void CommonAlgorithm::init(State* s)
+template<typename Policy>
+void CommonAlgorithm<Policy>::init(State* s)
 {
-    curr_run_id++;
     state = s;
+    grid.update(*s, Policy::precompute_successors);
+    if constexpr(Policy::goal_bounding)
+        bounds.update(*s, grid);
+    if constexpr(Policy::landmarks > 0)
+        landmarks.update(*s, grid, Policy::landmarks);
 
     result = Algorithm::Result{};
-    open = std::priority_queue<queue_pair, std::vector<queue_pair>, std::greater<queue_pair>>();
 
     // Initialize the nodes vector.
-    if(nodes.capacity() != s->map.size())
-    {
-        nodes = std::vector<InternalNode>(s->map.size());
-    }
+    layout.init(s->width, s->height);
+    nodes.begin_run(layout.size(), {s, s->revision});
+    open.init(layout.size());
     
     // Set the correct information of the starting node and add it to the open queue.
-    auto start_index = Util::flatten(s->width, s->begin.x, s->begin.y);
-    Util::lazy_initialize(curr_run_id, nodes[start_index]);
-    nodes[start_index].distance = 0.0f;
-    open.emplace(Util::diagonal_distance(state->begin.x, state->begin.y, state->end.x, state->end.y), start_index);
-}
\ No newline at end of file
+    auto start_index = layout.flatten(s->begin.x, s->begin.y);
+    nodes.touch(start_index).distance = 0;
+    nodes.parent(start_index) = NULL_NODE_IDX;
+    open.push(heuristic(state->begin.x, state->begin.y, state->end.x, state->end.y), start_index);
+}
+
+template<typename Policy>
+size_t CommonAlgorithm<Policy>::get_memory_usage()
+{
+    return nodes.get_memory_usage()
+        + open.get_memory_usage()
+        + grid.get_memory_usage()
+        + bounds.get_memory_usage()
+        + landmarks.get_memory_usage();
+}
+
+template<typename Policy>
+uint8_t CommonAlgorithm<Policy>::canonical_directions(node_index node_idx, int x, int y)
+{
+    node_index parent_idx = nodes.parent(node_idx);
+    if(parent_idx == NULL_NODE_IDX)
+        return Util::canonical_successors(grid, x, y, 0, 0);
+
+    auto [parent_x, parent_y] = layout.expand(parent_idx);
+    return Util::canonical_successors(grid, x, y, (x > parent_x) - (x < parent_x), (y > parent_y) - (y < parent_y));
+}
+
+template<typename Policy>
+double CommonAlgorithm<Policy>::get_preprocessing_time()
+{
+    return bounds.get_build_time() + landmarks.get_build_time();
+}
+
+template<typename Policy>
+size_t CommonAlgorithm<Policy>::get_preprocessed_memory_usage()
+{
+    return bounds.get_memory_usage() + landmarks.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> CommonAlgorithm<Policy>::get_preprocessed_statistics()
+{
+    if constexpr(Policy::landmarks > 0)
+    {
+        return {
+            {"landmarks", landmarks.get_count()},
+            {"bytes_per_landmark", landmarks.get_memory_per_landmark()}
+        };
+    }
+    else
+    {
+        return {};
+    }
+}
+
+template<typename Policy>
+bool CommonAlgorithm<Policy>::save_preprocessed(std::ostream& out)
+{
+    // With both, the goal bounds come first.
+    if constexpr(Policy::goal_bounding && Policy::landmarks > 0)
+        return bounds.save(out) && landmarks.save(out);
+    else if constexpr(Policy::landmarks > 0)
+        return landmarks.save(out);
+    else
+        return Policy::goal_bounding && bounds.save(out);
+}
+
+template<typename Policy>
+bool CommonAlgorithm<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    if constexpr(Policy::goal_bounding && Policy::landmarks > 0)
+        return bounds.load(s, in) && landmarks.load(s, Policy::landmarks, in);
+    else if constexpr(Policy::landmarks > 0)
+        return landmarks.load(s, Policy::landmarks, in);
+    else
+        return Policy::goal_bounding && bounds.load(s, in);
+}
+
+template class CommonAlgorithm<HeadlessPolicy>;
+template class CommonAlgorithm<VisualPolicy>;
+template class CommonAlgorithm<PowerOfTwoStride<HeadlessPolicy>>;
+template class CommonAlgorithm<IntegerCost<HeadlessPolicy>>;
+template class CommonAlgorithm<IntegerCost<VisualPolicy>>;
+template class CommonAlgorithm<IndexedOpenList<HeadlessPolicy>>;
+template class CommonAlgorithm<IndexedOpenList<VisualPolicy>>;
+template class CommonAlgorithm<RadixOpenList<IntegerCost<HeadlessPolicy>>>;
+template class CommonAlgorithm<RadixOpenList<IntegerCost<VisualPolicy>>>;
+template class CommonAlgorithm<NarrowStamps<HeadlessPolicy>>;
+template class CommonAlgorithm<HashedNodes<HeadlessPolicy>>;
+template class CommonAlgorithm<HashedNodes<VisualPolicy>>;
+template class CommonAlgorithm<AdaptiveNodes<HeadlessPolicy>>;
+template class CommonAlgorithm<GoalBounding<HeadlessPolicy>>;
+template class CommonAlgorithm<GoalBounding<VisualPolicy>>;
+template class CommonAlgorithm<DifferentialHeuristic<HeadlessPolicy>>;
+template class CommonAlgorithm<DifferentialHeuristic<VisualPolicy>>;
+template class CommonAlgorithm<DifferentialHeuristic<HeadlessPolicy, 4>>;
+template class CommonAlgorithm<DifferentialHeuristic<VisualPolicy, 4>>;
+template class CommonAlgorithm<DifferentialHeuristic<HeadlessPolicy, 16>>;
+template class CommonAlgorithm<DifferentialHeuristic<VisualPolicy, 16>>;
+template class CommonAlgorithm<DeferredJumps<HeadlessPolicy>>;
+template class CommonAlgorithm<DeferredJumps<VisualPolicy>>;
+template class CommonAlgorithm<DeferredJumps<HashedNodes<HeadlessPolicy>>>;
\ No newline at end of file
@@ -2,60 +2,106 @@
 #define COMMON_HPP
 
 #include <limits>
-#include <queue>
 
 #include "algorithms/algorithm.hpp"
 #include "algorithms/util.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/node_store.hpp"
+#include "algorithms/goal_bounds.hpp"
+#include "algorithms/landmarks.hpp"
+#include "algorithms/policies.hpp"
 
-/**
- * The node implementation used internally by search algorithms.
- * 
- * Each node in the network has a:
- *  -lowest seen distance from the beginning
- *  -index of the neighbour that is closest to the beginning
- *  -status that is needed for skipping already examined nodes in the priority queue
- * 
- * In addition, for performance reasons, each node has a "last_run" value.
- * This value is equal to the last pathfinding task / run index when this node was accessed.
- * The value exists so that the "nodes" vector does not have to be completely initialized on every new pathfinding task.
- * On even slightly larger maps, this initialization step can take multiple orders of magnitude more time than the pathfinding itself.
- * See the CommonAlgorithm member function "check_node_initialized" below.
- */
-struct InternalNode
-{
-    enum Status : bool
-    {
-        UNEXAMINED,
-        EXAMINED
-    };
-
-    float distance      = std::numeric_limits<float>::infinity(); 
-    node_index prev     = NULL_NODE_IDX;
-    uint32_t last_run   = 1;
-    Status status       = Status::UNEXAMINED;
-};
-
+template<typename Policy>
 class CommonAlgorithm : public Algorithm
 {
 public:
     void init(State* state);
     virtual Result::Type update() = 0;
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
 
 protected:
+    using Cost = typename Policy::Cost;
+    using distance_t = typename Cost::distance_t;
+
+    /**
+     * The node implementation used internally by search algorithms.
+     * 
+     * Each node in the network has a:
+     *  -lowest seen distance from the beginning, in the units of the cost model
+     *  -status that is needed for skipping already examined nodes in the priority queue
+     * 
+     * In addition, for performance reasons, each node stores the last pathfinding task / run index when it was accessed.
+     * The value exists so that the "nodes" vector does not have to be completely initialized on every new pathfinding task.
+     * On even slightly larger maps, this initialization step can take multiple orders of magnitude more time than the pathfinding itself.
+     * See ScratchArena.
+     * 
+     * The index of the neighbour that is closest to the beginning is stored separately, see NodeStore::parent().
+     * See search_node.hpp for the details of the layout.
+     */
+    struct InternalNode : SearchNode<distance_t, typename Policy::Stamp>
+    {
+        enum Status : uint8_t
+        {
+            UNEXAMINED,
+            EXAMINED
+        };
+    };
+
+    /**
+     * The main storage for Nodes and the index of the previous node in the path for each node.
+     * Nodes are reset lazily when touched (see node_store.hpp).
+     */
+    typename Policy::template NodeStore<InternalNode> nodes;
+
+    /**
+     * The walls of the map, rebuilt only when the map changes.
+     */
+    Grid grid;
+
     /**
-     * The main storage for Nodes. All nodes will saved here and referenced using pointers.
+     * Maps coordinates into node indices.
      */
-    std::vector<InternalNode> nodes;
+    typename Policy::Layout layout;
 
     /**
      * The open set.
      */
-    typedef std::pair<float, node_index> queue_pair;
-    std::priority_queue<queue_pair, std::vector<queue_pair>, std::greater<queue_pair>> open;
+    typename Policy::template OpenList<distance_t> open;
 
+    /**
+     * The goal bounding tables of the map. Only built if Policy::goal_bounding is set.
+     */
+    GoalBounds bounds;
 
-    // See the next function for details about this variable.
-    uint32_t curr_run_id = 0;
+    /**
+     * The landmarks of the differential heuristic of the map. Only built if Policy::landmarks is set.
+     */
+    Landmarks landmarks;
+
+    /**
+     * Gets the heuristic from (x, y) to (goal_x, goal_y): the octile distance,
+     * or the differential heuristic of the landmarks if Policy::landmarks is set.
+     */
+    distance_t heuristic(int x, int y, int goal_x, int goal_y) const
+    {
+        if constexpr(Policy::landmarks > 0)
+            return landmarks.template heuristic<Cost>(x, y, goal_x, goal_y);
+        else
+            return Cost::heuristic(x, y, goal_x, goal_y);
+    }
+
+    /**
+     * Gets the directions in which a jump point search continues from the node (x, y), as a successor mask
+     * (see Util::canonical_successors()). The direction of arrival is read from the parent of the node,
+     * so the jumps from the parent must be straight or diagonal lines.
+     */
+    uint8_t canonical_directions(node_index node_idx, int x, int y);
 };
 
 #endif
\ No newline at end of file
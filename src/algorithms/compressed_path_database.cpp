@@ -0,0 +1,279 @@
+#include "algorithms/compressed_path_database.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/radix_heap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <thread>
+
+/**
+ * The header of the saved database after the common header (see PreprocessedKey).
+ */
+struct CompressedPathDatabaseHeader
+{
+    uint32_t cell_count;
+    uint32_t run_count;
+};
+
+static constexpr char COMPRESSED_PATH_DATABASE_MAGIC[4] = {'C', 'P', 'D', 'B'};
+static constexpr uint32_t COMPRESSED_PATH_DATABASE_VERSION = 2;
+
+bool CompressedPathDatabase::update(const State& s, const Grid& grid)
+{
+    build_time = 0;
+    if(key.is_current(s, grid))
+        return false;
+
+    build(s, grid);
+    return true;
+}
+
+void CompressedPathDatabase::order_cells(const State& s)
+{
+    cell_ids.assign(size_t(s.width) * s.height, NO_CELL);
+    id_cells.clear();
+    components.clear();
+
+    // Preorder of an iterative depth-first search from every cell not numbered yet
+    std::vector<uint32_t> stack;
+    uint32_t component = 0;
+    for(uint32_t root = 0; root < cell_ids.size(); ++root)
+    {
+        if(s.map[root] == Node::WALL || cell_ids[root] != NO_CELL)
+            continue;
+
+        stack.push_back(root);
+        while(!stack.empty())
+        {
+            uint32_t cell = stack.back();
+            stack.pop_back();
+            if(cell_ids[cell] != NO_CELL)
+                continue;
+
+            cell_ids[cell] = id_cells.size();
+            id_cells.push_back(cell);
+            components.push_back(component);
+
+            int x = cell % s.width;
+            int y = cell / s.width;
+            for(int i = 8; i-- > 0;)
+            {
+                dir_t dir = directions[i];
+                uint32_t neighbour = (y + dir->movement.second) * s.width + x + dir->movement.first;
+                if(Util::is_move_valid(s, x, y, dir) && cell_ids[neighbour] == NO_CELL)
+                    stack.push_back(neighbour);
+            }
+        }
+        component++;
+    }
+}
+
+void CompressedPathDatabase::build(const State& s, const Grid& grid)
+{
+    using Cost = OctileIntegerCost<>;
+
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    order_cells(s);
+    uint32_t cell_count = id_cells.size();
+
+    // Each thread takes the next source and only writes its own row, so no locking is needed.
+    std::vector<std::vector<uint32_t>> rows(cell_count);
+    std::atomic<uint32_t> next_source = 0;
+    auto work = [&]()
+    {
+        std::vector<Cost::distance_t> distances;
+        // The optimal first moves to each cell as a mask of directions
+        std::vector<uint8_t> moves;
+        RadixHeap<Cost::distance_t> open;
+
+        for(uint32_t source_id = next_source++; source_id < cell_count; source_id = next_source++)
+        {
+            uint32_t source_cell = id_cells[source_id];
+            distances.assign(cell_ids.size(), std::numeric_limits<Cost::distance_t>::max());
+            moves.assign(cell_ids.size(), 0);
+            distances[source_cell] = 0;
+            open.init(0);
+            open.push(0, source_cell);
+
+            while(!open.empty())
+            {
+                auto [distance, cell] = open.top();
+                open.pop();
+                if(distance > distances[cell])
+                    continue;
+
+                int x = cell % key.width;
+                int y = cell / key.width;
+                const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+                for(int i = 0; i < successors.amount; ++i)
+                {
+                    dir_t dir = directions[successors.directions[i]];
+                    uint32_t neighbour = (y + dir->movement.second) * key.width + x + dir->movement.first;
+                    Cost::distance_t new_distance = distance + Cost::move(dir);
+
+                    // The moves are symmetric, so the neighbour is an optimal parent of the cell if it is settled
+                    // and the move back is as long as the difference. Its optimal first moves are then optimal for the cell too.
+                    Cost::distance_t back_distance = distances[neighbour] == std::numeric_limits<Cost::distance_t>::max()
+                        ? distances[neighbour] : distances[neighbour] + Cost::move(dir);
+                    if(cell != source_cell && back_distance == distance)
+                        moves[cell] |= neighbour == source_cell ? 1 << ((dir->type + 4) % 8) : moves[neighbour];
+
+                    if(new_distance < distances[neighbour])
+                    {
+                        distances[neighbour] = new_distance;
+                        open.push(new_distance, neighbour);
+                    }
+                }
+            }
+
+            // The source itself and the unreachable cells are never queried, so any move will do for them.
+            std::vector<uint32_t>& row = rows[source_id];
+            uint8_t run_moves = 0;
+            for(uint32_t target = 0; target < cell_count; ++target)
+            {
+                uint8_t target_moves = moves[id_cells[target]] == 0 ? 0xFF : moves[id_cells[target]];
+                if((run_moves & target_moves) == 0)
+                {
+                    if(!row.empty())
+                        row.back() |= std::countr_zero(run_moves);
+                    row.push_back(target << 3);
+                    run_moves = target_moves;
+                }
+                else
+                {
+                    run_moves &= target_moves;
+                }
+            }
+            row.back() |= std::countr_zero(run_moves);
+            row.shrink_to_fit();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned int i = 1; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        threads.emplace_back(work);
+    work();
+    for(auto& thread : threads)
+        thread.join();
+
+    row_offsets.assign(cell_count + 1, 0);
+    runs.clear();
+    for(uint32_t id = 0; id < cell_count; ++id)
+    {
+        runs.insert(runs.end(), rows[id].begin(), rows[id].end());
+        std::vector<uint32_t>().swap(rows[id]);
+        row_offsets[id + 1] = runs.size();
+    }
+    runs.shrink_to_fit();
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    measure_lookup_time();
+}
+
+dir_t CompressedPathDatabase::first_move(uint32_t source_id, uint32_t target) const
+{
+    // The last run starting at or before the target
+    const uint32_t* first = runs.data() + row_offsets[source_id];
+    const uint32_t* last = runs.data() + row_offsets[source_id + 1];
+    const uint32_t* run = std::upper_bound(first, last, target << 3 | 7) - 1;
+    return directions[*run & 7];
+}
+
+bool CompressedPathDatabase::extract(Point a, Point b, size_t max_moves, std::vector<Point>& cells) const
+{
+    uint32_t current = get_id(a.x, a.y);
+    uint32_t target = get_id(b.x, b.y);
+    if(current == NO_CELL || target == NO_CELL || !is_reachable(current, target))
+        return false;
+
+    Point cell = a;
+    for(size_t moves = 0; current != target && (max_moves == 0 || moves < max_moves); ++moves)
+    {
+        dir_t dir = first_move(current, target);
+        cell.x += dir->movement.first;
+        cell.y += dir->movement.second;
+        cells.push_back(cell);
+        current = get_id(cell.x, cell.y);
+    }
+    return true;
+}
+
+void CompressedPathDatabase::measure_lookup_time()
+{
+    uint32_t cell_count = id_cells.size();
+    if(cell_count < 2)
+    {
+        lookup_time = 0;
+        return;
+    }
+
+    std::mt19937 random(cell_count);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for(int attempt = 0; attempt < 10 * LOOKUP_SAMPLES && pairs.size() < LOOKUP_SAMPLES; ++attempt)
+    {
+        uint32_t a = random() % cell_count;
+        uint32_t b = random() % cell_count;
+        if(a != b && is_reachable(a, b))
+            pairs.push_back({a, b});
+    }
+
+    // The moves are summed so that the lookups are not optimized away.
+    auto start = std::chrono::steady_clock::now();
+    uint32_t checksum = 0;
+    for(auto [a, b] : pairs)
+        checksum += first_move(a, b)->type;
+    auto end = std::chrono::steady_clock::now();
+
+    lookup_time = pairs.empty() || checksum == std::numeric_limits<uint32_t>::max() ? 0
+        : std::chrono::duration<double, std::nano>(end - start).count() / pairs.size();
+}
+
+bool CompressedPathDatabase::save(std::ostream& out) const
+{
+    if(!key.write(out, COMPRESSED_PATH_DATABASE_MAGIC, COMPRESSED_PATH_DATABASE_VERSION))
+        return false;
+
+    CompressedPathDatabaseHeader header{uint32_t(id_cells.size()), uint32_t(runs.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(row_offsets.data()), row_offsets.size() * sizeof(row_offsets[0]));
+    out.write(reinterpret_cast<const char*>(runs.data()), runs.size() * sizeof(runs[0]));
+    return out.good();
+}
+
+bool CompressedPathDatabase::load(const State& s, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, COMPRESSED_PATH_DATABASE_MAGIC, COMPRESSED_PATH_DATABASE_VERSION))
+        return false;
+
+    CompressedPathDatabaseHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good())
+        return false;
+
+    std::vector<uint32_t> loaded_row_offsets(header.cell_count + 1);
+    std::vector<uint32_t> loaded_runs(header.run_count);
+    in.read(reinterpret_cast<char*>(loaded_row_offsets.data()), loaded_row_offsets.size() * sizeof(loaded_row_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_runs.data()), loaded_runs.size() * sizeof(loaded_runs[0]));
+    if(!in.good())
+        return false;
+
+    // The previous database no longer matches the order, so it is built again on the next update() if the data is invalid.
+    order_cells(s);
+    key = PreprocessedKey{};
+    if(id_cells.size() != header.cell_count || loaded_row_offsets.back() != header.run_count)
+        return false;
+
+    row_offsets = std::move(loaded_row_offsets);
+    runs = std::move(loaded_runs);
+
+    key = loaded_key;
+    build_time = 0;
+    measure_lookup_time();
+    return true;
+}
\ No newline at end of file
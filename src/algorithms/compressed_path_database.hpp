@@ -0,0 +1,177 @@
+#ifndef COMPRESSED_PATH_DATABASE_HPP
+#define COMPRESSED_PATH_DATABASE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+#include "algorithms/util.hpp"
+
+/**
+ * A compressed path database (CPD), as described in Strasser et al., 2015 ("Compressing Optimal Paths with Run Length Encoding").
+ *
+ * For every pair of empty cells, the database holds the first move of a shortest path between them,
+ * so a path is extracted one move at a time with a lookup per move, without any search.
+ *
+ * The empty cells are numbered in the depth-first order of the moves between them, so that cells close to each other
+ * mostly get close ids. The first moves from each source cell form a row, ordered by the ids of the target cells,
+ * and each row is compressed into runs of targets with the same first move. A target often has several optimal first moves,
+ * and the run is extended as long as one move is optimal for all of its targets. Most targets in the same direction share
+ * their first move, so a row only has a few runs per wall the source sees.
+ * Each run takes 4 bytes: the id of its first target and the move (see first_move()).
+ *
+ * The rows are built with one Dijkstra search per source cell, i.e. in O(n^2 log n) time for n cells,
+ * distributed over all hardware threads. The database is meant for small maps that are queried constantly.
+ */
+class CompressedPathDatabase
+{
+public:
+    static constexpr uint32_t NO_CELL = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * The amount of random lookups timed for get_lookup_time().
+     */
+    static constexpr int LOOKUP_SAMPLES = 10000;
+
+    /**
+     * Builds the database of the state, unless it is already up to date (the same state, revision and size).
+     * The grid must be up to date.
+     *
+     * @returns Whether the database was built.
+     */
+    bool update(const State& state, const Grid& grid);
+
+    /**
+     * Builds the database of the state. The grid must be up to date.
+     */
+    void build(const State& state, const Grid& grid);
+
+    /**
+     * Gets the id of the cell (x, y), or NO_CELL if it is a wall.
+     */
+    uint32_t get_id(int x, int y) const
+    {
+        return cell_ids[y * key.width + x];
+    }
+
+    Point get_cell(uint32_t id) const
+    {
+        return {int(id_cells[id] % key.width), int(id_cells[id] / key.width)};
+    }
+
+    size_t get_cell_count() const
+    {
+        return id_cells.size();
+    }
+
+    /**
+     * Is there a path between the cells?
+     */
+    bool is_reachable(uint32_t source, uint32_t target) const
+    {
+        return components[source] == components[target];
+    }
+
+    /**
+     * Gets the first move of a shortest path from the source cell to the target cell, by their ids.
+     * The target must be reachable from the source, and not the source itself.
+     */
+    dir_t first_move(uint32_t source, uint32_t target) const;
+
+    /**
+     * Appends the cells of a shortest path from a to b into cells, without a, up to max_moves moves (0 for the whole path).
+     *
+     * @returns Whether b is reachable from a.
+     */
+    bool extract(Point a, Point b, size_t max_moves, std::vector<Point>& cells) const;
+
+    size_t get_run_count() const
+    {
+        return runs.size();
+    }
+
+    /**
+     * Gets the size of the uncompressed first-move tables (one byte per pair of cells) divided by the size of the runs.
+     */
+    double get_compression_ratio() const
+    {
+        return runs.empty() ? 0 : (double)id_cells.size() * id_cells.size() / (runs.size() * sizeof(runs[0]));
+    }
+
+    /**
+     * Gets the average time (in nanoseconds) of a first_move() lookup between random cells, measured after building or loading.
+     */
+    double get_lookup_time() const
+    {
+        return lookup_time;
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the database during the last update(), or 0 if it was up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the database in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return cell_ids.capacity() * sizeof(cell_ids[0])
+            + id_cells.capacity() * sizeof(id_cells[0])
+            + components.capacity() * sizeof(components[0])
+            + row_offsets.capacity() * sizeof(row_offsets[0])
+            + runs.capacity() * sizeof(runs[0]);
+    }
+
+    /**
+     * Writes the database into the stream: the rows of runs only, as the order of the cells follows from the walls.
+     *
+     * @returns Whether the database was written. False if it has not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads a database written by save(), so that the next update() with the state does not build it again.
+     *
+     * @returns Whether the database was loaded. False if the data is invalid or was made for another map.
+     */
+    bool load(const State& state, std::istream& in);
+
+private:
+    // The id of each cell (by map index), NO_CELL for walls
+    std::vector<uint32_t> cell_ids;
+
+    // The map index of each id, and the connected component of each id
+    std::vector<uint32_t> id_cells;
+    std::vector<uint32_t> components;
+
+    // The runs of the row of source i are runs[row_offsets[i]] to runs[row_offsets[i + 1] - 1].
+    // A run is (the id of its first target << 3) | the Direction::type of its move.
+    std::vector<uint32_t> row_offsets;
+    std::vector<uint32_t> runs;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+    double lookup_time = 0;
+
+    /**
+     * Numbers the empty cells of the state in depth-first order, and finds the connected components.
+     */
+    void order_cells(const State& state);
+
+    /**
+     * Times LOOKUP_SAMPLES lookups between random cells into lookup_time.
+     */
+    void measure_lookup_time();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/radix_heap.hpp"
+#include "algorithms/util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+
+/**
+ * The header of the saved hierarchy after the common header (see PreprocessedKey).
+ */
+struct ContractionHierarchyHeader
+{
+    uint32_t node_count;
+    uint32_t edge_count;
+};
+
+static constexpr char CONTRACTION_HIERARCHY_MAGIC[4] = {'C', 'H', 'G', 'R'};
+static constexpr uint32_t CONTRACTION_HIERARCHY_VERSION = 3;
+
+struct ContractionHierarchy::Contraction
+{
+    // The edges between the nodes not contracted yet, in both directions.
+    // A contracted node keeps its edges to the nodes that were left, i.e. its upward edges.
+    std::vector<std::vector<Edge>> graph;
+    std::vector<int32_t> contracted_neighbours;
+
+    // The length of the longest chain of contracted nodes below each node
+    std::vector<int32_t> levels;
+
+    // The buffers of the witness searches; distances are only valid when the stamp is the current run
+    std::vector<distance_t> distances;
+    std::vector<uint32_t> stamps;
+    std::vector<uint32_t> target_stamps;
+    uint32_t run_id = 0;
+    int targets_left = 0;
+    RadixHeap<distance_t> open;
+
+    explicit Contraction(size_t node_count)
+        : graph(node_count), contracted_neighbours(node_count, 0), levels(node_count, 0),
+          distances(node_count), stamps(node_count, 0), target_stamps(node_count, 0)
+    {
+    }
+
+    distance_t get_distance(uint32_t node) const
+    {
+        return stamps[node] == run_id ? distances[node] : UNREACHABLE;
+    }
+
+    /**
+     * Runs a Dijkstra search from the source around the avoided node, up to max_distance,
+     * until all the targets (the nodes whose target stamp is the next run id) or settle_limit nodes have been settled.
+     */
+    void witness_search(uint32_t source, uint32_t avoided, distance_t max_distance, int settle_limit)
+    {
+        run_id++;
+        distances[source] = 0;
+        stamps[source] = run_id;
+        open.init(0);
+        open.push(0, source);
+
+        int settled = 0;
+        while(!open.empty() && settled < settle_limit)
+        {
+            auto [distance, node] = open.top();
+            open.pop();
+            if(distance > get_distance(node))
+                continue;
+
+            settled++;
+            if(target_stamps[node] == run_id && --targets_left == 0)
+                break;
+
+            for(const Edge& edge : graph[node])
+            {
+                distance_t new_distance = distance + edge.cost;
+                if(edge.to != avoided && new_distance <= max_distance && new_distance < get_distance(edge.to))
+                {
+                    distances[edge.to] = new_distance;
+                    stamps[edge.to] = run_id;
+                    open.push(new_distance, edge.to);
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds an edge, or shortens the existing edge between the nodes.
+     */
+    void add_edge(uint32_t from, uint32_t to, distance_t cost, uint32_t middle)
+    {
+        for(Edge& edge : graph[from])
+        {
+            if(edge.to == to)
+            {
+                if(cost < edge.cost)
+                    edge = {cost, to, middle};
+                return;
+            }
+        }
+        graph[from].push_back({cost, to, middle});
+    }
+
+    /**
+     * Counts the shortcuts needed between the neighbours of the node for contracting it, and adds them unless simulating.
+     */
+    int contract(uint32_t node, bool simulate)
+    {
+        int shortcuts = 0;
+        // Adding the shortcuts only changes the edges of the neighbours, so the reference stays valid.
+        const std::vector<Edge>& edges = graph[node];
+        for(size_t i = 0; i + 1 < edges.size(); ++i)
+        {
+            distance_t max_distance = 0;
+            for(size_t j = i + 1; j < edges.size(); ++j)
+            {
+                max_distance = std::max(max_distance, edges[i].cost + edges[j].cost);
+                target_stamps[edges[j].to] = run_id + 1;
+            }
+            targets_left = edges.size() - i - 1;
+
+            witness_search(edges[i].to, node, max_distance, simulate ? PRIORITY_SETTLE_LIMIT : WITNESS_SETTLE_LIMIT);
+            for(size_t j = i + 1; j < edges.size(); ++j)
+            {
+                distance_t distance = edges[i].cost + edges[j].cost;
+                if(get_distance(edges[j].to) <= distance)
+                    continue;
+
+                shortcuts++;
+                if(!simulate)
+                {
+                    add_edge(edges[i].to, edges[j].to, distance, node);
+                    add_edge(edges[j].to, edges[i].to, distance, node);
+                }
+            }
+        }
+        return shortcuts;
+    }
+
+    /**
+     * Gets the priority of the node: the lower, the earlier it is contracted.
+     */
+    int32_t priority(uint32_t node)
+    {
+        return contract(node, true) - int32_t(graph[node].size()) + contracted_neighbours[node] + levels[node];
+    }
+
+    /**
+     * Removes the edges to the node from its neighbours.
+     */
+    void remove(uint32_t node)
+    {
+        for(const Edge& edge : graph[node])
+        {
+            auto& neighbour_edges = graph[edge.to];
+            neighbour_edges.erase(std::find_if(neighbour_edges.begin(), neighbour_edges.end(), [&](const Edge& e) { return e.to == node; }));
+            contracted_neighbours[edge.to]++;
+            levels[edge.to] = std::max(levels[edge.to], levels[node] + 1);
+        }
+    }
+};
+
+bool ContractionHierarchy::update(const State& s, const Grid& grid)
+{
+    build_time = 0;
+    if(key.is_current(s, grid))
+        return false;
+
+    build(s, grid);
+    return true;
+}
+
+void ContractionHierarchy::build(const State& s, const Grid& grid)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+
+    // Number the empty cells in the map order for the contraction.
+    std::vector<uint32_t> cells;
+    std::vector<uint32_t> ids(size_t(key.width) * key.height, NO_NODE);
+    for(int y = 0; y < key.height; ++y)
+    {
+        for(int x = 0; x < key.width; ++x)
+        {
+            if(grid.is_empty(x, y))
+            {
+                ids[y * key.width + x] = cells.size();
+                cells.push_back(y * key.width + x);
+            }
+        }
+    }
+
+    uint32_t node_count = cells.size();
+    Contraction contraction(node_count);
+    for(uint32_t node = 0; node < node_count; ++node)
+    {
+        int x = cells[node] % key.width;
+        int y = cells[node] / key.width;
+        for(int i = 0; i < 8; ++i)
+        {
+            dir_t dir = directions[i];
+            if(Util::is_move_valid(grid, x, y, dir))
+            {
+                uint32_t neighbour = ids[(y + dir->movement.second) * key.width + x + dir->movement.first];
+                contraction.graph[node].push_back({OctileIntegerCost<>::move(dir), neighbour, NO_NODE});
+            }
+        }
+    }
+
+    // Contract the nodes by their priorities. The priorities are updated lazily: the priority of the node on the top of the queue
+    // is computed again, and if it is no longer the lowest, the node goes back into the queue.
+    // Updating the priorities of the neighbours of every contracted node instead took several times longer on grids.
+    using QueueEntry = std::pair<int32_t, uint32_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+    for(uint32_t node = 0; node < node_count; ++node)
+        queue.push({contraction.priority(node), node});
+
+    std::vector<uint32_t> order;
+    order.reserve(node_count);
+    while(!queue.empty())
+    {
+        uint32_t node = queue.top().second;
+        queue.pop();
+
+        int32_t priority = contraction.priority(node);
+        if(!queue.empty() && priority > queue.top().first)
+        {
+            queue.push({priority, node});
+            continue;
+        }
+
+        contraction.contract(node, false);
+        contraction.remove(node);
+        order.push_back(node);
+    }
+
+    // Renumber the nodes by their ranks.
+    std::vector<uint32_t> ranks(node_count);
+    for(uint32_t rank = 0; rank < node_count; ++rank)
+        ranks[order[rank]] = rank;
+
+    cell_nodes.assign(size_t(key.width) * key.height, NO_NODE);
+    node_cells.resize(node_count);
+    edge_offsets.assign(node_count + 1, 0);
+    edges.clear();
+    shortcut_count = 0;
+    for(uint32_t rank = 0; rank < node_count; ++rank)
+    {
+        uint32_t node = order[rank];
+        node_cells[rank] = cells[node];
+        cell_nodes[cells[node]] = rank;
+        for(const Edge& edge : contraction.graph[node])
+        {
+            edges.push_back({edge.cost, ranks[edge.to], edge.middle == NO_NODE ? NO_NODE : ranks[edge.middle]});
+            shortcut_count += edge.middle != NO_NODE;
+        }
+        edge_offsets[rank + 1] = edges.size();
+    }
+    edges.shrink_to_fit();
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+const ContractionHierarchy::Edge* ContractionHierarchy::find_edge(uint32_t a, uint32_t b) const
+{
+    auto [first, last] = get_upward_edges(std::min(a, b));
+    for(auto edge = first; edge != last; ++edge)
+    {
+        if(edge->to == std::max(a, b))
+            return edge;
+    }
+    return nullptr;
+}
+
+void ContractionHierarchy::unpack(const std::vector<uint32_t>& nodes, std::vector<Point>& cells) const
+{
+    // The edges still to unpack, the next one on the top
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    for(size_t i = nodes.size(); i-- > 1;)
+        stack.push_back({nodes[i - 1], nodes[i]});
+
+    while(!stack.empty())
+    {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+
+        // The middle node of a shortcut was contracted before both of its ends, so both halves are upward edges from it.
+        const Edge* edge = find_edge(a, b);
+        if(edge->middle == NO_NODE)
+        {
+            cells.push_back(get_cell(b));
+        }
+        else
+        {
+            stack.push_back({edge->middle, b});
+            stack.push_back({a, edge->middle});
+        }
+    }
+}
+
+bool ContractionHierarchy::save(std::ostream& out) const
+{
+    if(!key.write(out, CONTRACTION_HIERARCHY_MAGIC, CONTRACTION_HIERARCHY_VERSION))
+        return false;
+
+    ContractionHierarchyHeader header{uint32_t(node_cells.size()), uint32_t(edges.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(node_cells.data()), node_cells.size() * sizeof(node_cells[0]));
+    out.write(reinterpret_cast<const char*>(edge_offsets.data()), edge_offsets.size() * sizeof(edge_offsets[0]));
+    out.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(edges[0]));
+    return out.good();
+}
+
+bool ContractionHierarchy::load(const State& s, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, CONTRACTION_HIERARCHY_MAGIC, CONTRACTION_HIERARCHY_VERSION))
+        return false;
+
+    ContractionHierarchyHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good())
+        return false;
+
+    std::vector<uint32_t> loaded_cells(header.node_count);
+    std::vector<uint32_t> loaded_edge_offsets(header.node_count + 1);
+    std::vector<Edge> loaded_edges(header.edge_count);
+    in.read(reinterpret_cast<char*>(loaded_cells.data()), loaded_cells.size() * sizeof(loaded_cells[0]));
+    in.read(reinterpret_cast<char*>(loaded_edge_offsets.data()), loaded_edge_offsets.size() * sizeof(loaded_edge_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_edges.data()), loaded_edges.size() * sizeof(loaded_edges[0]));
+    if(!in.good())
+        return false;
+
+    node_cells = std::move(loaded_cells);
+    edge_offsets = std::move(loaded_edge_offsets);
+    edges = std::move(loaded_edges);
+    cell_nodes.assign(size_t(s.width) * s.height, NO_NODE);
+    for(uint32_t node = 0; node < node_cells.size(); ++node)
+        cell_nodes[node_cells[node]] = node;
+    shortcut_count = std::count_if(edges.begin(), edges.end(), [](const Edge& edge) { return edge.middle != NO_NODE; });
+
+    key = loaded_key;
+    build_time = 0;
+    return true;
+}
\ No newline at end of file
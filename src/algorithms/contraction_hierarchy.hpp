@@ -0,0 +1,180 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+
+/**
+ * A contraction hierarchy of the grid graph, as described in Geisberger et al., 2008
+ * ("Contraction Hierarchies: Faster and Simpler Hierarchical Routing in Road Networks").
+ *
+ * The nodes are the empty cells, and the edges the valid moves between them (see Util::is_move_valid()).
+ * The nodes are contracted one by one, least important first: a contracted node is removed from the graph,
+ * and a shortcut is added between two of its neighbours whenever the path through it is the only shortest path between them.
+ * Whether there is another path (a witness) is checked with a Dijkstra search limited to WITNESS_SETTLE_LIMIT nodes,
+ * so some unnecessary shortcuts are added, but never too few.
+ *
+ * The importance of a node is its edge difference (the amount of shortcuts its contraction would add minus the amount of its edges),
+ * plus the amount of its already contracted neighbours and the depth of the hierarchy below it,
+ * which spread the contraction evenly over the map and keep the hierarchy shallow.
+ *
+ * The nodes are numbered by the order of contraction, so the node ids are also the ranks of the nodes.
+ * Only the upward edges are kept: the edges from each node to its neighbours of higher rank at the time of its contraction.
+ * Every shortest path then consists of an upward part from the beginning and a downward part to the end,
+ * which a bidirectional Dijkstra search over the upward edges from both ends finds (see ContractionHierarchySearch).
+ *
+ * The lengths are in the units and the type of OctileIntegerCost, so that comparing paths is exact
+ * and a shortcut as long as a path through a large maze does not overflow.
+ */
+class ContractionHierarchy
+{
+public:
+    using distance_t = OctileIntegerCost<>::distance_t;
+
+    static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+    static constexpr distance_t UNREACHABLE = std::numeric_limits<distance_t>::max();
+
+    /**
+     * The maximum amount of nodes settled by a witness search when contracting a node.
+     */
+    static constexpr int WITNESS_SETTLE_LIMIT = 200;
+
+    /**
+     * The maximum amount of nodes settled by a witness search when only estimating the priority of a node.
+     */
+    static constexpr int PRIORITY_SETTLE_LIMIT = 10;
+
+    // The cost comes first, so that the edge is not padded.
+    struct Edge
+    {
+        distance_t cost;
+        uint32_t to;
+        // The contracted node the shortcut passes through, or NO_NODE for a move between neighbouring cells
+        uint32_t middle;
+    };
+
+    /**
+     * Builds the hierarchy of the state, unless it is already up to date (the same state, revision and size).
+     * The grid must be up to date.
+     *
+     * @returns Whether the hierarchy was built.
+     */
+    bool update(const State& state, const Grid& grid);
+
+    /**
+     * Builds the hierarchy of the state. The grid must be up to date.
+     */
+    void build(const State& state, const Grid& grid);
+
+    /**
+     * Gets the node of the cell (x, y), or NO_NODE if it is a wall.
+     */
+    uint32_t get_node(int x, int y) const
+    {
+        return cell_nodes[y * key.width + x];
+    }
+
+    Point get_cell(uint32_t node) const
+    {
+        return {int(node_cells[node] % key.width), int(node_cells[node] / key.width)};
+    }
+
+    size_t get_node_count() const
+    {
+        return node_cells.size();
+    }
+
+    /**
+     * Gets the range [first, last) of the edges from the node to nodes of higher rank.
+     */
+    std::pair<const Edge*, const Edge*> get_upward_edges(uint32_t node) const
+    {
+        return {edges.data() + edge_offsets[node], edges.data() + edge_offsets[node + 1]};
+    }
+
+    /**
+     * Unpacks the path along the edges between consecutive nodes (in either direction) into cells,
+     * and appends them to cells without the cell of the first node.
+     */
+    void unpack(const std::vector<uint32_t>& nodes, std::vector<Point>& cells) const;
+
+    size_t get_edge_count() const
+    {
+        return edges.size();
+    }
+
+    size_t get_shortcut_count() const
+    {
+        return shortcut_count;
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the hierarchy during the last update(), or 0 if it was up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the hierarchy in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return cell_nodes.capacity() * sizeof(cell_nodes[0])
+            + node_cells.capacity() * sizeof(node_cells[0])
+            + edge_offsets.capacity() * sizeof(edge_offsets[0])
+            + edges.capacity() * sizeof(edges[0]);
+    }
+
+    /**
+     * Writes the hierarchy into the stream.
+     *
+     * @returns Whether the hierarchy was written. False if it has not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads a hierarchy written by save(), so that the next update() with the state does not build it again.
+     *
+     * @returns Whether the hierarchy was loaded. False if the data is invalid or was made for another map.
+     */
+    bool load(const State& state, std::istream& in);
+
+private:
+    // The node of each cell (by map index), NO_NODE for walls
+    std::vector<uint32_t> cell_nodes;
+
+    // The map index of the cell of each node
+    std::vector<uint32_t> node_cells;
+
+    // The upward edges from node i are edges[edge_offsets[i]] to edges[edge_offsets[i + 1] - 1]
+    std::vector<uint32_t> edge_offsets;
+    std::vector<Edge> edges;
+    size_t shortcut_count = 0;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+
+    /**
+     * The remaining graph during the contraction, and the buffers of the witness searches.
+     */
+    struct Contraction;
+
+    /**
+     * Finds the upward edge between the nodes, or nullptr if there is none.
+     */
+    const Edge* find_edge(uint32_t a, uint32_t b) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef COST_HPP
+#define COST_HPP
+
+#include <cstdint>
+
+#include "algorithms/util.hpp"
+
+/**
+ * Cost models define the type of the distances used by the algorithms, the costs of the moves and the heuristic.
+ * A cost model is selected with the Cost type of the policy (see policies.hpp).
+ *
+ * Every cost model provides:
+ *  -distance_t:            the type of the distances
+ *  -STRAIGHT, DIAGONAL:    the costs of straight and diagonal moves
+ *  -move(dir):             the cost of a move in the specified direction
+ *  -heuristic(x1, y1, x2, y2): the octile distance between the two points, in the same units
+ *  -to_float(distance):    converts a distance into the float units of Algorithm::Result (straight move = 1.0)
+ */
+
+/**
+ * Floating point costs: straight moves cost 1, diagonal moves cost sqrt(2).
+ * Sums of these are not exact, so paths of equal length can compare unequal.
+ */
+struct FloatCost
+{
+    typedef float distance_t;
+
+    static constexpr distance_t STRAIGHT = 1.0f;
+    static constexpr distance_t DIAGONAL = SQRT_2;
+
+    static distance_t move(dir_t dir)
+    {
+        return dir->straight ? STRAIGHT : DIAGONAL;
+    }
+
+    static distance_t heuristic(int x1, int y1, int x2, int y2)
+    {
+        return Util::diagonal_distance(x1, y1, x2, y2);
+    }
+
+    static float to_float(distance_t distance)
+    {
+        return distance;
+    }
+};
+
+/**
+ * Exact fixed-point integer costs: straight moves cost STRAIGHT_COST and diagonal moves DIAGONAL_COST.
+ *
+ * All sums and comparisons of distances are exact, so ties are handled deterministically and
+ * the results do not depend on the compiler or the floating point environment.
+ * The keys of the priority queues are integers, which allows the use of integer priority queues.
+ *
+ * The default costs 2378 and 3363 approximate sqrt(2) with a relative error of 4.4e-8.
+ * The distance is a signed 64-bit integer: a 32-bit distance would overflow after about 900 000 straight moves,
+ * which the paths through large maze maps exceed. With 64 bits the limit is about 3.8e15 straight moves,
+ * far above the amount of cells of any map. The distance is signed so that differences of distances can be computed safely.
+ */
+template<int32_t STRAIGHT_COST = 2378, int32_t DIAGONAL_COST = 3363>
+struct OctileIntegerCost
+{
+    typedef int64_t distance_t;
+
+    static constexpr distance_t STRAIGHT = STRAIGHT_COST;
+    static constexpr distance_t DIAGONAL = DIAGONAL_COST;
+
+    static distance_t move(dir_t dir)
+    {
+        return dir->straight ? STRAIGHT : DIAGONAL;
+    }
+
+    static distance_t heuristic(int x1, int y1, int x2, int y2)
+    {
+        return Util::diagonal_distance(x1, y1, x2, y2, STRAIGHT, DIAGONAL);
+    }
+
+    static float to_float(distance_t distance)
+    {
+        return (double)distance / STRAIGHT;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "algorithms/cpd_search.hpp"
+#include "algorithms/cost.hpp"
+
+template<typename Policy>
+void CompressedPathDatabaseSearch<Policy>::init(State* s)
+{
+    state = s;
+    grid.update(*s);
+    database.update(*s, grid);
+
+    result = Algorithm::Result{};
+    current = s->begin;
+    current_id = database.get_id(s->begin.x, s->begin.y);
+    end_id = database.get_id(s->end.x, s->end.y);
+    distance = 0;
+}
+
+template<typename Policy>
+Algorithm::Result::Type CompressedPathDatabaseSearch<Policy>::update()
+{
+    if(current_id == CompressedPathDatabase::NO_CELL || end_id == CompressedPathDatabase::NO_CELL
+    || !database.is_reachable(current_id, end_id))
+    {
+        result.type = Result::Type::FAILURE;
+        return Result::Type::FAILURE;
+    }
+
+    if(current_id == end_id || (max_moves != 0 && result.path.size() == max_moves))
+    {
+        result.length = OctileIntegerCost<>::to_float(distance);
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    dir_t dir = database.first_move(current_id, end_id);
+    current.x += dir->movement.first;
+    current.y += dir->movement.second;
+    current_id = database.get_id(current.x, current.y);
+    distance += OctileIntegerCost<>::move(dir);
+
+    // Every lookup is counted as an expansion of the cell it moves from.
+    result.expanded++;
+    result.path.push_back(current);
+    Observer::path(*state, current.y * state->width + current.x);
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+size_t CompressedPathDatabaseSearch<Policy>::get_memory_usage()
+{
+    return grid.get_memory_usage() + get_preprocessed_memory_usage();
+}
+
+template<typename Policy>
+double CompressedPathDatabaseSearch<Policy>::get_preprocessing_time()
+{
+    return database.get_build_time();
+}
+
+template<typename Policy>
+size_t CompressedPathDatabaseSearch<Policy>::get_preprocessed_memory_usage()
+{
+    return database.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> CompressedPathDatabaseSearch<Policy>::get_preprocessed_statistics()
+{
+    return {
+        {"cells", database.get_cell_count()},
+        {"runs", database.get_run_count()},
+        {"compression_ratio", database.get_compression_ratio()},
+        {"first_move_ns", database.get_lookup_time()}
+    };
+}
+
+template<typename Policy>
+bool CompressedPathDatabaseSearch<Policy>::save_preprocessed(std::ostream& out)
+{
+    return database.save(out);
+}
+
+template<typename Policy>
+bool CompressedPathDatabaseSearch<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return database.load(s, in);
+}
+
+template class CompressedPathDatabaseSearch<HeadlessPolicy>;
+template class CompressedPathDatabaseSearch<VisualPolicy>;
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef CPD_SEARCH_HPP
+#define CPD_SEARCH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/algorithm.hpp"
+#include "algorithms/compressed_path_database.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Path queries answered from a compressed path database of the map (see compressed_path_database.hpp).
+ *
+ * There is no search: each update() looks up the first move of a shortest path from the current cell to the end
+ * and takes it, so the path is extracted one move at a time. With max_moves, the query stops after that many moves,
+ * e.g. for a unit that only needs the next few moves before the map or the end changes.
+ * The length of the result is the length of the returned moves.
+ *
+ * Building the database takes minutes on large maps. The results are optimal.
+ */
+template<typename Policy = HeadlessPolicy>
+class CompressedPathDatabaseSearch : public Algorithm
+{
+public:
+    /**
+     * @param max_moves The maximum amount of moves returned, or 0 for the whole path.
+     */
+    explicit CompressedPathDatabaseSearch(size_t max_moves = 0) : max_moves(max_moves)
+    {
+    }
+
+    void init(State* state);
+    Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+
+    const CompressedPathDatabase& get_database() const
+    {
+        return database;
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+
+    size_t max_moves;
+
+    Grid grid;
+    CompressedPathDatabase database;
+
+    // The cell reached so far and its id
+    Point current;
+    uint32_t current_id = CompressedPathDatabase::NO_CELL;
+    uint32_t end_id = CompressedPathDatabase::NO_CELL;
+
+    // The length of the moves so far, in the units of OctileIntegerCost
+    OctileIntegerCost<>::distance_t distance = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "algorithms/goal_bounds.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/radix_heap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+static constexpr char GOAL_BOUNDS_MAGIC[4] = {'G', 'B', 'N', 'D'};
+static constexpr uint32_t GOAL_BOUNDS_VERSION = 2;
+
+struct GoalBounds::SearchBuffers
+{
+    std::vector<OctileIntegerCost<>::distance_t> distances;
+
+    // The directions of all the optimal first moves from the source towards each cell, as a successor mask
+    std::vector<uint8_t> first_moves;
+
+    RadixHeap<OctileIntegerCost<>::distance_t> open;
+};
+
+bool GoalBounds::update(const State& s, const Grid& grid)
+{
+    build_time = 0;
+    if(key.is_current(s, grid))
+        return false;
+
+    build(s, grid);
+    return true;
+}
+
+void GoalBounds::build(const State& s, const Grid& grid)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    boxes.assign(key.width * key.height, {});
+
+    // Each thread takes the next row of sources. Every source only writes its own boxes, so no locking is needed.
+    std::atomic<int> next_row = 0;
+    auto work = [&]()
+    {
+        SearchBuffers buffers;
+        buffers.distances.resize(key.width * key.height);
+        buffers.first_moves.resize(key.width * key.height);
+
+        for(int y = next_row++; y < key.height; y = next_row++)
+        {
+            for(int x = 0; x < key.width; ++x)
+            {
+                if(grid.is_empty(x, y))
+                    search_from(grid, x, y, buffers);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned int i = 1; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        threads.emplace_back(work);
+    work();
+    for(auto& thread : threads)
+        thread.join();
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GoalBounds::search_from(const Grid& grid, int source_x, int source_y, SearchBuffers& buffers)
+{
+    using Cost = OctileIntegerCost<>;
+
+    auto& distances = buffers.distances;
+    auto& first_moves = buffers.first_moves;
+    auto& open = buffers.open;
+    auto& source_boxes = boxes[source_y * key.width + source_x];
+
+    std::fill(distances.begin(), distances.end(), std::numeric_limits<Cost::distance_t>::max());
+
+    node_index source_idx = source_y * key.width + source_x;
+    distances[source_idx] = 0;
+    first_moves[source_idx] = 0;
+    open.init(0);
+    open.push(0, source_idx);
+
+    while(!open.empty())
+    {
+        auto [distance, idx] = open.top();
+        open.pop();
+        if(distance > distances[idx])
+            continue;
+
+        int x = idx % key.width;
+        int y = idx / key.width;
+
+        // All the moves have a positive cost, so every optimal predecessor of the cell has already been expanded.
+        const SuccessorList& moves = successor_lists[first_moves[idx]];
+        for(int i = 0; i < moves.amount; ++i)
+        {
+            Box& box = source_boxes[moves.directions[i]];
+            box.min_x = std::min<int16_t>(box.min_x, x);
+            box.min_y = std::min<int16_t>(box.min_y, y);
+            box.max_x = std::max<int16_t>(box.max_x, x);
+            box.max_y = std::max<int16_t>(box.max_y, y);
+        }
+
+        const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+        for(int i = 0; i < successors.amount; ++i)
+        {
+            dir_t dir = directions[successors.directions[i]];
+            auto [dx, dy] = dir->movement;
+            node_index neighbour_idx = idx + dy * key.width + dx;
+            Cost::distance_t new_distance = distance + Cost::move(dir);
+            uint8_t first_move = idx == source_idx ? 1 << dir->type : first_moves[idx];
+
+            if(new_distance < distances[neighbour_idx])
+            {
+                distances[neighbour_idx] = new_distance;
+                first_moves[neighbour_idx] = first_move;
+                open.push(new_distance, neighbour_idx);
+            }
+            else if(new_distance == distances[neighbour_idx])
+            {
+                first_moves[neighbour_idx] |= first_move;
+            }
+        }
+    }
+}
+
+bool GoalBounds::save(std::ostream& out) const
+{
+    if(!key.write(out, GOAL_BOUNDS_MAGIC, GOAL_BOUNDS_VERSION))
+        return false;
+
+    out.write(reinterpret_cast<const char*>(boxes.data()), boxes.size() * sizeof(boxes[0]));
+    return out.good();
+}
+
+bool GoalBounds::load(const State& s, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, GOAL_BOUNDS_MAGIC, GOAL_BOUNDS_VERSION))
+        return false;
+
+    std::vector<std::array<Box, 8>> loaded(s.width * s.height);
+    in.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(loaded[0]));
+    if(!in.good())
+        return false;
+
+    boxes = std::move(loaded);
+    key = loaded_key;
+    build_time = 0;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef GOAL_BOUNDS_HPP
+#define GOAL_BOUNDS_HPP
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+#include "algorithms/util.hpp"
+
+/**
+ * Goal bounding tables, as described in Rabin and Sturtevant, 2016 ("Faster A* with Goal Bounding").
+ *
+ * For every cell and each of the 8 directions, the table holds the bounding box of all the cells
+ * that an optimal path from the cell reaches by starting with a move in the direction.
+ * A search can then skip a move whose box does not contain the end: no optimal path to the end starts with it.
+ * When several optimal paths start with different moves, the cell is in the boxes of all of them,
+ * so the pruning keeps every optimal path and the results stay optimal.
+ *
+ * The tables take 64 bytes per cell and are built with one Dijkstra search from every empty cell,
+ * i.e. in O(n^2 log n) time for a map of n cells. This takes seconds on maps of 100x100 cells and hours on 512x512 maps,
+ * so on larger maps the tables should be built offline and loaded (see save() and load()).
+ * The searches are distributed over all hardware threads.
+ *
+ * The searches use the exact integer costs of OctileIntegerCost, so paths with the same amounts of straight and
+ * diagonal moves always tie. The tables are thus valid for both the float and the integer cost model.
+ * The coordinates are 16-bit, so the map can be at most 32767 cells wide and high.
+ */
+class GoalBounds
+{
+public:
+    /**
+     * An inclusive bounding box. An empty box has min > max.
+     */
+    struct Box
+    {
+        int16_t min_x = std::numeric_limits<int16_t>::max();
+        int16_t min_y = std::numeric_limits<int16_t>::max();
+        int16_t max_x = std::numeric_limits<int16_t>::min();
+        int16_t max_y = std::numeric_limits<int16_t>::min();
+
+        bool contains(int x, int y) const
+        {
+            return x >= min_x && x <= max_x && y >= min_y && y <= max_y;
+        }
+
+        bool empty() const
+        {
+            return min_x > max_x;
+        }
+    };
+
+    /**
+     * Builds the tables of the state, unless they are already up to date (the same state, revision and size).
+     * The grid must be up to date.
+     *
+     * @returns Whether the tables were built.
+     */
+    bool update(const State& state, const Grid& grid);
+
+    /**
+     * Builds the tables of the state. The grid must be up to date.
+     */
+    void build(const State& state, const Grid& grid);
+
+    /**
+     * Gets the box of the cells whose optimal paths from (x, y) start with a move in the direction dir.
+     */
+    const Box& get_box(int x, int y, dir_t dir) const
+    {
+        return boxes[y * key.width + x][dir->type];
+    }
+
+    /**
+     * Can an optimal path from (x, y) to (goal_x, goal_y) start with a move in the direction dir?
+     */
+    bool contains(int x, int y, dir_t dir, int goal_x, int goal_y) const
+    {
+        return get_box(x, y, dir).contains(goal_x, goal_y);
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the tables during the last update(), or 0 if they were up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the tables in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return boxes.capacity() * sizeof(boxes[0]);
+    }
+
+    /**
+     * Writes the tables into the stream.
+     *
+     * @returns Whether the tables were written. False if they have not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads tables written by save(), so that the next update() with the state does not build them again.
+     *
+     * @returns Whether the tables were loaded. False if the data is invalid or was made for another map.
+     */
+    bool load(const State& state, std::istream& in);
+
+private:
+    std::vector<std::array<Box, 8>> boxes;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+
+    /**
+     * The buffers of the Dijkstra searches of one thread.
+     */
+    struct SearchBuffers;
+
+    /**
+     * Runs a Dijkstra search from (x, y) over the whole map and grows the boxes of the cell
+     * by every cell reached, in the directions of all the optimal first moves towards it.
+     */
+    void search_from(const Grid& grid, int x, int y, SearchBuffers& buffers);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "algorithms/grid.hpp"
+
+#include <algorithm>
+
+const std::array<uint8_t, 512> Grid::successor_table = []
+{
+    std::array<uint8_t, 512> table{};
+
+    // Relative positions of the directions in the order of the Direction::type values (N, NE, E, SE, S, SW, W, NW)
+    constexpr int movement[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+
+    for(uint32_t neighbourhood = 0; neighbourhood < 512; ++neighbourhood)
+    {
+        auto empty = [&](int dx, int dy) -> bool
+        {
+            return (neighbourhood >> ((dy + 1) * 3 + (dx + 1))) & 1;
+        };
+
+        uint8_t mask = 0;
+        for(int dir = 0; dir < 8; ++dir)
+        {
+            auto [dx, dy] = movement[dir];
+            bool straight = dx == 0 || dy == 0;
+            if(empty(dx, dy) && (straight || (empty(dx, 0) && empty(0, dy))))
+            {
+                mask |= 1 << dir;
+            }
+        }
+        table[neighbourhood] = mask;
+    }
+    return table;
+}();
+
+Grid::Grid(const State& state)
+{
+    build(state);
+}
+
+void Grid::build(const State& state, bool precompute_successors, bool with_columns)
+{
+    width = state.width;
+    height = state.height;
+    words_per_row = (width + 2 + 63) / 64;
+
+    // Everything, including the border and the extra words at both ends, starts out as a wall.
+    words.assign(words_per_row * (height + 2) + 2, 0);
+
+    for(int y = 0; y < height; ++y)
+    {
+        uint64_t* row = &words[1 + (y + 1) * words_per_row];
+        for(int x = 0; x < width; ++x)
+        {
+            if(state.map[y * width + x] != Node::WALL)
+            {
+                size_t bit = x + 1;
+                row[bit >> 6] |= uint64_t{1} << (bit & 63);
+            }
+        }
+    }
+
+    column_words.clear();
+    if(with_columns)
+    {
+        words_per_column = (height + 2 + 63) / 64;
+        column_words.assign(words_per_column * (width + 2) + 2, 0);
+        for(int x = 0; x < width; ++x)
+        {
+            uint64_t* column = &column_words[1 + (x + 1) * words_per_column];
+            for(int y = 0; y < height; ++y)
+            {
+                if(state.map[y * width + x] != Node::WALL)
+                {
+                    size_t bit = y + 1;
+                    column[bit >> 6] |= uint64_t{1} << (bit & 63);
+                }
+            }
+        }
+    }
+
+    successor_masks.clear();
+    if(precompute_successors)
+    {
+        successor_masks.resize(width * height);
+        for(int y = 0; y < height; ++y)
+        {
+            for(int x = 0; x < width; ++x)
+            {
+                successor_masks[y * width + x] = compute_successors(x, y);
+            }
+        }
+    }
+
+    source = &state;
+    source_revision = state.revision;
+    generation++;
+}
+
+bool Grid::update(const State& state, bool precompute_successors, bool with_columns)
+{
+    if(source == &state
+    && source_revision == state.revision
+    && width == state.width
+    && height == state.height
+    && precompute_successors == !successor_masks.empty()
+    && (!with_columns || !column_words.empty()))
+    {
+        return false;
+    }
+
+    build(state, precompute_successors, with_columns);
+    return true;
+}
+
+bool Grid::update_cell(const State& state, int x, int y)
+{
+    if(source != &state
+    || source_revision + 1 != state.revision
+    || width != state.width
+    || height != state.height)
+    {
+        return false;
+    }
+
+    bool empty = state.map[y * width + x] != Node::WALL;
+    auto set_bit = [empty](uint64_t* line, size_t bit)
+    {
+        uint64_t mask = uint64_t{1} << (bit & 63);
+        line[bit >> 6] = empty ? line[bit >> 6] | mask : line[bit >> 6] & ~mask;
+    };
+
+    set_bit(&words[1 + (y + 1) * words_per_row], x + 1);
+    if(!column_words.empty())
+        set_bit(&column_words[1 + (x + 1) * words_per_column], y + 1);
+
+    if(!successor_masks.empty())
+    {
+        for(int ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1); ++ny)
+        {
+            for(int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); ++nx)
+                successor_masks[ny * width + nx] = compute_successors(nx, ny);
+        }
+    }
+
+    source_revision = state.revision;
+    generation++;
+    return true;
+}
\ No newline at end of file
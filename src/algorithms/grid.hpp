@@ -0,0 +1,213 @@
+#ifndef GRID_HPP
+#define GRID_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "state.hpp"
+
+/**
+ * A compact, read-only representation of the walls of a State map for the hot path of the searches.
+ *
+ * Each cell takes a single bit: 1 for an empty cell, 0 for a wall.
+ * The map is surrounded by a border of walls one cell thick, so all the coordinates from -1 to width (or height)
+ * can be queried. Because of this, the neighbours of any cell within the map can be checked without bounds checks.
+ *
+ * Each row (including the border) starts at a new 64-bit word, so a row can also be scanned a word at a time.
+ * The rows are surrounded by one extra word of walls at both ends of the storage, so that any 64 consecutive cells
+ * of a row can be read without bounds checks (see row_from() and row_until()).
+ * Optionally, a transposed copy of the bits is kept as well, so that columns can be read in the same way.
+ *
+ * The grid is built once from a State and only rebuilt when the walls of the state change,
+ * i.e. when the State::revision is incremented (see update()). The walls of the map are not read again otherwise,
+ * so whoever edits them has to increment the revision. Another map copied or assigned into the state gets a new revision
+ * by itself.
+ *
+ * Optionally, the valid moves (successors) of every cell can be precomputed into an 8-bit mask per cell
+ * (see successors()). This trades 1 byte per cell for a single lookup per expansion.
+ */
+class Grid
+{
+public:
+    Grid() {}
+    explicit Grid(const State& state);
+
+    /**
+     * Builds the grid from the walls of the state.
+     *
+     * @param precompute_successors Whether to also precompute the successor mask of every cell.
+     * @param with_columns Whether to also build the transposed bits for column_from() and column_until().
+     */
+    void build(const State& state, bool precompute_successors = false, bool with_columns = false);
+
+    /**
+     * Rebuilds the grid if it has not been built from this state and revision yet.
+     * Columns built earlier are kept even if with_columns is false.
+     *
+     * @returns Whether the grid was rebuilt.
+     */
+    bool update(const State& state, bool precompute_successors = false, bool with_columns = false);
+
+    /**
+     * Updates the grid after the walls of a single cell (x, y) of the state changed,
+     * when the grid was built from the state before the change and the State::revision was incremented once since then.
+     * Only the bits of the cell and the successor masks of its neighbours are updated.
+     *
+     * @returns Whether the grid was updated. If not, the next update() rebuilds it.
+     */
+    bool update_cell(const State& state, int x, int y);
+
+    /**
+     * Is the specified node an empty point, i.e. not a wall?
+     * Valid for -1 <= x <= width, -1 <= y <= height.
+     */
+    inline bool is_empty(int x, int y) const
+    {
+        size_t bit = x + 1;
+        return (words[1 + (y + 1) * words_per_row + (bit >> 6)] >> (bit & 63)) & 1;
+    }
+
+    /**
+     * Is the specified node a wall?
+     * Valid for -1 <= x <= width, -1 <= y <= height. The border is always a wall.
+     */
+    inline bool is_wall(int x, int y) const
+    {
+        return !is_empty(x, y);
+    }
+
+    /**
+     * Gets 64 cells of row y starting from column x: bit i is 1 if (x + i, y) is empty.
+     * Valid for -1 <= x <= width, -1 <= y <= height.
+     * The cells past the border are unspecified, but the border itself is always read as a wall.
+     */
+    inline uint64_t row_from(int x, int y) const
+    {
+        return line_bits(words, words_per_row, y + 1, x + 1);
+    }
+
+    /**
+     * Gets 64 cells of row y ending at column x: bit 63 - i is 1 if (x - i, y) is empty.
+     * Valid like row_from().
+     */
+    inline uint64_t row_until(int x, int y) const
+    {
+        return line_bits(words, words_per_row, y + 1, x + 1 - 63);
+    }
+
+    /**
+     * Gets 64 cells of column x starting from row y: bit i is 1 if (x, y + i) is empty.
+     * Valid like row_from(), only if the grid was built with columns.
+     */
+    inline uint64_t column_from(int x, int y) const
+    {
+        return line_bits(column_words, words_per_column, x + 1, y + 1);
+    }
+
+    /**
+     * Gets 64 cells of column x ending at row y: bit 63 - i is 1 if (x, y - i) is empty.
+     * Valid like column_from().
+     */
+    inline uint64_t column_until(int x, int y) const
+    {
+        return line_bits(column_words, words_per_column, x + 1, y + 1 - 63);
+    }
+
+    /**
+     * Gets the valid moves from the node (x, y) as an 8-bit mask.
+     * Bit i is set if the move towards directions[i] is valid (see Util::is_move_valid()).
+     * (x, y) must be within the map.
+     */
+    inline uint8_t successors(int x, int y) const
+    {
+        if(!successor_masks.empty())
+            return successor_masks[y * width + x];
+        return compute_successors(x, y);
+    }
+
+    /**
+     * Computes the successor mask of the node (x, y) from the walls around it, without the precomputed masks.
+     * The 3x3 neighbourhood of the node is read as a 9-bit pattern, which is mapped to the mask with a lookup table.
+     */
+    inline uint8_t compute_successors(int x, int y) const
+    {
+        // In the padded coordinates the neighbourhood starts from column x and row y.
+        uint32_t neighbourhood =
+              three_bits(y,     x)
+            | three_bits(y + 1, x) << 3
+            | three_bits(y + 2, x) << 6;
+        return successor_table[neighbourhood];
+    }
+
+    /**
+     * Gets the amount of times the grid was built or updated. Data derived from the walls of the grid
+     * is up to date while the generation stays the same (see PreprocessedKey).
+     */
+    uint32_t get_generation() const
+    {
+        return generation;
+    }
+
+    /**
+     * Gets the amount of memory used by the grid in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return (words.capacity() + column_words.capacity()) * sizeof(uint64_t) + successor_masks.capacity();
+    }
+
+    int width = 0;
+    int height = 0;
+
+private:
+    /**
+     * Reads the 3 consecutive bits starting from the specified bit of the specified (padded) row.
+     */
+    inline uint32_t three_bits(size_t row, size_t bit) const
+    {
+        const uint64_t* word = &words[1 + row * words_per_row + (bit >> 6)];
+        uint32_t shift = bit & 63;
+        uint64_t value = word[0] >> shift;
+        if(shift > 61)
+            value |= word[1] << (64 - shift);
+        return value & 7;
+    }
+
+    /**
+     * Reads the 64 consecutive bits starting from the specified bit of the specified (padded) line of the bits.
+     * The bit may be negative or extend past the line, in which case the neighbouring lines (or the extra words at the ends) are read.
+     */
+    static inline uint64_t line_bits(const std::vector<uint64_t>& bits, size_t words_per_line, size_t line, ptrdiff_t bit)
+    {
+        size_t position = (1 + line * words_per_line) * 64 + bit;
+        const uint64_t* word = &bits[position >> 6];
+        uint32_t shift = position & 63;
+        // Shifted in two steps, as shifting by 64 when shift is 0 would be undefined.
+        return word[0] >> shift | (word[1] << 1) << (63 - shift);
+    }
+
+    /**
+     * Maps a 9-bit 3x3 neighbourhood (bit 0 = top left, bit 8 = bottom right, 1 = empty) into a successor mask.
+     * Corner cutting rules are applied: diagonal moves require both of their component directions to be empty.
+     */
+    static const std::array<uint8_t, 512> successor_table;
+
+    std::vector<uint64_t> words;
+    size_t words_per_row = 0;
+
+    // The transposed bits: each column of the padded grid starts at a new word
+    std::vector<uint64_t> column_words;
+    size_t words_per_column = 0;
+
+    std::vector<uint8_t> successor_masks;
+
+    // The state and its revision the grid was last built from
+    const State* source = nullptr;
+    uint64_t source_revision = 0;
+
+    uint32_t generation = 0;
+};
+
+#endif
\ No newline at end of file
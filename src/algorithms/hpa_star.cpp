@@ -0,0 +1,279 @@
+#include "algorithms/hpa_star.hpp"
+#include "state.hpp"
+
+#include <algorithm>
+
+template<typename Policy>
+void HierarchicalAStar<Policy>::init(State* s)
+{
+    grid.update(*s, Policy::precompute_successors);
+    graph.update(*s, grid, cluster_size);
+
+    Base::init(s);
+    waypoints.clear();
+
+    uint32_t node_count = graph.get_node_count();
+    begin_node = node_count;
+    end_node = node_count + 1;
+    end_cluster = graph.get_cluster(s->end.x, s->end.y);
+
+    // The edges from the beginning to the nodes of its cluster, and straight to the end if it is in the same cluster
+    cluster_search.run(graph, grid, s->begin.x, s->begin.y);
+    begin_edges.clear();
+    auto [first, last] = graph.get_cluster_nodes(graph.get_cluster(s->begin.x, s->begin.y));
+    for(uint32_t node = first; node < last; ++node)
+    {
+        Point cell = graph.get_cell(node);
+        ClusterGraph::distance_t distance = cluster_search.get_distance(cell.x, cell.y);
+        if(distance != ClusterGraph::UNREACHABLE)
+            begin_edges.push_back({node, distance});
+    }
+    if(graph.get_cluster(s->begin.x, s->begin.y) == end_cluster)
+    {
+        ClusterGraph::distance_t distance = cluster_search.get_distance(s->end.x, s->end.y);
+        if(distance != ClusterGraph::UNREACHABLE)
+            begin_edges.push_back({end_node, distance});
+    }
+
+    // The moves are symmetric, so the distances from the end are also the distances into it.
+    cluster_search.run(graph, grid, s->end.x, s->end.y);
+    end_edges.clear();
+    std::tie(first, last) = graph.get_cluster_nodes(end_cluster);
+    for(uint32_t node = first; node < last; ++node)
+    {
+        Point cell = graph.get_cell(node);
+        ClusterGraph::distance_t distance = cluster_search.get_distance(cell.x, cell.y);
+        if(distance != ClusterGraph::UNREACHABLE)
+            end_edges.push_back({node, distance});
+    }
+
+    abstract_nodes.begin_run(node_count + 2, {s, s->revision});
+    abstract_open.init(node_count + 2);
+    abstract_nodes.touch(begin_node).distance = 0;
+    abstract_nodes.parent(begin_node) = NULL_NODE_IDX;
+    abstract_open.push(OctileIntegerCost<>::heuristic(s->begin.x, s->begin.y, s->end.x, s->end.y), begin_node);
+}
+
+template<typename Policy>
+Algorithm::Result::Type HierarchicalAStar<Policy>::update()
+{
+    // Skip the stale entries of already examined nodes, like in AStar.
+    uint32_t node;
+    do
+    {
+        if(abstract_open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        node = abstract_open.top().second;
+        abstract_open.pop();
+    }
+    while(abstract_nodes[node].status() == AbstractNode::Status::EXAMINED);
+
+    if(node == end_node)
+    {
+        for(uint32_t idx = end_node; idx != NULL_NODE_IDX; idx = abstract_nodes.parent(idx))
+            waypoints.push_back(get_cell(idx));
+        std::reverse(waypoints.begin(), waypoints.end());
+
+        if(lazy_refinement)
+        {
+            result.path.assign(waypoints.begin() + 1, waypoints.end());
+            for(auto point : result.path)
+                Observer::path(*state, layout.map_index(layout.flatten(point.x, point.y)));
+        }
+        else
+        {
+            for(size_t i = 0; i + 1 < waypoints.size(); ++i)
+                refine_segment(i, result.path);
+        }
+
+        result.length = OctileIntegerCost<>::to_float(abstract_nodes[end_node].distance);
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    auto& abstract_node = abstract_nodes[node];
+    abstract_node.set_status(AbstractNode::Status::EXAMINED);
+    result.expanded++;
+    // Copied, as relaxing may move the node (see node_store.hpp)
+    ClusterGraph::distance_t distance = abstract_node.distance;
+
+    Point cell = get_cell(node);
+    Observer::expanded(*state, layout.map_index(layout.flatten(cell.x, cell.y)));
+
+    if(node == begin_node)
+    {
+        for(auto [to, cost] : begin_edges)
+            relax(node, to, distance + cost);
+    }
+    else
+    {
+        auto [first, last] = graph.get_edges(node);
+        for(auto edge = first; edge != last; ++edge)
+            relax(node, edge->to, distance + edge->cost);
+
+        if(graph.get_cluster(cell.x, cell.y) == end_cluster)
+        {
+            for(auto [from, cost] : end_edges)
+            {
+                if(from == node)
+                    relax(node, end_node, distance + cost);
+            }
+        }
+    }
+
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void HierarchicalAStar<Policy>::relax(uint32_t prev, uint32_t node, int32_t distance)
+{
+    result.examined++;
+
+    auto& abstract_node = abstract_nodes.touch(node);
+    if(distance >= abstract_node.distance)
+        return;
+
+    abstract_node.distance = distance;
+    abstract_nodes.parent(node) = prev;
+
+    Point cell = get_cell(node);
+    Observer::examined(*state, layout.map_index(layout.flatten(cell.x, cell.y)));
+    abstract_open.push(distance + OctileIntegerCost<>::heuristic(cell.x, cell.y, state->end.x, state->end.y), node);
+}
+
+template<typename Policy>
+Point HierarchicalAStar<Policy>::get_cell(uint32_t node) const
+{
+    if(node == begin_node)
+        return state->begin;
+    if(node == end_node)
+        return state->end;
+    return graph.get_cell(node);
+}
+
+template<typename Policy>
+bool HierarchicalAStar<Policy>::refine_segment(size_t i, std::vector<Point>& cells)
+{
+    if(i + 1 >= waypoints.size())
+        return false;
+
+    Point a = waypoints[i];
+    Point b = waypoints[i + 1];
+    if(a == b)
+        return true;
+
+    // The nodes of different clusters are only connected by a move across the border.
+    if(graph.get_cluster(a.x, a.y) != graph.get_cluster(b.x, b.y))
+    {
+        cells.push_back(b);
+        Observer::path(*state, layout.map_index(layout.flatten(b.x, b.y)));
+        return true;
+    }
+
+    return refine_in_cluster(a, b, cells);
+}
+
+template<typename Policy>
+bool HierarchicalAStar<Policy>::refine_in_cluster(Point a, Point b, std::vector<Point>& cells)
+{
+    auto bounds = graph.get_bounds(graph.get_cluster(a.x, a.y));
+
+    nodes.begin_run(layout.size(), {state, state->revision});
+    open.init(layout.size());
+
+    auto start_index = layout.flatten(a.x, a.y);
+    auto end_index = layout.flatten(b.x, b.y);
+    nodes.touch(start_index).distance = 0;
+    nodes.parent(start_index) = NULL_NODE_IDX;
+    open.push(Cost::heuristic(a.x, a.y, b.x, b.y), start_index);
+
+    while(!open.empty())
+    {
+        node_index node_idx = open.top().second;
+        open.pop();
+
+        auto& node = nodes[node_idx];
+        if(node.status() == InternalNode::Status::EXAMINED)
+            continue;
+
+        if(node_idx == end_index)
+        {
+            size_t first = cells.size();
+            for(node_index idx = end_index; idx != start_index; idx = nodes.parent(idx))
+            {
+                auto [x, y] = layout.expand(idx);
+                cells.push_back({x, y});
+                Observer::path(*state, layout.map_index(idx));
+            }
+            std::reverse(cells.begin() + first, cells.end());
+            return true;
+        }
+
+        node.set_status(InternalNode::Status::EXAMINED);
+        // Copied, as touching the neighbours may move the node (see node_store.hpp)
+        distance_t node_distance = node.distance;
+
+        auto [x, y] = layout.expand(node_idx);
+        const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+        for(int i = 0; i < successors.amount; ++i)
+        {
+            dir_t dir = directions[successors.directions[i]];
+            int neighbour_x = x + dir->movement.first;
+            int neighbour_y = y + dir->movement.second;
+            if(!bounds.contains(neighbour_x, neighbour_y))
+                continue;
+
+            auto neighbour_idx = layout.flatten(neighbour_x, neighbour_y);
+            auto& neighbour = nodes.touch(neighbour_idx);
+            distance_t distance = node_distance + Cost::move(dir);
+            if(distance < neighbour.distance)
+            {
+                neighbour.distance = distance;
+                nodes.parent(neighbour_idx) = node_idx;
+                open.push(distance + Cost::heuristic(neighbour_x, neighbour_y, b.x, b.y), neighbour_idx);
+            }
+        }
+    }
+
+    return false;
+}
+
+template<typename Policy>
+size_t HierarchicalAStar<Policy>::get_memory_usage()
+{
+    return Base::get_memory_usage()
+        + get_preprocessed_memory_usage()
+        + abstract_nodes.get_memory_usage()
+        + abstract_open.get_memory_usage();
+}
+
+template<typename Policy>
+double HierarchicalAStar<Policy>::get_preprocessing_time()
+{
+    return graph.get_build_time();
+}
+
+template<typename Policy>
+size_t HierarchicalAStar<Policy>::get_preprocessed_memory_usage()
+{
+    return graph.get_memory_usage();
+}
+
+template<typename Policy>
+bool HierarchicalAStar<Policy>::save_preprocessed(std::ostream& out)
+{
+    return graph.save(out);
+}
+
+template<typename Policy>
+bool HierarchicalAStar<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return graph.load(s, cluster_size, in);
+}
+
+template class HierarchicalAStar<HeadlessPolicy>;
+template class HierarchicalAStar<VisualPolicy>;
\ No newline at end of file
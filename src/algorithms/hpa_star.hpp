@@ -0,0 +1,127 @@
+#ifndef HPA_STAR_HPP
+#define HPA_STAR_HPP
+
+#include <vector>
+
+#include "algorithms/common.hpp"
+#include "algorithms/cluster_graph.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Hierarchical Path-Finding A* (HPA*), as described in Botea et al., 2004 ("Near Optimal Hierarchical Path-Finding").
+ *
+ * The map is preprocessed into a ClusterGraph: the entrances between fixed-size clusters, connected by the lengths of
+ * the shortest paths between them inside each cluster. A query
+ *  1. connects the beginning and the end to the nodes of their clusters with a Dijkstra search inside the cluster
+ *  2. searches the abstract graph with A*, one expanded node per update()
+ *  3. refines each edge of the abstract path into cells: a move across a border, or an A* search inside one cluster
+ * The work of the first and last steps only depends on the cluster size, and the abstract graph has far fewer nodes
+ * than the map, so the latency grows slowly with the size of the map.
+ *
+ * The paths are not always optimal: they can only cross the borders of the clusters at the entrance nodes.
+ * The length of the result is the exact length of the returned path.
+ *
+ * With lazy refinement, the search returns as soon as the abstract path is found: the path of the result then only holds
+ * the waypoints of the abstract path (without the beginning, with the end), and each segment between two waypoints
+ * can be refined into cells later with refine_segment(), e.g. only once a unit is about to walk along it.
+ */
+template<typename Policy = HeadlessPolicy>
+class HierarchicalAStar : public CommonAlgorithm<Policy>
+{
+public:
+    /**
+     * @param cluster_size The width and height of the clusters in cells.
+     * @param lazy_refinement Whether to return the waypoints of the abstract path instead of refining it.
+     */
+    explicit HierarchicalAStar(int cluster_size = 16, bool lazy_refinement = false)
+        : cluster_size(cluster_size), lazy_refinement(lazy_refinement)
+    {
+    }
+
+    void init(State* state);
+    Algorithm::Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+
+    /**
+     * Gets the waypoints of the abstract path of the last successful search, from the beginning to the end.
+     */
+    const std::vector<Point>& get_waypoints() const
+    {
+        return waypoints;
+    }
+
+    /**
+     * Refines the segment of the abstract path from get_waypoints()[i] to get_waypoints()[i + 1] into cells,
+     * and appends them to cells without the first waypoint, with the second.
+     *
+     * @returns Whether the segment was refined. False if i is not a segment of the last path.
+     */
+    bool refine_segment(size_t i, std::vector<Point>& cells);
+
+    const ClusterGraph& get_graph() const
+    {
+        return graph;
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open;
+
+    /**
+     * The nodes of the abstract search, with distances in the units of OctileIntegerCost.
+     */
+    struct AbstractNode : SearchNode<ClusterGraph::distance_t, typename Policy::Stamp>
+    {
+        enum Status : uint8_t
+        {
+            UNEXAMINED,
+            EXAMINED
+        };
+    };
+
+    int cluster_size;
+    bool lazy_refinement;
+
+    ClusterGraph graph;
+    ClusterGraph::ClusterSearch cluster_search;
+
+    /**
+     * The abstract search. The beginning and the end are the nodes after the nodes of the graph.
+     */
+    typename Policy::template NodeStore<AbstractNode> abstract_nodes;
+    typename Policy::template OpenList<ClusterGraph::distance_t> abstract_open;
+    uint32_t begin_node = 0;
+    uint32_t end_node = 0;
+
+    // The edges from the beginning, and the edges from the nodes of the cluster of the end into the end
+    std::vector<ClusterGraph::Edge> begin_edges;
+    std::vector<ClusterGraph::Edge> end_edges;
+    int end_cluster = 0;
+
+    std::vector<Point> waypoints;
+
+    /**
+     * Gets the cell of a node of the abstract search.
+     */
+    Point get_cell(uint32_t node) const;
+
+    /**
+     * Updates the distance and parent of the abstract node and adds it to the open list if the distance is lower.
+     */
+    void relax(uint32_t prev, uint32_t node, int32_t distance);
+
+    /**
+     * Finds the path from a to b with an A* search inside their cluster and appends it to cells, without a.
+     */
+    bool refine_in_cluster(Point a, Point b, std::vector<Point>& cells);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "algorithms/hub_label_search.hpp"
+#include "algorithms/cost.hpp"
+
+template<typename Policy>
+void HubLabelSearch<Policy>::init(State* s)
+{
+    state = s;
+    grid.update(*s);
+    labels.update(*s, grid);
+
+    result = Algorithm::Result{};
+}
+
+template<typename Policy>
+Algorithm::Result::Type HubLabelSearch<Policy>::update()
+{
+    HubLabels::distance_t distance = labels.distance(state->begin, state->end);
+    if(distance == HubLabels::UNREACHABLE)
+    {
+        result.expanded = 1;
+        result.type = Result::Type::FAILURE;
+        return Result::Type::FAILURE;
+    }
+
+    if(with_path)
+    {
+        result.expanded = labels.unpack(grid, state->begin, state->end, result.path);
+        for(Point cell : result.path)
+            Observer::path(*state, cell.y * state->width + cell.x);
+    }
+    else
+    {
+        result.expanded = 1;
+    }
+
+    result.length = OctileIntegerCost<>::to_float(distance);
+    result.type = Result::Type::SUCCESS;
+    return Result::Type::SUCCESS;
+}
+
+template<typename Policy>
+size_t HubLabelSearch<Policy>::get_memory_usage()
+{
+    return grid.get_memory_usage() + get_preprocessed_memory_usage();
+}
+
+template<typename Policy>
+double HubLabelSearch<Policy>::get_preprocessing_time()
+{
+    return labels.get_build_time();
+}
+
+template<typename Policy>
+size_t HubLabelSearch<Policy>::get_preprocessed_memory_usage()
+{
+    return labels.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> HubLabelSearch<Policy>::get_preprocessed_statistics()
+{
+    return {
+        {"cells", labels.get_cell_count()},
+        {"entries", labels.get_entry_count()},
+        {"average_label_size", labels.get_cell_count() == 0 ? 0.0 : (double)labels.get_entry_count() / labels.get_cell_count()},
+        {"max_label_size", labels.get_max_label_size()},
+        {"distance_query_ns", labels.get_query_time()}
+    };
+}
+
+template<typename Policy>
+bool HubLabelSearch<Policy>::save_preprocessed(std::ostream& out)
+{
+    return labels.save(out);
+}
+
+template<typename Policy>
+bool HubLabelSearch<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return labels.load(s, in);
+}
+
+template class HubLabelSearch<HeadlessPolicy>;
+template class HubLabelSearch<VisualPolicy>;
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef HUB_LABEL_SEARCH_HPP
+#define HUB_LABEL_SEARCH_HPP
+
+#include <vector>
+
+#include "algorithms/algorithm.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/hub_labels.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Path queries answered from a hub labeling of the map (see hub_labels.hpp).
+ *
+ * The distance between the beginning and the end is found by intersecting their labels, without any search.
+ * Without with_path, the query ends there and the result has the length but no path, for callers that only need the distance.
+ * Otherwise the path is unpacked one move at a time with a distance query per neighbour (see HubLabels::unpack()),
+ * and every distance query is counted as an expansion.
+ *
+ * Building the labels takes seconds on medium maps. The results are optimal.
+ */
+template<typename Policy = HeadlessPolicy>
+class HubLabelSearch : public Algorithm
+{
+public:
+    /**
+     * @param with_path Whether to unpack the path, or only find the distance.
+     */
+    explicit HubLabelSearch(bool with_path = true) : with_path(with_path)
+    {
+    }
+
+    void init(State* state);
+    Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+
+    const HubLabels& get_labels() const
+    {
+        return labels;
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+
+    bool with_path;
+
+    Grid grid;
+    HubLabels labels;
+};
+
+#endif
\ No newline at end of file
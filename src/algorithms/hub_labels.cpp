@@ -0,0 +1,345 @@
+#include "algorithms/hub_labels.hpp"
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/radix_heap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * The header of the saved labels after the common header (see PreprocessedKey).
+ */
+struct HubLabelsHeader
+{
+    uint32_t entry_count;
+};
+
+static constexpr char HUB_LABELS_MAGIC[4] = {'H', 'U', 'B', 'L'};
+static constexpr uint32_t HUB_LABELS_VERSION = 3;
+
+bool HubLabels::update(const State& s, const Grid& grid)
+{
+    build_time = 0;
+    if(key.is_current(s, grid))
+        return false;
+
+    build(s, grid);
+    return true;
+}
+
+void HubLabels::build(const State& s, const Grid& grid)
+{
+    using Cost = OctileIntegerCost<>;
+
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    size_t map_size = size_t(key.width) * key.height;
+
+    // The hubs in the order of the hierarchy, most important (highest rank) first
+    ContractionHierarchy hierarchy;
+    hierarchy.build(s, grid);
+    uint32_t hub_count = hierarchy.get_node_count();
+    std::vector<uint32_t> hub_cells(hub_count);
+    for(uint32_t hub = 0; hub < hub_count; ++hub)
+    {
+        Point cell = hierarchy.get_cell(hub_count - 1 - hub);
+        hub_cells[hub] = cell.y * key.width + cell.x;
+    }
+
+    std::vector<std::vector<std::pair<uint32_t, distance_t>>> labels(map_size);
+
+    // The distances of the current hub to the hubs of its own label, by hub
+    std::vector<distance_t> hub_distances(hub_count, UNREACHABLE);
+
+    std::vector<distance_t> search_distances(map_size, UNREACHABLE);
+    std::vector<uint32_t> reached;
+    RadixHeap<distance_t> open;
+
+    for(uint32_t hub = 0; hub < hub_count; ++hub)
+    {
+        uint32_t hub_cell = hub_cells[hub];
+        for(auto [other, distance] : labels[hub_cell])
+            hub_distances[other] = distance;
+
+        search_distances[hub_cell] = 0;
+        reached.push_back(hub_cell);
+        open.init(0);
+        open.push(0, hub_cell);
+
+        while(!open.empty())
+        {
+            auto [distance, cell] = open.top();
+            open.pop();
+            if(distance > search_distances[cell])
+                continue;
+
+            // Pruned: the labels built so far already give the distance, through a more important hub.
+            bool covered = false;
+            for(auto [other, other_distance] : labels[cell])
+            {
+                if(hub_distances[other] != UNREACHABLE && hub_distances[other] + other_distance <= distance)
+                {
+                    covered = true;
+                    break;
+                }
+            }
+            if(covered)
+                continue;
+
+            labels[cell].push_back({hub, distance});
+
+            int x = cell % key.width;
+            int y = cell / key.width;
+            const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+            for(int i = 0; i < successors.amount; ++i)
+            {
+                dir_t dir = directions[successors.directions[i]];
+                uint32_t neighbour = (y + dir->movement.second) * key.width + x + dir->movement.first;
+                distance_t new_distance = distance + Cost::move(dir);
+                if(new_distance < search_distances[neighbour])
+                {
+                    if(search_distances[neighbour] == UNREACHABLE)
+                        reached.push_back(neighbour);
+                    search_distances[neighbour] = new_distance;
+                    open.push(new_distance, neighbour);
+                }
+            }
+        }
+
+        for(uint32_t cell : reached)
+            search_distances[cell] = UNREACHABLE;
+        reached.clear();
+        for(auto [other, distance] : labels[hub_cell])
+            hub_distances[other] = UNREACHABLE;
+    }
+
+    label_offsets.assign(map_size + 1, 0);
+    hubs.clear();
+    distances.clear();
+    for(size_t cell = 0; cell < map_size; ++cell)
+    {
+        for(auto [hub, distance] : labels[cell])
+        {
+            hubs.push_back(hub);
+            distances.push_back(distance);
+        }
+        std::vector<std::pair<uint32_t, distance_t>>().swap(labels[cell]);
+        label_offsets[cell + 1] = hubs.size();
+    }
+    hubs.shrink_to_fit();
+    distances.shrink_to_fit();
+    count_labels();
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    measure_query_time();
+}
+
+HubLabels::distance_t HubLabels::distance(uint32_t a, uint32_t b) const
+{
+    assert(a + 1 < label_offsets.size() && b + 1 < label_offsets.size());
+
+    const uint32_t* hubs_a = hubs.data() + label_offsets[a];
+    const uint32_t* hubs_b = hubs.data() + label_offsets[b];
+    const distance_t* distances_a = distances.data() + label_offsets[a];
+    const distance_t* distances_b = distances.data() + label_offsets[b];
+    uint32_t size_a = label_offsets[a + 1] - label_offsets[a];
+    uint32_t size_b = label_offsets[b + 1] - label_offsets[b];
+
+    distance_t best = UNREACHABLE;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+#ifdef __SSE2__
+    // Blocks of 4 hubs are compared against each other in all 4 rotations of the second block.
+    // Most blocks share no hubs, and the distances are only added up for the ones that do.
+    // The block with the smaller last hub cannot share hubs with the later blocks of the other label, so it is skipped,
+    // and both blocks are skipped if their last hubs are equal.
+    while(i + 4 <= size_a && j + 4 <= size_b)
+    {
+        __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hubs_a + i));
+        __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hubs_b + j));
+        __m128i shared = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(block_a, block_b), _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+        // Bit k is set if hub i + k is shared: its position in the other block is found by a short scan.
+        for(int mask = _mm_movemask_ps(_mm_castsi128_ps(shared)); mask != 0; mask &= mask - 1)
+        {
+            uint32_t k = i + std::countr_zero(unsigned(mask));
+            uint32_t l = j;
+            while(hubs_b[l] != hubs_a[k])
+                l++;
+            best = std::min(best, distances_a[k] + distances_b[l]);
+        }
+
+        uint32_t last_a = hubs_a[i + 3];
+        uint32_t last_b = hubs_b[j + 3];
+        i += last_a <= last_b ? 4 : 0;
+        j += last_b <= last_a ? 4 : 0;
+    }
+#endif
+
+    // The rest of the labels (or all of them without SSE2) are merged one hub at a time.
+    while(i < size_a && j < size_b)
+    {
+        if(hubs_a[i] == hubs_b[j])
+        {
+            best = std::min(best, distances_a[i] + distances_b[j]);
+            i++;
+            j++;
+        }
+        else if(hubs_a[i] < hubs_b[j])
+        {
+            i++;
+        }
+        else
+        {
+            j++;
+        }
+    }
+    return best;
+}
+
+size_t HubLabels::unpack(const Grid& grid, Point a, Point b, std::vector<Point>& cells) const
+{
+    using Cost = OctileIntegerCost<>;
+
+    uint32_t target = b.y * key.width + b.x;
+    distance_t remaining = distance(a, b);
+    size_t queries = 1;
+    if(remaining == UNREACHABLE)
+        return 0;
+
+    Point cell = a;
+    while(remaining > 0)
+    {
+        // The moves are tried starting from the one towards b, which usually is on a shortest path,
+        // and then alternating to its sides. The distances are exact, so some move is always on a shortest path.
+        int towards = 0;
+        for(int i = 0; i < 8; ++i)
+        {
+            if(directions[i]->movement.first == (b.x > cell.x) - (b.x < cell.x)
+            && directions[i]->movement.second == (b.y > cell.y) - (b.y < cell.y))
+                towards = i;
+        }
+
+        uint8_t successors = grid.successors(cell.x, cell.y);
+        for(int k = 0; k < 8; ++k)
+        {
+            int i = (towards + (k % 2 == 0 ? k / 2 : 8 - (k + 1) / 2)) % 8;
+            if(!(successors & (1 << i)))
+                continue;
+
+            dir_t dir = directions[i];
+            Point neighbour{cell.x + dir->movement.first, cell.y + dir->movement.second};
+            distance_t neighbour_distance = distance(neighbour.y * key.width + neighbour.x, target);
+            queries++;
+            if(neighbour_distance != UNREACHABLE && neighbour_distance + Cost::move(dir) == remaining)
+            {
+                cell = neighbour;
+                remaining = neighbour_distance;
+                break;
+            }
+        }
+        cells.push_back(cell);
+    }
+    return queries;
+}
+
+void HubLabels::count_labels()
+{
+    cell_count = 0;
+    max_label_size = 0;
+    for(size_t cell = 0; cell + 1 < label_offsets.size(); ++cell)
+    {
+        uint32_t size = get_label_size(cell);
+        cell_count += size > 0;
+        max_label_size = std::max(max_label_size, size);
+    }
+}
+
+void HubLabels::measure_query_time()
+{
+    std::vector<uint32_t> empty_cells;
+    for(uint32_t cell = 0; cell + 1 < label_offsets.size(); ++cell)
+    {
+        if(get_label_size(cell) > 0)
+            empty_cells.push_back(cell);
+    }
+    if(empty_cells.empty())
+    {
+        query_time = 0;
+        return;
+    }
+
+    std::mt19937 random(empty_cells.size());
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(QUERY_SAMPLES);
+    for(auto& [a, b] : pairs)
+    {
+        a = empty_cells[random() % empty_cells.size()];
+        b = empty_cells[random() % empty_cells.size()];
+    }
+
+    // The distances are summed so that the queries are not optimized away.
+    auto start = std::chrono::steady_clock::now();
+    uint32_t checksum = 0;
+    for(auto [a, b] : pairs)
+        checksum += distance(a, b);
+    auto end = std::chrono::steady_clock::now();
+
+    query_time = checksum == std::numeric_limits<uint32_t>::max() ? 0
+        : std::chrono::duration<double, std::nano>(end - start).count() / pairs.size();
+}
+
+bool HubLabels::save(std::ostream& out) const
+{
+    if(!key.write(out, HUB_LABELS_MAGIC, HUB_LABELS_VERSION))
+        return false;
+
+    HubLabelsHeader header{uint32_t(hubs.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(label_offsets.data()), label_offsets.size() * sizeof(label_offsets[0]));
+    out.write(reinterpret_cast<const char*>(hubs.data()), hubs.size() * sizeof(hubs[0]));
+    out.write(reinterpret_cast<const char*>(distances.data()), distances.size() * sizeof(distances[0]));
+    return out.good();
+}
+
+bool HubLabels::load(const State& s, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, HUB_LABELS_MAGIC, HUB_LABELS_VERSION))
+        return false;
+
+    HubLabelsHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good())
+        return false;
+
+    std::vector<uint32_t> loaded_offsets(size_t(s.width) * s.height + 1);
+    std::vector<uint32_t> loaded_hubs(header.entry_count);
+    std::vector<distance_t> loaded_distances(header.entry_count);
+    in.read(reinterpret_cast<char*>(loaded_offsets.data()), loaded_offsets.size() * sizeof(loaded_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_hubs.data()), loaded_hubs.size() * sizeof(loaded_hubs[0]));
+    in.read(reinterpret_cast<char*>(loaded_distances.data()), loaded_distances.size() * sizeof(loaded_distances[0]));
+    if(!in.good() || loaded_offsets.back() != header.entry_count)
+        return false;
+
+    label_offsets = std::move(loaded_offsets);
+    hubs = std::move(loaded_hubs);
+    distances = std::move(loaded_distances);
+    count_labels();
+
+    key = loaded_key;
+    build_time = 0;
+    measure_query_time();
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#ifndef HUB_LABELS_HPP
+#define HUB_LABELS_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+
+/**
+ * A hub labeling of the grid graph: a distance oracle built with pruned landmark labeling,
+ * as described in Akiba et al., 2013 ("Fast Exact Shortest-Path Distance Queries on Large Networks by Pruned Landmark Labeling").
+ *
+ * Every empty cell gets a label: a list of hubs (other cells) with the distances to them, such that for every pair of cells
+ * connected by a path, some hub on a shortest path between them is in both labels. The distance between two cells
+ * is then the smallest sum of the distances to a hub they share, found by intersecting the two labels without any search.
+ *
+ * The labels are built with one Dijkstra search per hub, in the order of importance. A search does not continue from a cell
+ * whose distance the labels built so far already give, so the later, less important hubs only reach the cells around them.
+ * The order is the order of a contraction hierarchy of the map (see contraction_hierarchy.hpp), most important first,
+ * which puts the cells that many shortest paths pass through, like doorways and the corners of walls, first.
+ *
+ * The hubs of each label are sorted by their order, and the hubs and the distances are stored in separate arrays,
+ * so that the labels are intersected 4 hubs at a time with SSE2 where available. The labels take 12 bytes per entry,
+ * and on open areas a label has up to a few hundred entries: the oracle is meant for small and medium maps.
+ * The distances are in the units and the type of OctileIntegerCost, so they are exact and do not overflow.
+ */
+class HubLabels
+{
+public:
+    using distance_t = OctileIntegerCost<>::distance_t;
+
+    static constexpr distance_t UNREACHABLE = std::numeric_limits<distance_t>::max();
+
+    /**
+     * The amount of random queries timed for get_query_time().
+     */
+    static constexpr int QUERY_SAMPLES = 10000;
+
+    /**
+     * Builds the labels of the state, unless they are already up to date (the same state, revision and size).
+     * The grid must be up to date.
+     *
+     * @returns Whether the labels were built.
+     */
+    bool update(const State& state, const Grid& grid);
+
+    /**
+     * Builds the labels of the state. The grid must be up to date.
+     */
+    void build(const State& state, const Grid& grid);
+
+    /**
+     * Gets the distance between the cells a and b (by map index) in the units of OctileIntegerCost,
+     * or UNREACHABLE if there is no path. Walls have empty labels, so they are unreachable.
+     */
+    distance_t distance(uint32_t a, uint32_t b) const;
+
+    distance_t distance(Point a, Point b) const
+    {
+        assert(a.x >= 0 && a.x < key.width && a.y >= 0 && a.y < key.height);
+        assert(b.x >= 0 && b.x < key.width && b.y >= 0 && b.y < key.height);
+        return distance(a.y * key.width + a.x, b.y * key.width + b.x);
+    }
+
+    /**
+     * Appends the cells of a shortest path from a to b into cells, without a. The grid must be up to date.
+     * The labels only hold distances, so the path is unpacked one move at a time:
+     * from each cell, a move is taken to a neighbour whose distance to b is shorter by the cost of the move.
+     *
+     * @returns The amount of distance queries made, or 0 if b cannot be reached from a.
+     */
+    size_t unpack(const Grid& grid, Point a, Point b, std::vector<Point>& cells) const;
+
+    /**
+     * Gets the amount of entries in the label of the cell (by map index).
+     */
+    uint32_t get_label_size(uint32_t cell) const
+    {
+        return label_offsets[cell + 1] - label_offsets[cell];
+    }
+
+    /**
+     * Gets the label of the cell (by map index): the hubs, numbered by their order of importance, and the distances to them.
+     */
+    std::pair<std::span<const uint32_t>, std::span<const distance_t>> get_label(uint32_t cell) const
+    {
+        return {{hubs.data() + label_offsets[cell], get_label_size(cell)}, {distances.data() + label_offsets[cell], get_label_size(cell)}};
+    }
+
+    /**
+     * Gets the amount of entries in all the labels.
+     */
+    size_t get_entry_count() const
+    {
+        return hubs.size();
+    }
+
+    /**
+     * Gets the amount of labelled cells, i.e. the empty cells.
+     */
+    size_t get_cell_count() const
+    {
+        return cell_count;
+    }
+
+    /**
+     * Gets the amount of entries in the largest label.
+     */
+    uint32_t get_max_label_size() const
+    {
+        return max_label_size;
+    }
+
+    /**
+     * Gets the average time (in nanoseconds) of a distance() query between random cells, measured after building or loading.
+     */
+    double get_query_time() const
+    {
+        return query_time;
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the labels during the last update(), or 0 if they were up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the labels in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return label_offsets.capacity() * sizeof(label_offsets[0])
+            + hubs.capacity() * sizeof(hubs[0])
+            + distances.capacity() * sizeof(distances[0]);
+    }
+
+    /**
+     * Writes the labels into the stream.
+     *
+     * @returns Whether the labels were written. False if they have not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads labels written by save(), so that the next update() with the state does not build them again.
+     *
+     * @returns Whether the labels were loaded. False if the data is invalid or was made for another map.
+     */
+    bool load(const State& state, std::istream& in);
+
+private:
+    // The label of cell i (by map index) is hubs[label_offsets[i]] to hubs[label_offsets[i + 1] - 1],
+    // with the distances to the hubs at the same positions of distances.
+    // The hubs are numbered by their order of importance, so each label is sorted by it.
+    std::vector<uint32_t> label_offsets;
+    std::vector<uint32_t> hubs;
+    std::vector<distance_t> distances;
+
+    size_t cell_count = 0;
+    uint32_t max_label_size = 0;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+    double query_time = 0;
+
+    /**
+     * Counts the labelled cells and the largest label.
+     */
+    void count_labels();
+
+    /**
+     * Times QUERY_SAMPLES queries between random cells into query_time.
+     */
+    void measure_query_time();
+};
+
+#endif
\ No newline at end of file
@@ -2,146 +2,227 @@
 #include "state.hpp"
 
 #include <utility>
-#include <iostream>
-
-/**
- * A matrix of relative positions.
- * The positions are used to determine whether a node has forced neigbours.
- * The index into the array is a Direction.type.
- * Only defined for straight directions, as only they can have forced neigbours.
- * 
- * Usage:
- * The node pair for each direction is a {WALL, EMPTY} pair.
- * If the WALL direction is a wall, and the EMPTY direction is empty, the node has a forced neighbour.
- */
-static std::pair<dir_t, dir_t> const forced[][2] =
-{
-    {{DIR_SOUTHWEST, DIR_WEST}, {DIR_SOUTHEAST, DIR_EAST}},
-    {},
-    {{DIR_NORTHWEST, DIR_NORTH}, {DIR_SOUTHWEST, DIR_SOUTH}},
-    {},
-    {{DIR_NORTHWEST, DIR_WEST}, {DIR_NORTHEAST, DIR_EAST}},
-    {},
-    {{DIR_NORTHEAST, DIR_NORTH}, {DIR_SOUTHEAST, DIR_SOUTH}},
-    {}
-};
-
-Algorithm::Result::Type JumpPointSearch::update()
+
+template<typename Policy>
+Algorithm::Result::Type JumpPointSearch<Policy>::update()
 {
-    if(open.empty())
+    // Skip the stale entries of already examined nodes.
+    // Only open lists with duplicates (see open_list.hpp) leave them behind.
+    // The end node is never marked as examined.
+    node_index node_idx;
+    do
     {
-        result.type = Result::Type::FAILURE;
-        return Result::Type::FAILURE;
-    }
+        if(open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
 
-    auto [approx_dist, node_idx] = open.top();
-    open.pop();
+        node_idx = open.top().second;
+        open.pop();
+    }
+    while(nodes[node_idx].status() == InternalNode::Status::EXAMINED);
 
-    auto [x, y] = Util::expand(state->width, node_idx);
+    auto [x, y] = layout.expand(node_idx);
     auto& node = nodes[node_idx];
 
     if(x == state->end.x && y == state->end.y)
     {
-        Util::build_path<InternalNode>(*state, &nodes[0], result);
-        result.length = node.distance;
+        // Without deferred jumps every cell of the path is a node, which build_jump_path() handles like any other jump.
+        Util::build_jump_path<Observer>(*state, layout, nodes.parents(), result);
+        result.length = Cost::to_float(node.distance);
         result.type = Result::Type::SUCCESS;
         return Result::Type::SUCCESS;
     }
 
-    if(node.status == InternalNode::Status::EXAMINED)
-    {
-        // Skip this node by calling the update()-function again
-        return update();
-    }
-
-    node.status = InternalNode::Status::EXAMINED;
+    node.set_status(InternalNode::Status::EXAMINED);
     result.expanded++;
+    // Copied, as jumping may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
 
-    // Is the current node the first node? If not, set it to EXPANDED
-    if(node.prev != NULL_NODE_IDX)
-    {
-        state->map[node_idx] = Node::EXPANDED_1;
-    }
+    Observer::expanded(*state, layout.map_index(node_idx));
 
-    std::pair<node_index, dir_t> neighbours[8];
-    auto amount_neighbours = Util::get_neighbours(neighbours, *state, x, y);
-
-    for(int i = 0; i < amount_neighbours; ++i)
+    // The cells recorded by the jumps without deferral prune the redundant jumps, so they can jump in every direction.
+    uint8_t jump_directions = Policy::deferred_jumps ? canonical_directions(node_idx, x, y) : grid.successors(x, y);
+    const SuccessorList& successors = successor_lists[jump_directions];
+    for(int i = 0; i < successors.amount; ++i)
     {
-        auto neighbour_idx = neighbours[i].first;
-        auto dir = neighbours[i].second;
+        auto dir = directions[successors.directions[i]];
+        if constexpr(Policy::goal_bounding)
+        {
+            if(!bounds.contains(x, y, dir, state->end.x, state->end.y))
+                continue;
+        }
 
-        jump(node_idx, dir, node.distance);
+        if constexpr(!Policy::deferred_jumps)
+            jump(node_idx, dir, node_distance);
+        else if(dir->straight)
+            jump_straight(node_idx, x, y, dir, node_distance);
+        else
+            jump_diagonal(node_idx, x, y, dir, node_distance);
     }
 
     return Result::Type::EXECUTING;
 }
 
-void JumpPointSearch::jump(node_index prev, dir_t dir, float distance)
+template<typename Policy>
+void JumpPointSearch<Policy>::jump(node_index prev, dir_t dir, distance_t distance)
 {
-    result.examined++;
-
-    auto [old_x, old_y] = Util::expand(state->width, prev);
-
-    int x = old_x + dir->movement.first;
-    int y = old_y + dir->movement.second;
-    auto node_idx = Util::flatten(state->width, x, y);
-    auto& node = nodes[node_idx];
-    Util::lazy_initialize(curr_run_id, node);
+    auto [x, y] = layout.expand(prev);
+    auto [dx, dy] = dir->movement;
 
-    distance += dir->straight ? 1.0f : SQRT_2;
-    if(distance >= node.distance)
+    while(true)
     {
-        return;
-    }
+        result.examined++;
 
-    node.distance = distance;
-    node.prev = prev;
-    node.status == InternalNode::Status::UNEXAMINED;
+        x += dx;
+        y += dy;
+        auto node_idx = layout.flatten(x, y);
+        auto& node = nodes.touch(node_idx);
 
+        distance += Cost::move(dir);
+        if(distance >= node.distance)
+            return;
 
-    // A lambda function to add the current node to the open queue
-    auto add_to_open = [&]()
-    {
-        float approx_distance = node.distance + Util::diagonal_distance(x, y, state->end.x, state->end.y);
-        open.emplace(approx_distance, node_idx);
-    };
+        node.distance = distance;
+        nodes.parent(node_idx) = prev;
 
-    if(x == state->end.x && y == state->end.y)
-    {
-        open.emplace(0.0f, node_idx);
-        return;
-    }
+        if(x == state->end.x && y == state->end.y)
+        {
+            open.push(0, node_idx);
+            return;
+        }
 
-    state->map[node_idx] = Node::EXAMINED_1;
+        Observer::examined(*state, layout.map_index(node_idx));
 
-    if(dir->straight)
-    {
-        // Check for forced neigbours
-        for(auto [wall_dir, empty_dir] : forced[dir->type])
+        if(dir->straight)
         {
-            auto wall_x = x + wall_dir->movement.first;
-            auto wall_y = y + wall_dir->movement.second;
-            auto empty_x = x + empty_dir->movement.first;
-            auto empty_y = y + empty_dir->movement.second;
-            if(Util::is_wall(*state, wall_x, wall_y)
-            && Util::is_empty(*state, empty_x, empty_y))
+            if(Util::has_forced_neighbour(grid, x, y, dir))
             {
-                // Forced neighbour found
-                add_to_open();
+                open.push(distance + heuristic(x, y, state->end.x, state->end.y), node_idx);
                 return;
             }
         }
-    } else
+        else
+        {
+            // The components are straight, so this goes at most one call deep.
+            for(dir_t component : {dir->components.first, dir->components.second})
+            {
+                if(Util::is_move_valid(grid, x, y, component))
+                    jump(node_idx, component, distance);
+            }
+        }
+
+        // Keep jumping in this direction
+        if(!Util::is_move_valid(grid, x, y, dir))
+            return;
+        prev = node_idx;
+    }
+}
+
+template<typename Policy>
+void JumpPointSearch<Policy>::jump_straight(node_index prev, int x, int y, dir_t dir, distance_t distance)
+{
+    int steps = scan(x, y, dir);
+    if(steps == 0)
+        return;
+
+    auto [dx, dy] = dir->movement;
+    reach(prev, x + dx * steps, y + dy * steps, distance + Cost::move(dir) * steps);
+}
+
+template<typename Policy>
+void JumpPointSearch<Policy>::jump_diagonal(node_index prev, int x, int y, dir_t dir, distance_t distance)
+{
+    auto [dx, dy] = dir->movement;
+    for(int steps = 1; Util::is_move_valid(grid, x, y, dir); ++steps)
     {
-        for(dir_t component : {dir->components.first, dir->components.second})
+        x += dx;
+        y += dy;
+        result.examined++;
+
+        if(x == state->end.x && y == state->end.y)
         {
-            if(Util::is_move_valid(*state, x, y, component))
-                jump(node_idx, component, distance);
+            reach(prev, x, y, distance + Cost::move(dir) * steps);
+            return;
         }
+
+        dir_t first = dir->components.first;
+        dir_t second = dir->components.second;
+        int first_steps = scan(x, y, first);
+        int second_steps = scan(x, y, second);
+        if(first_steps == 0 && second_steps == 0)
+            continue;
+
+        // A turning point: stored as a node for the jump points of the components to point to,
+        // and expanded right away by continuing the diagonal from it.
+        // Turning points are not added to the open list, unless a straight jump reaches them.
+        auto node_idx = layout.flatten(x, y);
+        auto& node = nodes.touch(node_idx);
+        distance += Cost::move(dir) * steps;
+        if(distance >= node.distance)
+            return;
+
+        node.distance = distance;
+        nodes.parent(node_idx) = prev;
+        Observer::examined(*state, layout.map_index(node_idx));
+
+        if(first_steps != 0)
+            reach(node_idx, x + first->movement.first * first_steps, y + first->movement.second * first_steps, distance + Cost::move(first) * first_steps);
+        if(second_steps != 0)
+            reach(node_idx, x + second->movement.first * second_steps, y + second->movement.second * second_steps, distance + Cost::move(second) * second_steps);
+
+        prev = node_idx;
+        steps = 0;
+    }
+}
+
+template<typename Policy>
+int JumpPointSearch<Policy>::scan(int x, int y, dir_t dir)
+{
+    auto [dx, dy] = dir->movement;
+    for(int steps = 1; grid.is_empty(x + dx, y + dy); ++steps)
+    {
+        x += dx;
+        y += dy;
+        result.examined++;
+
+        if((x == state->end.x && y == state->end.y) || Util::has_forced_neighbour(grid, x, y, dir))
+            return steps;
+    }
+    return 0;
+}
+
+template<typename Policy>
+void JumpPointSearch<Policy>::reach(node_index prev, int x, int y, distance_t distance)
+{
+    auto node_idx = layout.flatten(x, y);
+    auto& node = nodes.touch(node_idx);
+    if(distance >= node.distance)
+        return;
+
+    node.distance = distance;
+    nodes.parent(node_idx) = prev;
+
+    if(x == state->end.x && y == state->end.y)
+    {
+        open.push(0, node_idx);
+        return;
     }
 
-    // Keep jumping in this direction
-    if(Util::is_move_valid(*state, x, y, dir))
-        jump(node_idx, dir, distance);
-}
\ No newline at end of file
+    Observer::examined(*state, layout.map_index(node_idx));
+    open.push(distance + heuristic(x, y, state->end.x, state->end.y), node_idx);
+}
+
+template class JumpPointSearch<HeadlessPolicy>;
+template class JumpPointSearch<VisualPolicy>;
+template class JumpPointSearch<PowerOfTwoStride<HeadlessPolicy>>;
+template class JumpPointSearch<IntegerCost<HeadlessPolicy>>;
+template class JumpPointSearch<IndexedOpenList<HeadlessPolicy>>;
+template class JumpPointSearch<HashedNodes<HeadlessPolicy>>;
+template class JumpPointSearch<GoalBounding<HeadlessPolicy>>;
+template class JumpPointSearch<GoalBounding<VisualPolicy>>;
+template class JumpPointSearch<DifferentialHeuristic<HeadlessPolicy>>;
+template class JumpPointSearch<DeferredJumps<HeadlessPolicy>>;
+template class JumpPointSearch<DeferredJumps<VisualPolicy>>;
+template class JumpPointSearch<DeferredJumps<HashedNodes<HeadlessPolicy>>>;
\ No newline at end of file
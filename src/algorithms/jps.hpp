@@ -4,23 +4,80 @@
 #include <queue>
 
 #include "algorithms/common.hpp"
+#include "algorithms/policies.hpp"
 
-class JumpPointSearch : public CommonAlgorithm
+/**
+ * Jump Point Search, based on Harabor and Grastien, 2011 ("Online Graph Pruning for Pathfinding on Grid Maps").
+ *
+ * By default, the jumps record every cell they pass as a node, with its distance and parent.
+ * A jump stops at a cell that has already been reached with a lower distance,
+ * which prunes the redundant jumps well enough for every expanded node to jump in all directions.
+ *
+ * With Policy::deferred_jumps, the jumps only read the grid and node records are only touched for the jump points:
+ *  -each expanded node only jumps in its canonical directions (see Util::canonical_successors())
+ *  -a straight jump scans cell by cell until it finds the end, a cell with a forced neighbour (a jump point) or a wall
+ *  -a diagonal jump scans both of its components from every cell it passes. A cell where one of them finds a jump point
+ *   is a turning point: it is stored as a node, the jump points found become its successors and the diagonal continues from it.
+ * The cells in between are filled in when the path is built (see Util::build_jump_path()).
+ * The scans cannot stop early at cells reached before, so they read more cells, but the search touches far fewer nodes.
+ * This pays off on maps with large open areas, especially with sparse node stores (see HashedNodeStore),
+ * but on maps with many scattered single-cell obstacles the repeated scans make it slower.
+ *
+ * Both variants jump with loops and no allocations: the only call inside a jump is a diagonal jump
+ * calling the straight jumps of its components.
+ */
+template<typename Policy = HeadlessPolicy>
+class JumpPointSearch : public CommonAlgorithm<Policy>
 {
 public:
     Algorithm::Result::Type update();
 
 private:
-    
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open, Base::bounds, Base::canonical_directions, Base::heuristic;
+
     /**
-     * The "jump" function as defined in Harabor and Grastien, 2011 ("Online Graph Pruning for Pathfinding on Grid Maps"),
-     * with some modifications.
-     * 
-     * @param node The node from which to jump forward
+     * The "jump" function as defined in Harabor and Grastien, 2011, recording every cell passed as a node.
+     * Used without Policy::deferred_jumps.
+     *
+     * @param prev The node from which to jump forward
      * @param dir The direction of the jump
      * @param distance The distance from the beginning so far
      */
-    void jump(node_index node, dir_t dir, float distance);
+    void jump(node_index prev, dir_t dir, distance_t distance);
+
+    /**
+     * Jumps from (x, y) in a straight direction and adds the jump point found, if any, to the open list.
+     *
+     * @param prev The node index of (x, y)
+     * @param dir The direction of the jump, must be straight
+     * @param distance The distance of (x, y) from the beginning
+     */
+    void jump_straight(node_index prev, int x, int y, dir_t dir, distance_t distance);
+
+    /**
+     * Jumps from (x, y) in a diagonal direction and adds the jump points found from its turning points to the open list.
+     *
+     * @param prev The node index of (x, y)
+     * @param dir The direction of the jump, must be diagonal
+     * @param distance The distance of (x, y) from the beginning
+     */
+    void jump_diagonal(node_index prev, int x, int y, dir_t dir, distance_t distance);
+
+    /**
+     * Scans from (x, y) in a straight direction for the next jump point: the end node or a node with a forced neighbour.
+     *
+     * @returns The amount of steps to the jump point, or 0 if a wall is reached first.
+     */
+    int scan(int x, int y, dir_t dir);
+
+    /**
+     * Updates the jump point (x, y), reached from prev, with the distance and adds it to the open list if the distance is lower.
+     */
+    void reach(node_index prev, int x, int y, distance_t distance);
 };
 
 #endif
\ No newline at end of file
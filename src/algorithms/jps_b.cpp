@@ -0,0 +1,217 @@
+#include "algorithms/jps_b.hpp"
+#include "state.hpp"
+
+#include <bit>
+#include <utility>
+
+/**
+ * Finds the cells with a forced neighbour on one side of a straight jump, given the cells on that side:
+ * a cell has a forced neighbour if the side cell next to it is empty, but the side cell behind that is a wall.
+ *
+ * For a jump towards higher coordinates, bit i of the side cells is i steps ahead (see Grid::row_from()).
+ * For a jump towards lower coordinates, bit 63 - i is i steps ahead (see Grid::row_until()).
+ */
+static inline uint64_t forced_ahead(uint64_t side)
+{
+    return side & ~(side << 1);
+}
+
+static inline uint64_t forced_behind(uint64_t side)
+{
+    return side & ~(side >> 1);
+}
+
+template<typename Policy>
+void BlockJumpPointSearch<Policy>::init(State* s)
+{
+    // Built with the columns first, so that the update in CommonAlgorithm::init() keeps them.
+    grid.update(*s, Policy::precompute_successors, true);
+    Base::init(s);
+}
+
+template<typename Policy>
+Algorithm::Result::Type BlockJumpPointSearch<Policy>::update()
+{
+    // Skip the stale entries of already examined nodes, like in JumpPointSearch.
+    node_index node_idx;
+    do
+    {
+        if(open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        node_idx = open.top().second;
+        open.pop();
+    }
+    while(nodes[node_idx].status() == InternalNode::Status::EXAMINED);
+
+    auto [x, y] = layout.expand(node_idx);
+    auto& node = nodes[node_idx];
+
+    if(x == state->end.x && y == state->end.y)
+    {
+        Util::build_jump_path<Observer>(*state, layout, nodes.parents(), result);
+        result.length = Cost::to_float(node.distance);
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    node.set_status(InternalNode::Status::EXAMINED);
+    result.expanded++;
+    // Copied, as jumping may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
+
+    Observer::expanded(*state, layout.map_index(node_idx));
+
+    std::pair<node_index, dir_t> neighbours[8];
+    auto amount_neighbours = Util::get_neighbours(neighbours, grid, layout, x, y);
+
+    for(int i = 0; i < amount_neighbours; ++i)
+    {
+        auto dir = neighbours[i].second;
+        if(dir->straight)
+            jump_straight(node_idx, x, y, dir, node_distance);
+        else
+            jump_diagonal(node_idx, x, y, dir, node_distance);
+    }
+
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void BlockJumpPointSearch<Policy>::jump_straight(node_index prev, int x, int y, dir_t dir, distance_t distance)
+{
+    result.examined++;
+
+    int steps = scan(x, y, dir);
+    if(steps == 0)
+        return;
+
+    x += dir->movement.first * steps;
+    y += dir->movement.second * steps;
+    distance += Cost::move(dir) * steps;
+
+    auto node_idx = layout.flatten(x, y);
+    auto& node = nodes.touch(node_idx);
+    if(distance >= node.distance)
+        return;
+
+    node.distance = distance;
+    nodes.parent(node_idx) = prev;
+
+    if(x == state->end.x && y == state->end.y)
+    {
+        open.push(0, node_idx);
+        return;
+    }
+
+    Observer::examined(*state, layout.map_index(node_idx));
+    open.push(distance + Cost::heuristic(x, y, state->end.x, state->end.y), node_idx);
+}
+
+template<typename Policy>
+void BlockJumpPointSearch<Policy>::jump_diagonal(node_index prev, int x, int y, dir_t dir, distance_t distance)
+{
+    while(true)
+    {
+        result.examined++;
+
+        x += dir->movement.first;
+        y += dir->movement.second;
+        distance += Cost::move(dir);
+
+        auto node_idx = layout.flatten(x, y);
+        auto& node = nodes.touch(node_idx);
+        if(distance >= node.distance)
+            return;
+
+        node.distance = distance;
+        nodes.parent(node_idx) = prev;
+
+        if(x == state->end.x && y == state->end.y)
+        {
+            open.push(0, node_idx);
+            return;
+        }
+
+        Observer::examined(*state, layout.map_index(node_idx));
+
+        jump_straight(node_idx, x, y, dir->components.first, distance);
+        jump_straight(node_idx, x, y, dir->components.second, distance);
+
+        if(!Util::is_move_valid(grid, x, y, dir))
+            return;
+        prev = node_idx;
+    }
+}
+
+template<typename Policy>
+int BlockJumpPointSearch<Policy>::scan(int x, int y, dir_t dir) const
+{
+    auto [dx, dy] = dir->movement;
+    bool ahead = dx + dy > 0;
+
+    // The amount of steps to the end node, if it is on this line ahead of (x, y)
+    int to_end = 0;
+    int end_dx = state->end.x - x;
+    int end_dy = state->end.y - y;
+    if(dx == 0 ? end_dx == 0 && end_dy * dy > 0 : end_dy == 0 && end_dx * dx > 0)
+        to_end = end_dx * dx + end_dy * dy;
+
+    // Each block of 64 cells overlaps the previous one by a cell,
+    // as the forced neighbours of a cell depend on the side cell behind it.
+    for(int steps = 0;; steps += 63)
+    {
+        uint64_t line, side_1, side_2;
+        switch(dir->type)
+        {
+        case Direction::EAST:
+            line   = grid.row_from(x + steps, y);
+            side_1 = grid.row_from(x + steps, y - 1);
+            side_2 = grid.row_from(x + steps, y + 1);
+            break;
+        case Direction::WEST:
+            line   = grid.row_until(x - steps, y);
+            side_1 = grid.row_until(x - steps, y - 1);
+            side_2 = grid.row_until(x - steps, y + 1);
+            break;
+        case Direction::SOUTH:
+            line   = grid.column_from(x, y + steps);
+            side_1 = grid.column_from(x - 1, y + steps);
+            side_2 = grid.column_from(x + 1, y + steps);
+            break;
+        default:
+            line   = grid.column_until(x, y - steps);
+            side_1 = grid.column_until(x - 1, y - steps);
+            side_2 = grid.column_until(x + 1, y - steps);
+            break;
+        }
+
+        // The distances to the first wall and the first forced neighbour within the block.
+        // The first cell of the block is where the jump already is, so it is never a jump point.
+        int wall, jump;
+        if(ahead)
+        {
+            wall = std::countr_zero(~line);
+            jump = std::countr_zero((forced_ahead(side_1) | forced_ahead(side_2)) & ~uint64_t{1});
+        }
+        else
+        {
+            wall = std::countl_zero(~line);
+            jump = std::countl_zero((forced_behind(side_1) | forced_behind(side_2)) & ~(uint64_t{1} << 63));
+        }
+
+        if(to_end > steps && to_end - steps < wall && to_end - steps <= jump)
+            return to_end;
+        if(jump < wall)
+            return steps + jump;
+        if(wall < 64)
+            return 0;
+    }
+}
+
+template class BlockJumpPointSearch<HeadlessPolicy>;
+template class BlockJumpPointSearch<VisualPolicy>;
+template class BlockJumpPointSearch<IntegerCost<HeadlessPolicy>>;
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef JPS_B_HPP
+#define JPS_B_HPP
+
+#include "algorithms/common.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Block-based Jump Point Search (JPS-B), as described in Harabor and Grastien, 2014 ("Improving Jump Point Search").
+ *
+ * Finds the same jump points as JumpPointSearch, but the straight jumps read the walls of the grid
+ * 64 cells at a time (see Grid::row_from() and Grid::column_from()) instead of visiting every cell:
+ * the forced neighbours and the walls ahead are found with bit operations and count leading/trailing zeros.
+ * The vertical jumps read the transposed bits of the grid, so the grid also keeps its columns.
+ *
+ * Only the jump points and the cells of the diagonal jumps are stored as nodes,
+ * so the cells in between are filled in when the path is built (see Util::build_jump_path()).
+ */
+template<typename Policy = HeadlessPolicy>
+class BlockJumpPointSearch : public CommonAlgorithm<Policy>
+{
+public:
+    void init(State* state);
+    Algorithm::Result::Type update();
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open;
+
+    /**
+     * Jumps from (x, y) in a straight direction and adds the jump point found, if any, to the open list.
+     *
+     * @param prev The node index of (x, y)
+     * @param dir The direction of the jump, must be straight
+     * @param distance The distance of (x, y) from the beginning
+     */
+    void jump_straight(node_index prev, int x, int y, dir_t dir, distance_t distance);
+
+    /**
+     * Jumps from (x, y) in a diagonal direction, one cell at a time, doing the straight jumps of the components from every cell.
+     *
+     * @param prev The node index of (x, y)
+     * @param dir The direction of the jump, must be diagonal
+     * @param distance The distance of (x, y) from the beginning
+     */
+    void jump_diagonal(node_index prev, int x, int y, dir_t dir, distance_t distance);
+
+    /**
+     * Scans from (x, y) in a straight direction for the next jump point: the end node or a node with a forced neighbour.
+     *
+     * @returns The amount of steps to the jump point, or 0 if a wall is reached first.
+     */
+    int scan(int x, int y, dir_t dir) const;
+};
+
+#endif
\ No newline at end of file
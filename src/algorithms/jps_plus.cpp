@@ -0,0 +1,307 @@
+#include "algorithms/jps_plus.hpp"
+#include "state.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+static constexpr char JUMP_TABLE_MAGIC[4] = {'J', 'P', 'S', '+'};
+static constexpr uint32_t JUMP_TABLE_VERSION = 2;
+
+template<typename Policy>
+void JumpPointSearchPlus<Policy>::init(State* s)
+{
+    preprocessing_time = 0;
+    use_fallback = s->width > MAX_SIZE || s->height > MAX_SIZE;
+    if(use_fallback)
+    {
+        fallback.init(s);
+        return;
+    }
+
+    grid.update(*s, Policy::precompute_successors);
+    if(!key.is_current(*s, grid))
+    {
+        preprocess(*s);
+    }
+
+    Base::init(s);
+}
+
+template<typename Policy>
+void JumpPointSearchPlus<Policy>::preprocess(const State& s)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    int width = s.width;
+    int height = s.height;
+    jump_distances.assign(width * height, {});
+
+    // The straight directions first, as the diagonal jump points depend on them.
+    for(dir_t dir : {DIR_NORTH, DIR_EAST, DIR_SOUTH, DIR_WEST, DIR_NORTHEAST, DIR_SOUTHEAST, DIR_SOUTHWEST, DIR_NORTHWEST})
+    {
+        auto [dx, dy] = dir->movement;
+
+        // Sweep against the direction, so that the next cell in the direction is always computed first.
+        for(int i = 0; i < height; ++i)
+        {
+            int y = dy > 0 ? height - 1 - i : i;
+            for(int j = 0; j < width; ++j)
+            {
+                int x = dx > 0 ? width - 1 - j : j;
+                jump_distances[y * width + x][dir->type] = compute_jump_distance(x, y, dir);
+            }
+        }
+    }
+
+    preprocessing_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Policy>
+int16_t JumpPointSearchPlus<Policy>::compute_jump_distance(int x, int y, dir_t dir) const
+{
+    if(grid.is_wall(x, y) || !Util::is_move_valid(grid, x, y, dir))
+    {
+        // A wall right ahead
+        return 0;
+    }
+
+    auto [dx, dy] = dir->movement;
+    auto& next = jump_distances[(y + dy) * key.width + x + dx];
+    bool jump_point = dir->straight
+        ? Util::has_forced_neighbour(grid, x + dx, y + dy, dir)
+        : next[dir->components.first->type] > 0 || next[dir->components.second->type] > 0;
+
+    int16_t next_distance = next[dir->type];
+    return jump_point ? 1
+        : next_distance > 0 ? next_distance + 1
+        : next_distance - 1;
+}
+
+template<typename Policy>
+bool JumpPointSearchPlus<Policy>::update_preprocessed(const State& s, int x, int y)
+{
+    if(!key.precedes(s))
+        return false;
+
+    if(!grid.update_cell(s, x, y))
+        grid.update(s, Policy::precompute_successors);
+
+    // The walls of the cell are read by the entries of the cells up to 2 cells away: as the next cell,
+    // as a corner of a diagonal move, or as a wall or an empty cell next to a forced neighbour of the next cell.
+    // Each of them is repaired in the order of the sweep of preprocess().
+    auto repair_around = [&](dir_t dir, std::vector<Point>* changed)
+    {
+        auto [dx, dy] = dir->movement;
+        for(int i = 2; i >= -2; --i)
+        {
+            int ny = y + (dy > 0 ? i : -i);
+            for(int j = 2; j >= -2; --j)
+            {
+                int nx = x + (dx > 0 ? j : -j);
+                if(nx >= 0 && nx < key.width && ny >= 0 && ny < key.height)
+                    repair(nx, ny, dir, changed);
+            }
+        }
+    };
+
+    // The cells whose straight entries changed, by direction
+    std::array<std::vector<Point>, 8> changed;
+    for(dir_t dir : {DIR_NORTH, DIR_EAST, DIR_SOUTH, DIR_WEST})
+        repair_around(dir, &changed[dir->type]);
+
+    // A diagonal entry also depends on the straight entries of the next cell, so the cells
+    // right before the changed straight entries along the diagonals are repaired as well.
+    for(dir_t dir : {DIR_NORTHEAST, DIR_SOUTHEAST, DIR_SOUTHWEST, DIR_NORTHWEST})
+    {
+        repair_around(dir, nullptr);
+
+        auto [dx, dy] = dir->movement;
+        for(dir_t component : {dir->components.first, dir->components.second})
+        {
+            for(auto [cx, cy] : changed[component->type])
+            {
+                if(cx - dx >= 0 && cx - dx < key.width && cy - dy >= 0 && cy - dy < key.height)
+                    repair(cx - dx, cy - dy, dir, nullptr);
+            }
+        }
+    }
+
+    key.set_repaired(s, grid);
+    return true;
+}
+
+template<typename Policy>
+void JumpPointSearchPlus<Policy>::repair(int x, int y, dir_t dir, std::vector<Point>* changed)
+{
+    auto [dx, dy] = dir->movement;
+    for(; x >= 0 && x < key.width && y >= 0 && y < key.height; x -= dx, y -= dy)
+    {
+        int16_t distance = compute_jump_distance(x, y, dir);
+        int16_t& entry = jump_distances[y * key.width + x][dir->type];
+        if(distance == entry)
+            return;
+
+        entry = distance;
+        if(changed != nullptr)
+            changed->push_back({x, y});
+    }
+}
+
+template<typename Policy>
+Algorithm::Result::Type JumpPointSearchPlus<Policy>::update()
+{
+    if(use_fallback)
+        return fallback.update();
+
+    // Skip the stale entries of already examined nodes, like in JumpPointSearch.
+    node_index node_idx;
+    do
+    {
+        if(open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        node_idx = open.top().second;
+        open.pop();
+    }
+    while(nodes[node_idx].status() == InternalNode::Status::EXAMINED);
+
+    auto [x, y] = layout.expand(node_idx);
+    auto& node = nodes[node_idx];
+
+    if(x == state->end.x && y == state->end.y)
+    {
+        Util::build_jump_path<Observer>(*state, layout, nodes.parents(), result);
+        result.length = Cost::to_float(node.distance);
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    node.set_status(InternalNode::Status::EXAMINED);
+    result.expanded++;
+    // Copied, as reaching other nodes may move the node (see node_store.hpp)
+    distance_t node_distance = node.distance;
+
+    Observer::expanded(*state, layout.map_index(node_idx));
+
+    auto jumps = jump_distances[y * key.width + x];
+    int end_dx = state->end.x - x;
+    int end_dy = state->end.y - y;
+
+    const SuccessorList& successors = successor_lists[canonical_directions(node_idx, x, y)];
+    for(int i = 0; i < successors.amount; ++i)
+    {
+        auto dir = directions[successors.directions[i]];
+        auto [dx, dy] = dir->movement;
+        int jump = jumps[dir->type];
+        int reach_steps = std::abs(jump);
+
+        result.examined++;
+
+        // The steps along the direction to the end, or to the cell on the row or column of the end
+        int steps = 0;
+        if(dir->straight)
+        {
+            if(dx == 0 ? end_dx == 0 && end_dy * dy > 0 : end_dy == 0 && end_dx * dx > 0)
+                steps = end_dx * dx + end_dy * dy;
+        }
+        else if(end_dx * dx > 0 && end_dy * dy > 0)
+        {
+            steps = std::min(end_dx * dx, end_dy * dy);
+        }
+
+        if(steps == 0 || steps > reach_steps)
+        {
+            if(jump <= 0)
+                continue;
+            steps = jump;
+        }
+
+        reach(node_idx, x + dx * steps, y + dy * steps, node_distance + Cost::move(dir) * steps);
+    }
+
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void JumpPointSearchPlus<Policy>::reach(node_index prev, int x, int y, distance_t distance)
+{
+    auto node_idx = layout.flatten(x, y);
+    auto& node = nodes.touch(node_idx);
+    if(distance >= node.distance)
+        return;
+
+    node.distance = distance;
+    nodes.parent(node_idx) = prev;
+
+    if(x == state->end.x && y == state->end.y)
+    {
+        open.push(0, node_idx);
+        return;
+    }
+
+    Observer::examined(*state, layout.map_index(node_idx));
+    open.push(distance + Cost::heuristic(x, y, state->end.x, state->end.y), node_idx);
+}
+
+template<typename Policy>
+Algorithm::Result JumpPointSearchPlus<Policy>::get_result()
+{
+    return use_fallback ? fallback.get_result() : result;
+}
+
+template<typename Policy>
+size_t JumpPointSearchPlus<Policy>::get_memory_usage()
+{
+    return Base::get_memory_usage() + get_preprocessed_memory_usage() + fallback.get_memory_usage();
+}
+
+template<typename Policy>
+double JumpPointSearchPlus<Policy>::get_preprocessing_time()
+{
+    return preprocessing_time;
+}
+
+template<typename Policy>
+size_t JumpPointSearchPlus<Policy>::get_preprocessed_memory_usage()
+{
+    return jump_distances.capacity() * sizeof(jump_distances[0]);
+}
+
+template<typename Policy>
+bool JumpPointSearchPlus<Policy>::save_preprocessed(std::ostream& out)
+{
+    if(use_fallback || !key.write(out, JUMP_TABLE_MAGIC, JUMP_TABLE_VERSION))
+        return false;
+
+    out.write(reinterpret_cast<const char*>(jump_distances.data()), jump_distances.size() * sizeof(jump_distances[0]));
+    return out.good();
+}
+
+template<typename Policy>
+bool JumpPointSearchPlus<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    if(s.width > MAX_SIZE || s.height > MAX_SIZE)
+        return false;
+
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, JUMP_TABLE_MAGIC, JUMP_TABLE_VERSION))
+        return false;
+
+    std::vector<std::array<int16_t, 8>> loaded(s.width * s.height);
+    in.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(loaded[0]));
+    if(!in.good())
+        return false;
+
+    jump_distances = std::move(loaded);
+    key = loaded_key;
+    return true;
+}
+
+template class JumpPointSearchPlus<HeadlessPolicy>;
+template class JumpPointSearchPlus<VisualPolicy>;
+template class JumpPointSearchPlus<IntegerCost<HeadlessPolicy>>;
\ No newline at end of file
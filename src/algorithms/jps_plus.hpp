@@ -0,0 +1,108 @@
+#ifndef JPS_PLUS_HPP
+#define JPS_PLUS_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/common.hpp"
+#include "algorithms/jps.hpp"
+#include "algorithms/policies.hpp"
+#include "algorithms/preprocessed_key.hpp"
+
+/**
+ * JPS+, as described in Rabin and Silva, 2015 ("JPS+: An Extreme A* Speed Optimization for Static Uniform Cost Grids").
+ *
+ * The jumps of JumpPointSearch only depend on the walls of the map, so JPS+ precomputes them:
+ * for every cell and each of the 8 directions, the jump distance table holds
+ *  -n > 0:     the next jump point is n steps away in the direction
+ *  -n <= 0:    there is no jump point in the direction, and the last cell before a wall is -n steps away
+ * A straight jump point is a cell with a forced neighbour (see forced[][]).
+ * A diagonal jump point is a cell from which a straight jump in one of the components of the direction finds a jump point.
+ *
+ * A query then only reads the distances of each expanded node in its canonical directions: the direction it was reached from
+ * (and its components, for diagonals) and the directions of its forced neighbours. The end node is found like in JPS+:
+ * if it lies within reach in a straight direction it is added directly, and if it lies within reach in the quadrant
+ * of a diagonal direction, the diagonal cell on the row or column of the end becomes a jump point.
+ *
+ * The tables take 16 bytes per cell. After a single cell changes, update_preprocessed() repairs only the entries that depend on it (see repair()).
+ * The distances are 16-bit, so the tables are only built for maps at most MAX_SIZE cells wide and high.
+ * Larger maps are searched with plain JumpPointSearch instead.
+ */
+template<typename Policy = HeadlessPolicy>
+class JumpPointSearchPlus : public CommonAlgorithm<Policy>
+{
+public:
+    /**
+     * The largest width and height of a map for which the jump distances fit in the tables.
+     */
+    static constexpr int MAX_SIZE = INT16_MAX;
+
+    void init(State* state);
+    Algorithm::Result::Type update();
+    Algorithm::Result get_result();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+    bool update_preprocessed(const State& state, int x, int y);
+
+    /**
+     * Gets the jump distance table entry of the cell (x, y) in the direction dir.
+     * Only valid after init() with a map of at most MAX_SIZE cells wide and high.
+     */
+    int16_t get_jump_distance(int x, int y, dir_t dir) const
+    {
+        return jump_distances[y * key.width + x][dir->type];
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+    using Base = CommonAlgorithm<Policy>;
+    using Result = Algorithm::Result;
+    using typename Base::Cost, typename Base::distance_t, typename Base::InternalNode;
+    using Base::state, Base::result, Base::nodes, Base::grid, Base::layout, Base::open, Base::canonical_directions;
+
+    /**
+     * The jump distances of every cell in the 8 directions, indexed like the State::map and the Direction::type values.
+     */
+    std::vector<std::array<int16_t, 8>> jump_distances;
+
+    PreprocessedKey key;
+
+    double preprocessing_time = 0;
+
+    /**
+     * Searches the maps that are too large for the tables.
+     */
+    JumpPointSearch<Policy> fallback;
+    bool use_fallback = false;
+
+    /**
+     * Computes the jump distance tables of the state. The grid must be up to date.
+     */
+    void preprocess(const State& state);
+
+    /**
+     * Computes the jump distance of the cell (x, y) in the direction dir from the table entries of the next cell in the direction.
+     */
+    int16_t compute_jump_distance(int x, int y, dir_t dir) const;
+
+    /**
+     * Recomputes the entries in the direction dir starting from the cell (x, y) and going against the direction,
+     * for as long as they change. Each entry only depends on the entry of the next cell and the walls around the cell,
+     * so the entries behind an unchanged one stay valid.
+     *
+     * @param changed Receives the cells whose entries changed, if not null.
+     */
+    void repair(int x, int y, dir_t dir, std::vector<Point>* changed);
+
+    /**
+     * Updates the node (x, y), reached from prev, with the distance and adds it to the open list if the distance is lower.
+     */
+    void reach(node_index prev, int x, int y, distance_t distance);
+};
+
+#endif
\ No newline at end of file
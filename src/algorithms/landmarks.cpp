@@ -0,0 +1,261 @@
+#include "algorithms/landmarks.hpp"
+#include "algorithms/radix_heap.hpp"
+
+#include <chrono>
+
+/**
+ * The header of the saved landmarks after the common header (see PreprocessedKey).
+ */
+struct LandmarksHeader
+{
+    int32_t count;
+    int32_t requested;
+};
+
+static constexpr char LANDMARKS_MAGIC[4] = {'L', 'M', 'R', 'K'};
+static constexpr uint32_t LANDMARKS_VERSION = 2;
+
+using distance_t = OctileIntegerCost<>::distance_t;
+
+static constexpr distance_t NO_DISTANCE = std::numeric_limits<distance_t>::max();
+static constexpr uint32_t NO_COMPONENT = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Runs a Dijkstra search from the cell over the whole map into distances, in the units of OctileIntegerCost.
+ * The cells that cannot be reached get NO_DISTANCE.
+ */
+static void search_from(const Grid& grid, int width, uint32_t cell, std::vector<distance_t>& distances, RadixHeap<distance_t>& open)
+{
+    using Cost = OctileIntegerCost<>;
+
+    std::fill(distances.begin(), distances.end(), NO_DISTANCE);
+    distances[cell] = 0;
+    open.init(0);
+    open.push(0, cell);
+
+    while(!open.empty())
+    {
+        auto [distance, current] = open.top();
+        open.pop();
+        if(distance > distances[current])
+            continue;
+
+        int x = current % width;
+        int y = current / width;
+        const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+        for(int i = 0; i < successors.amount; ++i)
+        {
+            dir_t dir = directions[successors.directions[i]];
+            uint32_t neighbour = (y + dir->movement.second) * width + x + dir->movement.first;
+            distance_t new_distance = distance + Cost::move(dir);
+            if(new_distance < distances[neighbour])
+            {
+                distances[neighbour] = new_distance;
+                open.push(new_distance, neighbour);
+            }
+        }
+    }
+}
+
+bool Landmarks::update(const State& s, const Grid& grid, int new_count)
+{
+    build_time = 0;
+    if(key.is_current(s, grid) && requested == new_count)
+        return false;
+
+    build(s, grid, new_count);
+    return true;
+}
+
+void Landmarks::build(const State& s, const Grid& grid, int new_count)
+{
+    using Cost = OctileIntegerCost<>;
+
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    requested = new_count;
+    cells.clear();
+    scales.clear();
+    size_t cell_count = size_t(key.width) * key.height;
+
+    std::vector<distance_t> search_distances(cell_count);
+    RadixHeap<distance_t> open;
+
+    // The connected components of the empty cells and their sizes
+    std::vector<uint32_t> components(cell_count, NO_COMPONENT);
+    std::vector<uint32_t> component_sizes;
+    std::vector<uint32_t> stack;
+    for(uint32_t root = 0; root < cell_count; ++root)
+    {
+        if(s.map[root] == Node::WALL || components[root] != NO_COMPONENT)
+            continue;
+
+        uint32_t component = component_sizes.size();
+        component_sizes.push_back(0);
+        components[root] = component;
+        stack.push_back(root);
+        while(!stack.empty())
+        {
+            uint32_t cell = stack.back();
+            stack.pop_back();
+            component_sizes[component]++;
+
+            int x = cell % key.width;
+            int y = cell / key.width;
+            const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+            for(int i = 0; i < successors.amount; ++i)
+            {
+                dir_t dir = directions[successors.directions[i]];
+                uint32_t neighbour = (y + dir->movement.second) * key.width + x + dir->movement.first;
+                if(components[neighbour] == NO_COMPONENT)
+                {
+                    components[neighbour] = component;
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    // Only the components with at least a landmark's share of the empty cells get landmarks, and always the largest one,
+    // so that small enclosed pockets do not take the landmarks of the rest of the map.
+    uint32_t empty_cells = 0;
+    uint32_t largest = 0;
+    for(uint32_t size : component_sizes)
+    {
+        empty_cells += size;
+        largest = std::max(largest, size);
+    }
+    uint32_t min_size = std::min(largest, empty_cells / std::max(requested, 1));
+
+    // The distance of each cell to the nearest landmark so far: NO_DISTANCE if no landmark reaches it yet,
+    // -1 for the walls and the cells of the components without landmarks
+    std::vector<distance_t> nearest(cell_count, -1);
+    for(uint32_t cell = 0; cell < cell_count; ++cell)
+    {
+        if(components[cell] != NO_COMPONENT && component_sizes[components[cell]] >= min_size)
+            nearest[cell] = NO_DISTANCE;
+    }
+
+    // Gets the cell with the largest value, or cell_count if there are no values above -1.
+    auto farthest = [&](const std::vector<distance_t>& values)
+    {
+        uint32_t best = cell_count;
+        for(uint32_t cell = 0; cell < cell_count; ++cell)
+        {
+            if(values[cell] >= 0 && (best == cell_count || values[cell] > values[best]))
+                best = cell;
+        }
+        return best;
+    };
+
+    std::vector<std::vector<uint16_t>> columns;
+    while(int(cells.size()) < requested)
+    {
+        uint32_t next = farthest(nearest);
+        if(next == cell_count || nearest[next] == 0)
+            break;
+
+        // The first landmark of a component is the cell farthest from its first cell, i.e. at an end of the component.
+        if(nearest[next] == NO_DISTANCE)
+        {
+            search_from(grid, key.width, next, search_distances, open);
+            for(distance_t& distance : search_distances)
+            {
+                if(distance == NO_DISTANCE)
+                    distance = -1;
+            }
+            next = farthest(search_distances);
+        }
+
+        cells.push_back(next);
+        search_from(grid, key.width, next, search_distances, open);
+
+        distance_t max_distance = 0;
+        for(uint32_t cell = 0; cell < cell_count; ++cell)
+        {
+            if(search_distances[cell] != NO_DISTANCE)
+                max_distance = std::max(max_distance, search_distances[cell]);
+            nearest[cell] = std::min(nearest[cell], search_distances[cell]);
+        }
+
+        // The distance d is stored as floor(d / step), with the step a multiple of STRAIGHT / STEPS_PER_MOVE
+        // so that the longest distance fits below UNREACHABLE.
+        int64_t step_divisor = int64_t(Cost::STRAIGHT) * (int64_t(max_distance) * STEPS_PER_MOVE / (int64_t(Cost::STRAIGHT) * UNREACHABLE) + 1);
+        std::vector<uint16_t>& column = columns.emplace_back(cell_count, UNREACHABLE);
+        for(uint32_t cell = 0; cell < cell_count; ++cell)
+        {
+            if(search_distances[cell] != NO_DISTANCE)
+                column[cell] = uint16_t(int64_t(search_distances[cell]) * STEPS_PER_MOVE / step_divisor);
+        }
+
+        // A move of cost c changes the stored distance by at most ceil(c / step) steps.
+        // A step is thus worth the smallest c / ceil(c / step) over the moves, which keeps the heuristic consistent.
+        uint64_t scale = std::numeric_limits<uint64_t>::max();
+        for(int64_t cost : {Cost::STRAIGHT, Cost::DIAGONAL})
+        {
+            int64_t steps = (cost * STEPS_PER_MOVE + step_divisor - 1) / step_divisor;
+            scale = std::min(scale, uint64_t((cost << 16) / steps));
+        }
+        scales.push_back(scale);
+    }
+
+    // Interleaved by cell, so that the distances of all the landmarks to a cell are read at once
+    count = cells.size();
+    distances.assign(cell_count * count, UNREACHABLE);
+    for(int i = 0; i < count; ++i)
+    {
+        for(size_t cell = 0; cell < cell_count; ++cell)
+            distances[cell * count + i] = columns[i][cell];
+    }
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool Landmarks::save(std::ostream& out) const
+{
+    if(!key.write(out, LANDMARKS_MAGIC, LANDMARKS_VERSION))
+        return false;
+
+    LandmarksHeader header{count, requested};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(cells.data()), cells.size() * sizeof(cells[0]));
+    out.write(reinterpret_cast<const char*>(scales.data()), scales.size() * sizeof(scales[0]));
+    out.write(reinterpret_cast<const char*>(distances.data()), distances.size() * sizeof(distances[0]));
+    return out.good();
+}
+
+bool Landmarks::load(const State& s, int new_count, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, LANDMARKS_MAGIC, LANDMARKS_VERSION))
+        return false;
+
+    LandmarksHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good()
+    || header.requested != new_count
+    || header.count < 0
+    || header.count > new_count)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> loaded_cells(header.count);
+    std::vector<uint64_t> loaded_scales(header.count);
+    std::vector<uint16_t> loaded_distances(size_t(s.width) * s.height * header.count);
+    in.read(reinterpret_cast<char*>(loaded_cells.data()), loaded_cells.size() * sizeof(loaded_cells[0]));
+    in.read(reinterpret_cast<char*>(loaded_scales.data()), loaded_scales.size() * sizeof(loaded_scales[0]));
+    in.read(reinterpret_cast<char*>(loaded_distances.data()), loaded_distances.size() * sizeof(loaded_distances[0]));
+    if(!in.good())
+        return false;
+
+    cells = std::move(loaded_cells);
+    scales = std::move(loaded_scales);
+    distances = std::move(loaded_distances);
+    count = header.count;
+    requested = header.requested;
+    key = loaded_key;
+    build_time = 0;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+
+/**
+ * Landmarks of a differential heuristic (ALT), as described in Goldberg and Harrelson, 2005
+ * ("Computing the Shortest Path: A* Search Meets Graph Theory").
+ *
+ * The shortest distances from a few landmark cells to every cell are stored. By the triangle inequality,
+ * |d(L, a) - d(L, b)| is a lower bound of the distance between a and b for every landmark L,
+ * and the heuristic is the largest of these bounds and the octile distance. Around walls it is much closer to the
+ * real distance than the octile distance, so A* expands fewer nodes on mazes and rooms.
+ *
+ * The landmarks are selected one at a time, each at the cell farthest from the landmarks selected so far,
+ * which places them at the far ends of the map and its dead ends. Each landmark takes one Dijkstra search to build.
+ * Connected areas smaller than a landmark's share of the empty cells get no landmarks, so that enclosed pockets
+ * do not take them from the rest of the map; the heuristic is the octile distance there.
+ *
+ * The distances are stored in 16 bits per cell and landmark, in steps of a seventh of a straight move
+ * (coarser steps on maps with distances of over 9000 moves). The steps are scaled so that the heuristic stays
+ * consistent: it never decreases by more than the cost of a move, so A* and JPS need no re-expansions and the results stay optimal.
+ * The distances of all the landmarks to a cell are next to each other, so the heuristic reads one cache line per cell.
+ */
+class Landmarks
+{
+public:
+    /**
+     * The stored distance of the cells that the landmark cannot reach.
+     */
+    static constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+
+    /**
+     * The step of the stored distances, in the units of OctileIntegerCost, is STRAIGHT / STEPS_PER_MOVE.
+     * With 7 steps, a diagonal move is just below 10 steps, which makes the scaling of the steps almost exact.
+     */
+    static constexpr int32_t STEPS_PER_MOVE = 7;
+
+    /**
+     * Selects the landmarks of the state and builds their distances, unless they are already up to date
+     * (the same state, revision, size and amount). The grid must be up to date.
+     *
+     * @returns Whether the landmarks were built.
+     */
+    bool update(const State& state, const Grid& grid, int count);
+
+    /**
+     * Selects count landmarks of the state and builds their distances. The grid must be up to date.
+     * Fewer landmarks are selected if the map has fewer empty cells.
+     */
+    void build(const State& state, const Grid& grid, int count);
+
+    /**
+     * Gets a lower bound of the distance between (x1, y1) and (x2, y2) from the landmarks, in the units of OctileIntegerCost.
+     */
+    OctileIntegerCost<>::distance_t lower_bound(int x1, int y1, int x2, int y2) const
+    {
+        const uint16_t* a = distances.data() + (size_t(y1) * key.width + x1) * count;
+        const uint16_t* b = distances.data() + (size_t(y2) * key.width + x2) * count;
+        uint64_t bound = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            if(a[i] == UNREACHABLE || b[i] == UNREACHABLE)
+                continue;
+
+            uint32_t difference = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+            bound = std::max(bound, difference * scales[i]);
+        }
+        return OctileIntegerCost<>::distance_t(bound >> 16);
+    }
+
+    /**
+     * Gets the heuristic between (x1, y1) and (x2, y2) in the units of the cost model:
+     * the larger of the octile distance and the lower bound from the landmarks.
+     */
+    template<typename Cost>
+    typename Cost::distance_t heuristic(int x1, int y1, int x2, int y2) const
+    {
+        using distance_t = typename Cost::distance_t;
+
+        distance_t octile = Cost::heuristic(x1, y1, x2, y2);
+        if constexpr(std::is_same_v<Cost, OctileIntegerCost<>>)
+        {
+            return std::max(octile, lower_bound(x1, y1, x2, y2));
+        }
+        else
+        {
+            // Scaled down slightly, as the diagonal cost of OctileIntegerCost is a bit above sqrt(2)
+            // and the heuristic must stay consistent with the moves of the other cost models.
+            constexpr double scale = Cost::STRAIGHT * (1.0 - 1e-6) / OctileIntegerCost<>::STRAIGHT;
+            return std::max(octile, distance_t(lower_bound(x1, y1, x2, y2) * scale));
+        }
+    }
+
+    /**
+     * Gets the amount of landmarks.
+     */
+    int get_count() const
+    {
+        return count;
+    }
+
+    /**
+     * Gets the cell of the landmark i.
+     */
+    Point get_landmark(int i) const
+    {
+        return {int(cells[i] % key.width), int(cells[i] / key.width)};
+    }
+
+    /**
+     * Gets the time (in microseconds) spent building the landmarks during the last update(), or 0 if they were up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the distances of one landmark in bytes.
+     */
+    size_t get_memory_per_landmark() const
+    {
+        return size_t(key.width) * key.height * sizeof(distances[0]);
+    }
+
+    /**
+     * Gets the amount of memory taken by the landmarks in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return distances.capacity() * sizeof(distances[0])
+            + scales.capacity() * sizeof(scales[0])
+            + cells.capacity() * sizeof(cells[0]);
+    }
+
+    /**
+     * Writes the landmarks and their distances into the stream.
+     *
+     * @returns Whether the landmarks were written. False if they have not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads landmarks written by save(), so that the next update() with the state and the amount does not build them again.
+     *
+     * @returns Whether the landmarks were loaded. False if the data is invalid, was made for another map or has another amount of landmarks.
+     */
+    bool load(const State& state, int count, std::istream& in);
+
+private:
+    // The distances of the landmarks to each cell, count values per cell by map index
+    std::vector<uint16_t> distances;
+
+    // The length of one step of the stored distances of each landmark, in the units of OctileIntegerCost << 16
+    std::vector<uint64_t> scales;
+
+    // The map index of each landmark
+    std::vector<uint32_t> cells;
+
+    // The amount of landmarks, and the amount requested from build()
+    int count = 0;
+    int requested = 0;
+
+    PreprocessedKey key;
+
+    double build_time = 0;
+};
+
+#endif
\ No newline at end of file
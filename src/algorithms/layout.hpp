@@ -0,0 +1,131 @@
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+/**
+ * The main type used by nodes to refer to each other.
+ * Represents an index into a flat array of nodes.
+ * 32 bits are enough for maps of up to 4 billion cells, and halve the size of the node records.
+ */
+typedef uint32_t node_index;
+constexpr node_index NULL_NODE_IDX = std::numeric_limits<node_index>::max();
+
+/**
+ * Layouts define how the (x, y) coordinates of a map are mapped into node indices and back,
+ * i.e. how the node arrays of the algorithms are laid out in memory.
+ * A layout is selected with the Layout type of the policy (see policies.hpp).
+ *
+ * Every layout provides:
+ *  -init(width, height):   sets the layout up for a map of the specified size
+ *  -flatten(x, y):         (x, y) -> node index
+ *  -expand(idx):           node index -> (x, y)
+ *  -map_index(idx):        node index -> index into the State::map
+ *  -size():                the size of the node arrays needed
+ *  -offsets:               the difference of the node indices of a node and its neighbour in each direction,
+ *                          indexed by Direction::type
+ */
+
+/**
+ * Rows are laid out one after another, exactly like in the State::map.
+ * Expanding a node index into coordinates needs an integer division.
+ */
+struct RowMajorLayout
+{
+    int width = 0;
+    int height = 0;
+    std::array<int, 8> offsets;
+
+    RowMajorLayout() {}
+    RowMajorLayout(int width, int height)
+    {
+        init(width, height);
+    }
+
+    void init(int width, int height)
+    {
+        this->width = width;
+        this->height = height;
+        offsets = {-width, -width + 1, 1, width + 1, width, width - 1, -1, -width - 1};
+    }
+
+    node_index flatten(int x, int y) const
+    {
+        return y * width + x;
+    }
+
+    std::pair<int, int> expand(node_index idx) const
+    {
+        return {idx % width, idx / width};
+    }
+
+    node_index map_index(node_index idx) const
+    {
+        return idx;
+    }
+
+    size_t size() const
+    {
+        return (size_t)width * height;
+    }
+};
+
+/**
+ * Each row is padded to a power-of-two length (stride), so that flattening and expanding
+ * only need shifts and masks instead of multiplication and division.
+ * The node arrays become up to twice as large, the padding nodes are simply never accessed.
+ */
+struct PowerOfTwoLayout
+{
+    int width = 0;
+    int height = 0;
+    uint32_t shift = 0;
+    uint32_t mask = 0;
+    std::array<int, 8> offsets;
+
+    PowerOfTwoLayout() {}
+    PowerOfTwoLayout(int width, int height)
+    {
+        init(width, height);
+    }
+
+    void init(int width, int height)
+    {
+        this->width = width;
+        this->height = height;
+        shift = std::bit_width((uint32_t)std::max(width - 1, 1));
+        mask = (1u << shift) - 1;
+
+        int stride = 1 << shift;
+        offsets = {-stride, -stride + 1, 1, stride + 1, stride, stride - 1, -1, -stride - 1};
+    }
+
+    node_index flatten(int x, int y) const
+    {
+        return ((node_index)y << shift) + x;
+    }
+
+    std::pair<int, int> expand(node_index idx) const
+    {
+        return {idx & mask, idx >> shift};
+    }
+
+    node_index map_index(node_index idx) const
+    {
+        auto [x, y] = expand(idx);
+        return y * width + x;
+    }
+
+    size_t size() const
+    {
+        return (size_t)height << shift;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,319 @@
+#ifndef NODE_STORE_HPP
+#define NODE_STORE_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "algorithms/layout.hpp"
+#include "algorithms/scratch_arena.hpp"
+#include "algorithms/scratch_pool.hpp"
+
+/**
+ * Node stores hold the search state of the algorithms: a node record (see search_node.hpp) and a parent index for each node.
+ * A node store is selected with the NodeStore type of the policy (see policies.hpp).
+ *
+ * Every node store provides:
+ *  -begin_run(size, key):  starts a new search over node indices [0, size) of the map generation of the key (see ScratchKey)
+ *  -touch(idx):            the record of the node, reset first if it has not been accessed during the current run
+ *  -operator[](idx):       the record of a node already touched during the current run
+ *  -lookup(idx):           the record of the node if it has been touched during the current run, nullptr otherwise (without touching it)
+ *  -parent(idx):           the parent index of a node already touched during the current run
+ *  -parents():             something indexable with node indices, giving the parent indices (for Util::build_path())
+ *  -get_memory_usage():    the amount of memory used in bytes
+ *
+ * touch() may move the records of a sparse store when it grows:
+ * a reference to a record is only valid until the next touch() of another node.
+ */
+
+/**
+ * The default store: flat arrays indexed directly by the node index, sized for the whole map.
+ * Accessing a node is a single array lookup, but the arrays take 12 bytes per map cell (10 with narrow stamps)
+ * even if the search only visits a small part of the map.
+ */
+template<typename Node>
+class DenseNodeStore
+{
+public:
+    void begin_run(size_t size, ScratchKey key = {})
+    {
+        nodes.begin_run(size, key);
+        parent_indices.lease(size, key);
+    }
+
+    Node& touch(node_index idx)
+    {
+        return nodes.touch(idx);
+    }
+
+    Node& operator[](node_index idx)
+    {
+        return nodes[idx];
+    }
+
+    Node* lookup(node_index idx)
+    {
+        return nodes.lookup(idx);
+    }
+
+    node_index& parent(node_index idx)
+    {
+        return parent_indices[idx];
+    }
+
+    node_index* parents()
+    {
+        return &parent_indices[0];
+    }
+
+    size_t get_memory_usage() const
+    {
+        return nodes.get_memory_usage() + parent_indices.get_memory_usage();
+    }
+
+private:
+    ScratchArena<Node> nodes;
+    ScratchBuffer<node_index> parent_indices;
+};
+
+/**
+ * A sparse store: an open-addressing hash table holding only the nodes touched during the current run.
+ *
+ * The memory used depends on the amount of nodes the search visits instead of the size of the map,
+ * which matters on very large maps where a query only visits a small area.
+ * Each access costs a hash and a probe instead of a single array lookup.
+ *
+ * -----------------------------
+ * Implementation notes:
+ *
+ * Each slot holds the node record together with its key (the node index) and parent, 16 bytes in total.
+ * The slots are found by Fibonacci hashing and linear probing.
+ *
+ * The slots live in a ScratchArena, so the table is cleared in O(1) at the beginning of every run:
+ * a slot is occupied only if its stamp matches the current run id.
+ * The table doubles whenever it becomes more than half full. The live slots are copied aside,
+ * a new run is started over the larger table (which makes every slot free) and the copies are inserted again.
+ * The capacity is kept between runs, so a store used for similar queries only grows during the first ones.
+ */
+template<typename Node>
+class HashedNodeStore
+{
+public:
+    void begin_run(size_t, ScratchKey key = {})
+    {
+        count = 0;
+        map = key;
+        run_id = slots.begin_run(capacity, map);
+    }
+
+    Node& touch(node_index idx)
+    {
+        auto i = find(idx);
+        if(slots[i].is_current(run_id))
+            return slots[i];
+
+        if(count + 1 > capacity / 2)
+        {
+            grow();
+            i = find(idx);
+        }
+        count++;
+
+        Slot& slot = slots[i];
+        slot.reset(run_id);
+        slot.key = idx;
+        return slot;
+    }
+
+    Node& operator[](node_index idx)
+    {
+        return slots[find(idx)];
+    }
+
+    Node* lookup(node_index idx)
+    {
+        Slot& slot = slots[find(idx)];
+        return slot.is_current(run_id) ? &slot : nullptr;
+    }
+
+    node_index& parent(node_index idx)
+    {
+        return slots[find(idx)].parent;
+    }
+
+    /**
+     * Indexes the parents through the hash table.
+     */
+    struct ParentView
+    {
+        HashedNodeStore* store;
+
+        node_index& operator[](node_index idx) const
+        {
+            return store->parent(idx);
+        }
+    };
+
+    ParentView parents()
+    {
+        return ParentView{this};
+    }
+
+    /**
+     * Gets the amount of nodes touched during the current run.
+     */
+    size_t size() const
+    {
+        return count;
+    }
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+
+    size_t get_memory_usage() const
+    {
+        return slots.get_memory_usage() + spill.capacity() * sizeof(Slot);
+    }
+
+private:
+    struct Slot : Node
+    {
+        node_index key;
+        node_index parent;
+    };
+
+    static constexpr size_t INITIAL_CAPACITY = 1 << 12;
+
+    ScratchArena<Slot> slots;
+    size_t capacity = INITIAL_CAPACITY;
+    size_t count = 0;
+    uint32_t run_id = 0;
+    ScratchKey map;
+
+    // The live slots during grow(), kept to avoid allocating on every growth.
+    std::vector<Slot> spill;
+
+    size_t hash(node_index idx) const
+    {
+        return (uint32_t)(idx * 0x9E3779B1u) >> (32 - std::countr_zero(capacity));
+    }
+
+    /**
+     * Finds the slot of the node, or the free slot where it should be inserted.
+     */
+    size_t find(node_index idx)
+    {
+        auto i = hash(idx);
+        while(slots[i].is_current(run_id) && slots[i].key != idx)
+            i = (i + 1) & (capacity - 1);
+        return i;
+    }
+
+    void grow()
+    {
+        spill.clear();
+        for(size_t i = 0; i < capacity; ++i)
+        {
+            if(slots[i].is_current(run_id))
+                spill.push_back(slots[i]);
+        }
+
+        capacity *= 2;
+        run_id = slots.begin_run(capacity, map);
+
+        for(auto& old : spill)
+        {
+            Slot& slot = slots[find(old.key)];
+            slot = old;
+            slot.reset(run_id);
+            slot.distance = old.distance;
+            slot.set_status(old.status());
+        }
+    }
+};
+
+/**
+ * Selects the dense or the hashed store at the beginning of every run, depending on the size of the map.
+ * Maps of at least HASHED_THRESHOLD nodes (e.g. 2048x2048) use the hashed store: from about this size on,
+ * the flat arrays no longer fit into the caches and short queries become faster with the hash table
+ * (see the node store benchmark in tests/test_node_store.cpp). Long queries remain faster with the flat arrays.
+ *
+ * Both stores keep their memory, so alternating between small and large maps does not reallocate anything.
+ * The price is a branch on every access.
+ */
+template<typename Node>
+class AdaptiveNodeStore
+{
+public:
+    static constexpr size_t HASHED_THRESHOLD = 1 << 22;
+
+    void begin_run(size_t size, ScratchKey key = {})
+    {
+        hashed = size >= HASHED_THRESHOLD;
+        if(hashed)
+            sparse.begin_run(size, key);
+        else
+            dense.begin_run(size, key);
+    }
+
+    Node& touch(node_index idx)
+    {
+        return hashed ? sparse.touch(idx) : dense.touch(idx);
+    }
+
+    Node& operator[](node_index idx)
+    {
+        return hashed ? sparse[idx] : dense[idx];
+    }
+
+    Node* lookup(node_index idx)
+    {
+        return hashed ? sparse.lookup(idx) : dense.lookup(idx);
+    }
+
+    node_index& parent(node_index idx)
+    {
+        return hashed ? sparse.parent(idx) : dense.parent(idx);
+    }
+
+    /**
+     * Indexes the parents through the store selected for the current run.
+     */
+    struct ParentView
+    {
+        AdaptiveNodeStore* store;
+
+        node_index& operator[](node_index idx) const
+        {
+            return store->parent(idx);
+        }
+    };
+
+    ParentView parents()
+    {
+        return ParentView{this};
+    }
+
+    /**
+     * Is the hashed store used for the current run?
+     */
+    bool is_hashed() const
+    {
+        return hashed;
+    }
+
+    size_t get_memory_usage() const
+    {
+        return dense.get_memory_usage() + sparse.get_memory_usage();
+    }
+
+private:
+    DenseNodeStore<Node> dense;
+    HashedNodeStore<Node> sparse;
+    bool hashed = false;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef OBSERVER_HPP
+#define OBSERVER_HPP
+
+#include "state.hpp"
+#include "algorithms/layout.hpp"
+
+/**
+ * Observers are compile-time policies through which the search algorithms report their progress.
+ * All functions are static, so an observer is only ever used as a type (see policies.hpp).
+ *
+ * Every observer provides the following functions:
+ *  -expanded(state, idx, forward): the node has been expanded, i.e. its neighbours are being generated
+ *  -examined(state, idx, forward): a new, shorter path to the node has been found
+ *  -path(state, idx):              the node is a part of the final path
+ * The "idx" parameter is the index of the node in the State::map (see RowMajorLayout in layout.hpp).
+ * The "forward" parameter tells bidirectional algorithms' searches apart: true for the search from the beginning.
+ */
+
+/**
+ * An observer that does nothing.
+ * Used for headless runs (tests, benchmarks, production), where the algorithms should not write into the map at all.
+ * All calls compile down to nothing.
+ */
+struct NullObserver
+{
+    static constexpr bool enabled = false;
+
+    static void expanded(State&, node_index, bool = true) {}
+    static void examined(State&, node_index, bool = true) {}
+    static void path(State&, node_index) {}
+};
+
+/**
+ * An observer that records the progress of the algorithm into the State::map, for the visualizer to render.
+ * The beginning and end points of the state are never overwritten.
+ */
+struct MapObserver
+{
+    static constexpr bool enabled = true;
+
+    static void expanded(State& state, node_index idx, bool forward = true)
+    {
+        mark(state, idx, forward ? Node::EXPANDED_1 : Node::EXPANDED_2);
+    }
+
+    static void examined(State& state, node_index idx, bool forward = true)
+    {
+        mark(state, idx, forward ? Node::EXAMINED_1 : Node::EXAMINED_2);
+    }
+
+    static void path(State& state, node_index idx)
+    {
+        mark(state, idx, Node::PATH);
+    }
+
+private:
+    static void mark(State& state, node_index idx, Node type)
+    {
+        if(state.map[idx] != Node::START && state.map[idx] != Node::END)
+        {
+            state.map[idx] = type;
+        }
+    }
+};
+
+#endif
\ No newline at end of file
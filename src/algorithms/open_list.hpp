@@ -0,0 +1,217 @@
+#ifndef OPEN_LIST_HPP
+#define OPEN_LIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "algorithms/layout.hpp"
+
+/**
+ * Open lists are the priority queues of (key, node index) pairs used by the search algorithms.
+ * An open list is selected with the OpenList type of the policy (see policies.hpp).
+ *
+ * Every open list provides:
+ *  -init(node_count):      empties the list for a new search over node indices [0, node_count)
+ *  -empty(), size()
+ *  -push(key, node):       adds the node with the specified key
+ *  -top():                 the (key, node) pair with the lowest key
+ *  -pop():                 removes the pair with the lowest key
+ *  -get_memory_usage():    the amount of memory used in bytes
+ *
+ * Open lists either keep one entry per node (push() of a node already in the list lowers its key),
+ * or allow duplicates, in which case the algorithms have to skip the stale entries of already expanded nodes.
+ * has_duplicates tells which one is the case.
+ */
+
+/**
+ * A binary heap with lazy deletion: every push() adds a new entry, even if the node is already in the heap.
+ * Orders the entries exactly like std::priority_queue with std::greater, but keeps its memory between searches.
+ */
+template<typename Key>
+class LazyBinaryHeap
+{
+public:
+    static constexpr bool has_duplicates = true;
+
+    void init(size_t)
+    {
+        heap.clear();
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    void push(Key key, node_index node)
+    {
+        heap.emplace_back(key, node);
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+
+    const std::pair<Key, node_index>& top() const
+    {
+        return heap.front();
+    }
+
+    void pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        heap.pop_back();
+    }
+
+    size_t get_memory_usage() const
+    {
+        return heap.capacity() * sizeof(Entry);
+    }
+
+private:
+    typedef std::pair<Key, node_index> Entry;
+    std::vector<Entry> heap;
+};
+
+/**
+ * An indexed D-ary heap with decrease-key: each node is in the heap at most once.
+ * Pushing a node that is already in the heap only lowers its key in place (and is ignored if the key is not lower),
+ * so the heap never grows larger than the amount of distinct open nodes and no stale entries are ever popped.
+ *
+ * A 4-ary heap is shallower than a binary heap and the children of a node are next to each other in memory,
+ * so sifting down touches fewer cache lines.
+ *
+ * The position of each node in the heap is kept in an array indexed by the node index.
+ * The positions are never cleared: a position is only trusted if the heap entry at that position refers back
+ * to the same node, so the array needs no initialization between searches.
+ */
+template<typename Key, uint32_t D = 4>
+class IndexedDaryHeap
+{
+public:
+    static constexpr bool has_duplicates = false;
+
+    void init(size_t node_count)
+    {
+        heap.clear();
+        if(positions.size() < node_count)
+            positions.resize(node_count);
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    /**
+     * Is the node currently in the heap?
+     */
+    bool contains(node_index node) const
+    {
+        auto pos = positions[node];
+        return pos < heap.size() && heap[pos].second == node;
+    }
+
+    void push(Key key, node_index node)
+    {
+        uint32_t pos;
+        if(contains(node))
+        {
+            pos = positions[node];
+            if(!(key < heap[pos].first))
+                return;
+            heap[pos].first = key;
+        }
+        else
+        {
+            pos = heap.size();
+            heap.emplace_back(key, node);
+        }
+        sift_up(pos);
+    }
+
+    const std::pair<Key, node_index>& top() const
+    {
+        return heap.front();
+    }
+
+    void pop()
+    {
+        Entry last = heap.back();
+        heap.pop_back();
+        if(!heap.empty())
+            sift_down(0, last);
+    }
+
+    size_t get_memory_usage() const
+    {
+        return heap.capacity() * sizeof(Entry) + positions.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    typedef std::pair<Key, node_index> Entry;
+    std::vector<Entry> heap;
+    std::vector<uint32_t> positions;
+
+    /**
+     * Moves the entry at pos towards the root until its parent is not larger.
+     */
+    void sift_up(uint32_t pos)
+    {
+        Entry entry = heap[pos];
+        while(pos > 0)
+        {
+            uint32_t parent = (pos - 1) / D;
+            if(!(entry < heap[parent]))
+                break;
+            heap[pos] = heap[parent];
+            positions[heap[pos].second] = pos;
+            pos = parent;
+        }
+        heap[pos] = entry;
+        positions[entry.second] = pos;
+    }
+
+    /**
+     * Places the entry into the hole at pos, moving the smallest children up until the entry fits.
+     */
+    void sift_down(uint32_t pos, Entry entry)
+    {
+        uint32_t size = heap.size();
+        while(true)
+        {
+            uint32_t first = pos * D + 1;
+            if(first >= size)
+                break;
+
+            uint32_t last = std::min(first + D, size);
+            uint32_t smallest = first;
+            for(uint32_t child = first + 1; child < last; ++child)
+            {
+                if(heap[child] < heap[smallest])
+                    smallest = child;
+            }
+
+            if(!(heap[smallest] < entry))
+                break;
+            heap[pos] = heap[smallest];
+            positions[heap[pos].second] = pos;
+            pos = smallest;
+        }
+        heap[pos] = entry;
+        positions[entry.second] = pos;
+    }
+};
+
+#endif
\ No newline at end of file
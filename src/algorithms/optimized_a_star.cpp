@@ -4,11 +4,14 @@
 
 #include <iostream>
 
-void OptimizedAStar::init(State* s)
+template<typename Policy>
+void OptimizedAStar<Policy>::init(State* s)
 {
-    curr_run_id++;
     state = s;
-    lowest_path = std::numeric_limits<float>::infinity();
+    grid.update(*s, Policy::precompute_successors);
+    if constexpr(Policy::landmarks > 0)
+        landmarks.update(*s, grid, Policy::landmarks);
+    lowest_path = InternalNode::INFINITE_DISTANCE;
     best_start_to_mid_node = NULL_NODE_IDX;
     best_end_to_mid_node   = NULL_NODE_IDX;
 
@@ -17,40 +20,41 @@ void OptimizedAStar::init(State* s)
     open_2.clear();
 
     // Initialize the nodes vector.
-    if(nodes.capacity() != s->map.size())
-    {
-        nodes = std::vector<InternalNode>(s->map.size());
-    }
+    layout.init(s->width, s->height);
+    nodes.begin_run(layout.size(), {s, s->revision});
     
-    auto start_index = Util::flatten(s->width, s->begin.x, s->begin.y);
-    Util::lazy_initialize(curr_run_id, nodes[start_index]);
-    nodes[start_index].distance = 0.0f;
-    nodes[start_index].status = InternalNode::Status::RE_1;
-    open_1.push(Util::diagonal_distance(state->begin.x, state->begin.y, state->end.x, state->end.y), start_index);
-
-    auto end_index = Util::flatten(s->width, s->end.x, s->end.y);
-    Util::lazy_initialize(curr_run_id, nodes[end_index]);
-    nodes[end_index].distance = 0.0f;
-    nodes[end_index].status = InternalNode::Status::RE_2;
-    open_2.push(Util::diagonal_distance(state->end.x, state->end.y, state->begin.x, state->begin.y), end_index);
+    auto start_index = layout.flatten(s->begin.x, s->begin.y);
+    auto& start_node = nodes.touch(start_index);
+    start_node.distance = 0;
+    start_node.set_status(InternalNode::Status::RE_1);
+    nodes.parent(start_index) = NULL_NODE_IDX;
+    open_1.push(heuristic(state->begin.x, state->begin.y, state->end.x, state->end.y), start_index);
+
+    auto end_index = layout.flatten(s->end.x, s->end.y);
+    auto& end_node = nodes.touch(end_index);
+    end_node.distance = 0;
+    end_node.set_status(InternalNode::Status::RE_2);
+    nodes.parent(end_index) = NULL_NODE_IDX;
+    open_2.push(heuristic(state->end.x, state->end.y, state->begin.x, state->begin.y), end_index);
 }
 
-Algorithm::Result::Type OptimizedAStar::update()
+template<typename Policy>
+Algorithm::Result::Type OptimizedAStar<Policy>::update()
 {
     for(bool start : {true, false})
     {
         if(open_1.empty() || open_2.empty())
         {
             // End of execution
-            if(lowest_path == std::numeric_limits<float>::infinity())
+            if(lowest_path == InternalNode::INFINITE_DISTANCE)
             {
                 result.type = Result::Type::FAILURE;
                 return Result::Type::FAILURE;
             }
 
-            Util::format_bidirectional_nodes(&nodes[0], best_start_to_mid_node, best_end_to_mid_node);
-            Util::build_path(*state, &nodes[0], result);
-            result.length = lowest_path;
+            Util::format_bidirectional_nodes(nodes.parents(), best_start_to_mid_node, best_end_to_mid_node);
+            Util::build_path<Observer>(*state, layout, nodes.parents(), result);
+            result.length = Cost::to_float(lowest_path);
             result.type = Result::Type::SUCCESS;
             return result.type;
         }
@@ -62,47 +66,44 @@ Algorithm::Result::Type OptimizedAStar::update()
         auto RE             = start ? InternalNode::RE_1        : InternalNode::RE_2;
         auto OTHER_RE       = start ? InternalNode::RE_2        : InternalNode::RE_1;
 
-        auto heuristic = [this](bool s, int x, int y) -> float
+        auto heuristic = [this](bool s, int x, int y) -> distance_t
         {
             if(s)
-                return Util::diagonal_distance(x, y, this->state->end.x, this->state->end.y);
+                return this->heuristic(x, y, this->state->end.x, this->state->end.y);
             else
-                return Util::diagonal_distance(x, y, this->state->begin.x, this->state->begin.y);
+                return this->heuristic(x, y, this->state->begin.x, this->state->begin.y);
         };
 
         auto [approx_dist, node_idx] = open.pop();
 
-        auto [x, y] = Util::expand(state->width, node_idx);
+        auto [x, y] = layout.expand(node_idx);
         auto& node = nodes[node_idx];
 
-        if(node.status == EXAMINED)
+        if(node.status() == EXAMINED)
         {
             open.update_write();
             continue;
         }
 
-        node.status = EXAMINED;
+        node.set_status(EXAMINED);
         result.expanded++;
+        // Copied, as touching the neighbours may move the node (see node_store.hpp)
+        distance_t node_distance = node.distance;
 
-        // Is the current node the first node? If not, set it to EXPANDED
-        if(node.prev != NULL_NODE_IDX)
-        {
-            state->map[node_idx] = start ? Node::EXPANDED_1 : Node::EXPANDED_2;
-        }
+        Observer::expanded(*state, layout.map_index(node_idx), start);
 
         std::pair<node_index, dir_t> neighbours[8];
-        auto amount_neighbours = Util::get_neighbours(neighbours, *state, x, y);
+        auto amount_neighbours = Util::get_neighbours(neighbours, grid, layout, x, y);
 
         for(int i = 0; i < amount_neighbours; ++i)
         {
             auto [neighbour_idx, dir] = neighbours[i];
-            auto& neighbour = nodes[neighbour_idx];
-            Util::lazy_initialize(curr_run_id, neighbour);
-            auto [neighbour_x, neighbour_y] = Util::expand(state->width, neighbour_idx);
+            auto& neighbour = nodes.touch(neighbour_idx);
+            auto [neighbour_x, neighbour_y] = layout.expand(neighbour_idx);
             
-            float new_dist = node.distance + (dir->straight ? 1.0f : SQRT_2);
+            distance_t new_dist = node_distance + Cost::move(dir);
             
-            if(neighbour.status == OTHER_EXAMINED || neighbour.status == OTHER_RE)
+            if(neighbour.status() == OTHER_EXAMINED || neighbour.status() == OTHER_RE)
             {
                 if(new_dist + neighbour.distance < lowest_path)
                 {
@@ -114,19 +115,19 @@ Algorithm::Result::Type OptimizedAStar::update()
             else if(new_dist < neighbour.distance)
             {
                 neighbour.distance = new_dist;
-                neighbour.prev = node_idx;
-                float f = new_dist + heuristic(start, neighbour_x, neighbour_y);
+                nodes.parent(neighbour_idx) = node_idx;
+                distance_t f = new_dist + heuristic(start, neighbour_x, neighbour_y);
 
                 if(!(lowest_path <= f
                 || lowest_path <= new_dist + other_top - heuristic(!start, neighbour_x, neighbour_y)))
                 {
-                    neighbour.status = RE;
+                    neighbour.set_status(RE);
                     open.push(f, neighbour_idx);
-                    state->map[neighbour_idx] = start ? Node::EXAMINED_1 : Node::EXAMINED_2;
+                    Observer::examined(*state, layout.map_index(neighbour_idx), start);
                 }
                 else
                 {
-                    neighbour.status = EXAMINED;
+                    neighbour.set_status(EXAMINED);
                 }
             }
         }
@@ -134,4 +135,62 @@ Algorithm::Result::Type OptimizedAStar::update()
     }
 
     return Result::Type::EXECUTING;
-}
\ No newline at end of file
+}
+
+template<typename Policy>
+size_t OptimizedAStar<Policy>::get_memory_usage()
+{
+    return nodes.get_memory_usage()
+        + open_1.get_memory_usage()
+        + open_2.get_memory_usage()
+        + grid.get_memory_usage()
+        + landmarks.get_memory_usage();
+}
+
+template<typename Policy>
+double OptimizedAStar<Policy>::get_preprocessing_time()
+{
+    return landmarks.get_build_time();
+}
+
+template<typename Policy>
+size_t OptimizedAStar<Policy>::get_preprocessed_memory_usage()
+{
+    return landmarks.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> OptimizedAStar<Policy>::get_preprocessed_statistics()
+{
+    if constexpr(Policy::landmarks > 0)
+    {
+        return {
+            {"landmarks", landmarks.get_count()},
+            {"bytes_per_landmark", landmarks.get_memory_per_landmark()}
+        };
+    }
+    else
+    {
+        return {};
+    }
+}
+
+template<typename Policy>
+bool OptimizedAStar<Policy>::save_preprocessed(std::ostream& out)
+{
+    return Policy::landmarks > 0 && landmarks.save(out);
+}
+
+template<typename Policy>
+bool OptimizedAStar<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return Policy::landmarks > 0 && landmarks.load(s, Policy::landmarks, in);
+}
+
+template class OptimizedAStar<HeadlessPolicy>;
+template class OptimizedAStar<VisualPolicy>;
+template class OptimizedAStar<PowerOfTwoStride<HeadlessPolicy>>;
+template class OptimizedAStar<PowerOfTwoStride<VisualPolicy>>;
+template class OptimizedAStar<IntegerCost<HeadlessPolicy>>;
+template class OptimizedAStar<HashedNodes<HeadlessPolicy>>;
+template class OptimizedAStar<DifferentialHeuristic<HeadlessPolicy>>;
\ No newline at end of file
@@ -4,17 +4,33 @@
 #include <string>
 
 #include "algorithms/util.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/node_store.hpp"
 #include "algorithms/algorithm.hpp"
 #include "algorithms/bucket_queue.hpp"
+#include "algorithms/landmarks.hpp"
+#include "algorithms/policies.hpp"
 
+template<typename Policy = HeadlessPolicy>
 class OptimizedAStar : public Algorithm
 {
 public:
     void init(State* state);
     Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
 
 private:
-    struct InternalNode
+    using Observer = typename Policy::Observer;
+    using Cost = typename Policy::Cost;
+    using distance_t = typename Cost::distance_t;
+
+    struct InternalNode : SearchNode<distance_t, typename Policy::Stamp>
     {
         enum Status : uint8_t
         {
@@ -24,22 +40,34 @@ private:
             RE_1,
             RE_2
         };
-
-        node_index prev   = NULL_NODE_IDX;
-        float distance    = std::numeric_limits<float>::infinity(); 
-        uint32_t last_run = 1;
-        Status status     = Status::FREE;
     };
 
-    std::vector<InternalNode> nodes;
-    BucketQueue<node_index> open_1{0.1f, 30, 5};
-    BucketQueue<node_index> open_2{0.1f, 30, 5};
-    uint32_t curr_run_id;
+    typename Policy::template NodeStore<InternalNode> nodes;
+    Grid grid;
+    typename Policy::Layout layout;
+    // The bucket interval is a tenth of a straight move in the units of the cost model.
+    using OpenList = BucketQueueV2<node_index, distance_t>;
+    OpenList open_1 = OpenList::template for_cost<Cost>(10);
+    OpenList open_2 = OpenList::template for_cost<Cost>(10);
 
-    float lowest_path = std::numeric_limits<float>::infinity();
+    distance_t lowest_path = InternalNode::INFINITE_DISTANCE;
     node_index best_start_to_mid_node = NULL_NODE_IDX;
     node_index best_end_to_mid_node   = NULL_NODE_IDX;
 
+    // The landmarks of the differential heuristic, only built if Policy::landmarks is set
+    Landmarks landmarks;
+
+    /**
+     * Gets the heuristic from (x, y) to (goal_x, goal_y): the octile distance,
+     * or the differential heuristic of the landmarks if Policy::landmarks is set.
+     */
+    distance_t heuristic(int x, int y, int goal_x, int goal_y) const
+    {
+        if constexpr(Policy::landmarks > 0)
+            return landmarks.template heuristic<Cost>(x, y, goal_x, goal_y);
+        else
+            return Cost::heuristic(x, y, goal_x, goal_y);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef POLICIES_HPP
+#define POLICIES_HPP
+
+#include "algorithms/observer.hpp"
+#include "algorithms/layout.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/open_list.hpp"
+#include "algorithms/radix_heap.hpp"
+#include "algorithms/node_store.hpp"
+
+/**
+ * Policies are compile-time configurations of the search algorithms.
+ * Each algorithm is a class template taking one policy, from which it reads the types it should use:
+ *  -Observer: how the progress of the search is reported (see observer.hpp)
+ *  -precompute_successors: whether the valid moves of every cell are precomputed (see Grid::successors())
+ *  -Layout: how the node arrays are laid out in memory (see layout.hpp)
+ *  -Cost: the type of the distances and the costs of the moves (see cost.hpp)
+ *  -OpenList<Key>: the priority queue of the algorithms derived from CommonAlgorithm (see open_list.hpp)
+ *  -Stamp: the integer type of the generation stamps of the node records (see search_node.hpp)
+ *  -NodeStore<Node>: where A*, JPS and Optimized A* keep their node records and parents (see node_store.hpp)
+ *  -deferred_jumps: whether the jumps of JPS only touch the nodes of the jump points (see jps.hpp)
+ *  -goal_bounding: whether A* and JPS skip the moves that cannot start an optimal path to the end (see goal_bounds.hpp)
+ *  -landmarks: the amount of landmarks of the differential heuristic of A*, JPS and Optimized A*,
+ *      0 for the octile distance only (see landmarks.hpp)
+ *
+ * The algorithms are explicitly instantiated for the policies below in their source files.
+ */
+
+/**
+ * The policy for tests, benchmarks and production: nothing is written into the State::map.
+ */
+struct HeadlessPolicy
+{
+    using Observer = NullObserver;
+    static constexpr bool precompute_successors = true;
+    using Layout = RowMajorLayout;
+    using Cost = FloatCost;
+    template<typename Key> using OpenList = LazyBinaryHeap<Key>;
+    using Stamp = uint32_t;
+    template<typename Node> using NodeStore = DenseNodeStore<Node>;
+    static constexpr bool deferred_jumps = false;
+    static constexpr bool goal_bounding = false;
+    static constexpr int landmarks = 0;
+};
+
+/**
+ * The policy for the visualizer: the progress of the search is written into the State::map.
+ */
+struct VisualPolicy : HeadlessPolicy
+{
+    using Observer = MapObserver;
+};
+
+/**
+ * Policy modifier: pads the rows of the node arrays to a power-of-two length,
+ * so that no divisions are needed for converting node indices into coordinates (see PowerOfTwoLayout).
+ */
+template<typename Base>
+struct PowerOfTwoStride : Base
+{
+    using Layout = PowerOfTwoLayout;
+};
+
+/**
+ * Policy modifier: uses exact integer distances instead of floats (see OctileIntegerCost).
+ */
+template<typename Base>
+struct IntegerCost : Base
+{
+    using Cost = OctileIntegerCost<>;
+};
+
+/**
+ * Policy modifier: uses an indexed 4-ary heap with decrease-key as the open list (see IndexedDaryHeap),
+ * so that every open node is in the open list only once.
+ */
+template<typename Base>
+struct IndexedOpenList : Base
+{
+    template<typename Key> using OpenList = IndexedDaryHeap<Key, 4>;
+};
+
+/**
+ * Policy modifier: uses a monotone radix heap as the open list (see RadixHeap).
+ * Intended for the integer cost model, where the keys are small integers.
+ */
+template<typename Base>
+struct RadixOpenList : Base
+{
+    template<typename Key> using OpenList = RadixHeap<Key>;
+};
+
+/**
+ * Policy modifier: uses 16-bit generation stamps, which shrinks the node records from 8 to 6 bytes.
+ * The node arrays are then reset in bulk every 8191 runs (see ScratchArena).
+ */
+template<typename Base>
+struct NarrowStamps : Base
+{
+    using Stamp = uint16_t;
+};
+
+/**
+ * Policy modifier: keeps the nodes in an open-addressing hash table instead of flat arrays (see HashedNodeStore),
+ * so that the memory used depends on the amount of visited nodes instead of the size of the map.
+ */
+template<typename Base>
+struct HashedNodes : Base
+{
+    template<typename Node> using NodeStore = HashedNodeStore<Node>;
+};
+
+/**
+ * Policy modifier: selects the flat arrays or the hash table by the size of the map on every run (see AdaptiveNodeStore).
+ */
+template<typename Base>
+struct AdaptiveNodes : Base
+{
+    template<typename Node> using NodeStore = AdaptiveNodeStore<Node>;
+};
+
+/**
+ * Policy modifier: JPS only creates nodes for the jump points and fills in the cells between them when the path is built
+ * (see JumpPointSearch).
+ */
+template<typename Base>
+struct DeferredJumps : Base
+{
+    static constexpr bool deferred_jumps = true;
+};
+
+/**
+ * Policy modifier: builds goal bounding tables for every map and prunes the successors of A* and JPS with them (see GoalBounds).
+ * The tables are expensive to build: intended for small maps, or for larger ones with tables built offline (see Algorithm::load_preprocessed()).
+ */
+template<typename Base>
+struct GoalBounding : Base
+{
+    static constexpr bool goal_bounding = true;
+};
+
+/**
+ * Policy modifier: A*, JPS and Optimized A* use the distances from Count landmarks as the heuristic,
+ * where they give a larger bound than the octile distance (see Landmarks). Each landmark takes one Dijkstra search
+ * of the map to build and 2 bytes per cell, which pays off on maps with many walls between the beginning and the end.
+ */
+template<typename Base, int Count = 8>
+struct DifferentialHeuristic : Base
+{
+    static constexpr int landmarks = Count;
+};
+
+/**
+ * The policy used by the algorithm registry (see all_algorithms.cpp).
+ * The visualizer target defines PATHFINDING_VISUALIZER, every other target gets the headless algorithms.
+ */
+#ifdef PATHFINDING_VISUALIZER
+using RegistryPolicy = VisualPolicy;
+#else
+using RegistryPolicy = HeadlessPolicy;
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "algorithms/preprocessed_key.hpp"
+#include "algorithms/util.hpp"
+
+#include <cstring>
+
+/**
+ * The common header of saved preprocessed data.
+ */
+struct PreprocessedHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint64_t fingerprint;
+};
+
+bool PreprocessedKey::is_current(const State& s, const Grid& grid)
+{
+    if(source != &s || revision != s.revision || width != s.width || height != s.height)
+        return false;
+
+    if(!grid_known)
+    {
+        grid_generation = grid.get_generation();
+        grid_known = true;
+    }
+    return grid_generation == grid.get_generation();
+}
+
+bool PreprocessedKey::precedes(const State& s) const
+{
+    return source == &s && revision + 1 == s.revision && width == s.width && height == s.height;
+}
+
+void PreprocessedKey::set(const State& s, const Grid& grid)
+{
+    source = &s;
+    revision = s.revision;
+    width = s.width;
+    height = s.height;
+    fingerprint = Util::wall_fingerprint(s);
+    fingerprint_outdated = false;
+    grid_generation = grid.get_generation();
+    grid_known = true;
+}
+
+void PreprocessedKey::set_repaired(const State& s, const Grid& grid)
+{
+    revision = s.revision;
+    fingerprint_outdated = true;
+    grid_generation = grid.get_generation();
+    grid_known = true;
+}
+
+bool PreprocessedKey::write(std::ostream& out, const char (&magic)[4], uint32_t version) const
+{
+    if(source == nullptr || (fingerprint_outdated && source->revision != revision))
+        return false;
+
+    PreprocessedHeader header{{}, version, width, height, fingerprint_outdated ? Util::wall_fingerprint(*source) : fingerprint};
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return out.good();
+}
+
+bool PreprocessedKey::read(const State& s, std::istream& in, const char (&magic)[4], uint32_t version)
+{
+    PreprocessedHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good()
+    || std::memcmp(header.magic, magic, sizeof(header.magic)) != 0
+    || header.version != version
+    || header.width != s.width
+    || header.height != s.height
+    || header.fingerprint != Util::wall_fingerprint(s))
+    {
+        return false;
+    }
+
+    source = &s;
+    revision = s.revision;
+    width = s.width;
+    height = s.height;
+    fingerprint = header.fingerprint;
+    fingerprint_outdated = false;
+    grid_known = false;
+    return true;
+}
\ No newline at end of file
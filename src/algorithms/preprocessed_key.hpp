@@ -0,0 +1,88 @@
+#ifndef PREPROCESSED_KEY_HPP
+#define PREPROCESSED_KEY_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "state.hpp"
+#include "algorithms/grid.hpp"
+
+/**
+ * Identifies the map that preprocessed data (for example the jump distance tables of JPS+) was built or loaded for.
+ *
+ * The data is up to date while it is used with the same state, State::revision and size, and with a grid
+ * whose walls have not changed since (see Grid::get_generation()).
+ *
+ * Saved data starts with a common header: a magic, the version of the format, the size of the map and a fingerprint
+ * of its walls (see Util::wall_fingerprint()), so that it is only loaded for the map it was made for.
+ * The owner of the data writes the rest of it after the header.
+ */
+class PreprocessedKey
+{
+public:
+    /**
+     * Is the data up to date for the state and its grid?
+     * Data loaded with read() is tied to the grid when this is first called for it.
+     */
+    bool is_current(const State& state, const Grid& grid);
+
+    /**
+     * Can the data be repaired for a change of a single cell of the state, i.e. was it up to date
+     * before the State::revision was incremented once? See Algorithm::update_preprocessed().
+     */
+    bool precedes(const State& state) const;
+
+    /**
+     * Records that the data is built from the state and its grid, which must be up to date.
+     */
+    void set(const State& state, const Grid& grid);
+
+    /**
+     * Records that the data was repaired for the current revision of the state after precedes(),
+     * and the grid was updated for the change.
+     */
+    void set_repaired(const State& state, const Grid& grid);
+
+    /**
+     * Has the data been built or loaded?
+     */
+    bool empty() const
+    {
+        return source == nullptr;
+    }
+
+    /**
+     * Writes the header of the saved data.
+     *
+     * @returns Whether the header was written. False if the data has not been built, or if it was repaired
+     * and the state has changed since, so that the walls it was repaired for are no longer known.
+     */
+    bool write(std::ostream& out, const char (&magic)[4], uint32_t version) const;
+
+    /**
+     * Reads a header written by write() and records the state as the source of the data,
+     * so that read() can be called on a temporary key and the key of the data only replaced once the rest is read.
+     *
+     * @returns Whether the header was valid and made for the walls of the state.
+     */
+    bool read(const State& state, std::istream& in, const char (&magic)[4], uint32_t version);
+
+    int width = 0;
+    int height = 0;
+
+private:
+    const State* source = nullptr;
+    uint64_t revision = 0;
+    uint64_t fingerprint = 0;
+
+    // The generation of the grid the data was built for, unless it was loaded and not yet checked against a grid
+    uint32_t grid_generation = 0;
+    bool grid_known = false;
+
+    // Whether the data was repaired after the fingerprint was computed.
+    // Hashing all the walls would take longer than a repair, so the fingerprint is only computed when saving.
+    bool fingerprint_outdated = false;
+};
+
+#endif
\ No newline at end of file
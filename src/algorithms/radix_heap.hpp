@@ -0,0 +1,169 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms/layout.hpp"
+
+/**
+ * Monotone radix heap of (key, node index) pairs.
+ * Can be used as an open list (see open_list.hpp), with duplicates like LazyBinaryHeap.
+ *
+ * -----------------------------
+ * Usage notes:
+ *
+ * The keys must be non-negative, either integers of at most 64 bits or floats.
+ *
+ * The heap is monotone: the keys pushed should not be lower than the last popped key.
+ * This holds for A* and JPS with a consistent heuristic like the octile distance.
+ * Unlike BucketQueue there is no window of valid keys: a key lower than the last popped key is not an error,
+ * it is simply treated as equal to the last popped key (i.e. it is popped next).
+ * JPS relies on this when it pushes the end node with the key 0.
+ *
+ * Ties are popped in no particular order.
+ *
+ *
+ * -----------------------------
+ * Implementation notes:
+ *
+ * Every key is encoded into an unsigned integer whose order matches the order of the keys:
+ * 64 bits for 64-bit integer keys, 32 bits otherwise. For non-negative floats the bit pattern itself is such an integer.
+ *
+ * With B bits, the entries are divided into B + 1 buckets according to the highest bit in which their key differs
+ * from the last popped key:
+ *  - bucket 0:      key == last
+ *  - bucket i > 0:  the highest differing bit is bit i - 1, i.e. std::bit_width(key ^ last) == i
+ * As every key is at least last, the keys of bucket i are lower than the keys of any bucket above it.
+ *
+ * When bucket 0 is empty on top() or pop(), the lowest nonempty bucket is found and its lowest key becomes the new last.
+ * All the entries of that bucket then move into strictly lower buckets, because they share more high bits with the new last.
+ * Each entry can only move down B times, so every operation takes O(log C) amortized time,
+ * where C is the largest difference between a pushed key and the last popped key.
+ *
+ * The buckets keep their memory between searches.
+ */
+template<typename Key>
+class RadixHeap
+{
+public:
+    static constexpr bool has_duplicates = true;
+
+    void init(size_t)
+    {
+        for(auto& bucket : buckets)
+            bucket.clear();
+        amount = 0;
+        last = 0;
+    }
+
+    bool empty() const
+    {
+        return amount == 0;
+    }
+
+    size_t size() const
+    {
+        return amount;
+    }
+
+    void push(Key key, node_index node)
+    {
+        Encoded encoded = std::max(encode(key), last);
+        buckets[bucket_of(encoded)].push_back({encoded, node});
+        amount++;
+    }
+
+    std::pair<Key, node_index> top()
+    {
+        pull();
+        auto& entry = buckets[0].back();
+        return {decode(entry.key), entry.node};
+    }
+
+    void pop()
+    {
+        pull();
+        buckets[0].pop_back();
+        amount--;
+    }
+
+    size_t get_memory_usage() const
+    {
+        size_t bytes = 0;
+        for(auto& bucket : buckets)
+            bytes += bucket.capacity() * sizeof(Entry);
+        return bytes;
+    }
+
+private:
+    using Encoded = std::conditional_t<!std::is_floating_point_v<Key> && (sizeof(Key) > 4), uint64_t, uint32_t>;
+
+    struct Entry
+    {
+        Encoded key;
+        node_index node;
+    };
+
+    std::array<std::vector<Entry>, std::numeric_limits<Encoded>::digits + 1> buckets;
+    size_t amount = 0;
+
+    // The last popped key, encoded
+    Encoded last = 0;
+
+    static Encoded encode(Key key)
+    {
+        if constexpr(std::is_floating_point_v<Key>)
+            return std::bit_cast<uint32_t>(std::max((float)key, 0.0f));
+        else
+            return key;
+    }
+
+    static Key decode(Encoded key)
+    {
+        if constexpr(std::is_floating_point_v<Key>)
+            return std::bit_cast<float>(key);
+        else
+            return key;
+    }
+
+    uint32_t bucket_of(Encoded key) const
+    {
+        return std::bit_width(key ^ last);
+    }
+
+    /**
+     * Makes sure that bucket 0 is nonempty by redistributing the lowest nonempty bucket.
+     * The heap must not be empty.
+     */
+    void pull()
+    {
+        if(!buckets[0].empty())
+            return;
+
+        uint32_t i = 1;
+        while(buckets[i].empty())
+            ++i;
+
+        auto& bucket = buckets[i];
+        last = std::min_element(bucket.begin(), bucket.end(), [](const Entry& a, const Entry& b)
+        {
+            return a.key < b.key;
+        })->key;
+
+        for(auto& entry : bucket)
+            buckets[bucket_of(entry.key)].push_back(entry);
+        bucket.clear();
+    }
+};
+
+static_assert(std::numeric_limits<float>::is_iec559, "RadixHeap assumes IEEE 754 floats.");
+
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algorithms/layout.hpp"
+#include "algorithms/scratch_pool.hpp"
+#include "algorithms/util.hpp"
+
+/**
+ * The generation-stamped node storage shared by all search algorithms.
+ *
+ * Instead of initializing every node at the beginning of a run, each node is stamped with the id of the run
+ * that last accessed it (see SearchNode). A node is reset to its default state the first time it is touched
+ * during a run, i.e. when its stamp does not match the current run id.
+ *
+ * The run ids only fit into Node::GENERATION_MASK, so they eventually run out: after 2^29 runs with the default
+ * stamps (days of continuous queries on a busy server), or after 8191 runs with 16-bit stamps.
+ * A stamp left from before the wraparound could then match the current run id and an old node would be taken as valid.
+ * To prevent this, when the run ids run out the arena starts a new epoch: the records of the current map are reset
+ * with a bulk fill and the run ids start again from 1. The cost of the fill is spread over all the runs of the epoch.
+ * The rest of the memory block is only reset if a larger map needs it later, so switching maps never causes a bulk fill
+ * of the whole high-water mark.
+ *
+ * The memory is leased from the scratch pool for the map of the run (see scratch_pool.hpp),
+ * so the arena only grows and survives switching between maps.
+ */
+template<typename Node>
+class ScratchArena
+{
+public:
+    /**
+     * Starts a new run over the node indices [0, size) of the map generation identified by the key.
+     *
+     * @returns The id of the new run.
+     */
+    uint32_t begin_run(size_t size, ScratchKey key = {})
+    {
+        nodes.lease(size, key);
+        run_id = nodes.next_generation();
+        if(run_id > Node::GENERATION_MASK)
+        {
+            nodes.bulk_reset(size);
+            epoch++;
+            run_id = nodes.next_generation();
+        }
+        return run_id;
+    }
+
+    /**
+     * Gets the node, resetting it first if it has not been accessed during the current run.
+     */
+    Node& touch(node_index idx)
+    {
+        Node& node = nodes[idx];
+        Util::lazy_initialize(run_id, node);
+        return node;
+    }
+
+    /**
+     * Gets the node if it has been touched during the current run, or nullptr. Does not touch the node.
+     */
+    Node* lookup(node_index idx)
+    {
+        Node& node = nodes[idx];
+        return node.is_current(run_id) ? &node : nullptr;
+    }
+
+    /**
+     * Gets the node without checking its stamp. The node must have been touched during the current run.
+     */
+    Node& operator[](node_index idx)
+    {
+        return nodes[idx];
+    }
+
+    uint32_t get_run_id() const
+    {
+        return run_id;
+    }
+
+    /**
+     * Gets the amount of bulk resets done so far.
+     */
+    uint32_t get_epoch() const
+    {
+        return epoch;
+    }
+
+    size_t get_memory_usage() const
+    {
+        return nodes.get_memory_usage();
+    }
+
+private:
+    ScratchBuffer<Node> nodes;
+    uint32_t run_id = 0;
+    uint32_t epoch = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,311 @@
+#ifndef SCRATCH_POOL_HPP
+#define SCRATCH_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Identifies a map generation: the State a node array is used for and the revision of its walls.
+ * The key is only a hint for reusing memory. Whether a node is valid is decided by the stamps alone.
+ */
+struct ScratchKey
+{
+    const void* map = nullptr;
+    uint64_t revision = 0;
+
+    bool operator==(const ScratchKey&) const = default;
+};
+
+/**
+ * A block of scratch memory for a node array, with the generation counter of its stamps.
+ *
+ * The nodes in the block are reset lazily (see Util::lazy_initialize()): a node is only valid for the run
+ * whose id matches its stamp. The generation counter is stored with the memory instead of the algorithm,
+ * so that whoever uses the block next continues from the same counter and every old stamp stays stale.
+ */
+template<typename T>
+struct ScratchBlock
+{
+    std::vector<T> data;
+    uint32_t generation = 0;
+
+    // The map generation the block was last leased for.
+    ScratchKey key;
+
+    // The elements from this index on still hold stamps from before the last bulk reset, and are reset before they are used.
+    size_t clean = 0;
+
+    /**
+     * Grows the block to the specified size. The new elements hold default records.
+     */
+    void grow(size_t size)
+    {
+        if(clean == data.size())
+            clean = size;
+        data.resize(size);
+    }
+};
+
+/**
+ * The process-wide pool of free scratch blocks of type T.
+ *
+ * The node arrays of the algorithms lease their blocks from the pool for one map at a time (see ScratchBuffer::lease()),
+ * so the memory of an algorithm that moves on to another map is available to the other algorithms,
+ * and algorithms that are created and destroyed repeatedly (e.g. one per query) do not allocate and zero-initialize their node arrays every time.
+ *
+ * Each thread keeps up to THREAD_BLOCKS free blocks of its own, which it gives and takes without locking.
+ * A server thread that switches between many maps thus trades blocks with itself on almost every query,
+ * and only takes the lock of the shared list when its own blocks are all too small, or when it holds too many.
+ * The blocks of a thread go back into the shared list when the thread exits.
+ */
+template<typename T>
+class ScratchPool
+{
+public:
+    /**
+     * The amount of free blocks a thread keeps for itself. The oldest ones above it go into the shared list.
+     */
+    static constexpr size_t THREAD_BLOCKS = 8;
+
+    /**
+     * Gets the pool. It is never destroyed, so that the algorithms in static storage (e.g. the algorithm list) can still return their blocks at exit.
+     */
+    static ScratchPool& shared()
+    {
+        static ScratchPool* pool = new ScratchPool;
+        return *pool;
+    }
+
+    /**
+     * Takes a free block of at least the specified size: the block last leased for the same map if there is one,
+     * otherwise the smallest one that is large enough, from the blocks of the thread first and then from the shared list.
+     * If no free block is large enough, the largest one is grown,
+     * so the pool never holds more blocks than there have been node arrays at the same time.
+     */
+    ScratchBlock<T> take(size_t size, ScratchKey key)
+    {
+        std::vector<ScratchBlock<T>>* local = thread_cache_destroyed ? nullptr : &thread_cache().blocks;
+        if(local != nullptr)
+        {
+            auto best = select(*local, size, key);
+            if(best != local->end() && best->data.size() >= size)
+                return remove(*local, best);
+        }
+
+        ScratchBlock<T> block;
+        {
+            std::lock_guard lock(mutex);
+            if(!free_blocks.empty())
+                block = remove(free_blocks, select(free_blocks, size, key));
+        }
+        // Without shared blocks, the largest block of the thread is grown instead of allocating another one.
+        if(block.data.empty() && local != nullptr && !local->empty())
+            block = remove(*local, select(*local, size, key));
+
+        if(block.data.size() < size)
+            block.grow(size);
+        return block;
+    }
+
+    /**
+     * Returns a block into the pool: among the blocks of the thread, or into the shared list if it holds too many.
+     */
+    void give(ScratchBlock<T>&& block)
+    {
+        if(block.data.empty())
+            return;
+
+        if(!thread_cache_destroyed)
+        {
+            auto& blocks = thread_cache().blocks;
+            blocks.push_back(std::move(block));
+            if(blocks.size() <= THREAD_BLOCKS)
+                return;
+            block = remove(blocks, blocks.begin());
+        }
+
+        std::lock_guard lock(mutex);
+        free_blocks.push_back(std::move(block));
+    }
+
+    /**
+     * Gets the amount of memory held by the free blocks of the shared list and of the calling thread in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        size_t bytes = 0;
+        if(!thread_cache_destroyed)
+        {
+            for(auto& block : thread_cache().blocks)
+                bytes += block.data.capacity() * sizeof(T);
+        }
+
+        std::lock_guard lock(mutex);
+        for(auto& block : free_blocks)
+            bytes += block.data.capacity() * sizeof(T);
+        return bytes;
+    }
+
+private:
+    /**
+     * The free blocks of a thread, returned into the shared list when the thread exits.
+     */
+    struct ThreadCache
+    {
+        std::vector<ScratchBlock<T>> blocks;
+
+        ~ThreadCache()
+        {
+            thread_cache_destroyed = true;
+            auto& pool = shared();
+            std::lock_guard lock(pool.mutex);
+            for(auto& block : blocks)
+                pool.free_blocks.push_back(std::move(block));
+        }
+    };
+
+    ScratchPool() {}
+
+    mutable std::mutex mutex;
+    std::vector<ScratchBlock<T>> free_blocks;
+
+    // Set when the cache of the thread has been destroyed, e.g. for the node arrays of static algorithms destroyed after it,
+    // which then use the shared list directly. A plain flag, so it can still be read after the cache is gone.
+    static inline thread_local bool thread_cache_destroyed = false;
+
+    static ThreadCache& thread_cache()
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    /**
+     * Selects the block to take from the list: the block last leased for the same map if it is large enough,
+     * otherwise the smallest one that is large enough, otherwise the largest one. end() if the list is empty.
+     */
+    static auto select(std::vector<ScratchBlock<T>>& blocks, size_t size, ScratchKey key)
+    {
+        auto best = blocks.end();
+        for(auto it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            if(it->data.size() >= size && it->key == key)
+                return it;
+            if(it->data.size() >= size && (best == blocks.end() || it->data.size() < best->data.size()))
+                best = it;
+        }
+
+        if(best == blocks.end())
+        {
+            best = std::max_element(blocks.begin(), blocks.end(),
+                [](auto& a, auto& b) { return a.data.size() < b.data.size(); });
+        }
+        return best;
+    }
+
+    static ScratchBlock<T> remove(std::vector<ScratchBlock<T>>& blocks, typename std::vector<ScratchBlock<T>>::iterator it)
+    {
+        ScratchBlock<T> block = std::move(*it);
+        blocks.erase(it);
+        return block;
+    }
+};
+
+/**
+ * A node array of an algorithm, backed by a block leased from the scratch pool.
+ *
+ * The algorithm leases the block at the beginning of every run and keeps it for as long as it searches the same map.
+ * On a map change, the block goes back into the pool and the block last used for the new map is taken if it is free.
+ * Blocks only ever grow, up to the largest map they have been used for (the high-water mark):
+ * a query on a smaller map simply uses the beginning of the block, so alternating between maps of different sizes
+ * neither reallocates nor re-initializes anything. The stamps of the nodes left over from other maps are simply stale.
+ */
+template<typename T>
+class ScratchBuffer
+{
+public:
+    ScratchBuffer() {}
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    ~ScratchBuffer()
+    {
+        ScratchPool<T>::shared().give(std::move(block));
+    }
+
+    /**
+     * Makes sure the buffer holds at least the specified amount of elements for the map generation of the key.
+     * When the key changes or the block is too small, the block is returned into the pool and another one is taken from it.
+     */
+    void lease(size_t size, ScratchKey key = {})
+    {
+        if(block.key != key || block.data.size() < size)
+        {
+            auto& pool = ScratchPool<T>::shared();
+            auto generation = block.generation;
+            pool.give(std::move(block));
+            block = pool.take(size, key);
+            block.key = key;
+
+            // Both counters are larger than any stamp in their own block, so the larger of the two is safe for the new block.
+            block.generation = std::max(block.generation, generation);
+        }
+
+        if(block.clean < size)
+        {
+            std::fill(block.data.begin() + block.clean, block.data.begin() + size, T{});
+            block.clean = size;
+        }
+    }
+
+    /**
+     * Starts a new run: returns a run id that no element of the buffer has been stamped with yet.
+     */
+    uint32_t next_generation()
+    {
+        return ++block.generation;
+    }
+
+    /**
+     * Resets the first elements of the buffer to their default value and restarts the generation counter from 0.
+     * The rest of the buffer is reset when a later lease needs it (e.g. for a larger map).
+     * A plain fill with a default record, which compiles into wide vector stores.
+     */
+    void bulk_reset(size_t size)
+    {
+        std::fill(block.data.begin(), block.data.begin() + size, T{});
+        block.generation = 0;
+        block.clean = size;
+    }
+
+    T& operator[](size_t idx)
+    {
+        return block.data[idx];
+    }
+
+    const T& operator[](size_t idx) const
+    {
+        return block.data[idx];
+    }
+
+    size_t size() const
+    {
+        return block.data.size();
+    }
+
+    /**
+     * Gets the amount of memory used by the buffer in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return block.data.capacity() * sizeof(T);
+    }
+
+private:
+    ScratchBlock<T> block;
+};
+
+#endif
\ No newline at end of file
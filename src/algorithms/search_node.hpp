@@ -0,0 +1,81 @@
+#ifndef SEARCH_NODE_HPP
+#define SEARCH_NODE_HPP
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * The compact node record shared by all search algorithms.
+ *
+ * Each node only holds its "hot" data, i.e. the data read on every examination:
+ *  -lowest seen distance from the beginning, of type Distance (see cost.hpp)
+ *  -a packed "stamp" containing both the status of the node and the last run / generation it was accessed in
+ *
+ * The lowest STATUS_BITS bits of the stamp hold the status. Each algorithm defines its own status values
+ * by deriving from this structure (see for example InternalNode in common.hpp).
+ * The rest of the bits hold the generation, i.e. the last pathfinding task / run index when this node was accessed.
+ * See ScratchArena and the "Performance remarks" in docs/structure.md for why the generation exists.
+ *
+ * The stamp is a uint32_t by default, which leaves 29 bits for the generation.
+ * With a uint16_t Stamp only 13 bits are left, so the ScratchArena has to reset the records every 8191 runs,
+ * but the record shrinks from 8 to 6 bytes. The records are packed to 2-byte alignment for this reason.
+ *
+ * The index of the previous node (the "prev" of the node) is "cold" data:
+ * it is only written when a shorter path is found and read when the path is built.
+ * It is therefore not stored here, but in a separate flat array of node_index values indexed in the same way.
+ * This way a single node record takes 8 bytes and the parent 4 bytes,
+ * instead of the 24 bytes (with padding) of a record containing a size_t index, a float, a uint32_t and a status byte.
+ * The 64-bit distances of OctileIntegerCost grow the record to 12 bytes.
+ */
+#pragma pack(push, 2)
+template<typename Distance = float, typename Stamp = uint32_t>
+struct SearchNode
+{
+    static constexpr uint32_t STATUS_BITS       = 3;
+    static constexpr uint32_t STATUS_MASK       = (1u << STATUS_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK   = std::numeric_limits<Stamp>::max() >> STATUS_BITS;
+
+    // The distance of nodes not reached yet: infinity for floating point distances, the largest value for integers.
+    static constexpr Distance INFINITE_DISTANCE = std::numeric_limits<Distance>::has_infinity
+        ? std::numeric_limits<Distance>::infinity()
+        : std::numeric_limits<Distance>::max();
+
+    Distance distance   = INFINITE_DISTANCE;
+    Stamp stamp         = 0;
+
+    uint8_t status() const
+    {
+        return stamp & STATUS_MASK;
+    }
+
+    void set_status(uint8_t status)
+    {
+        stamp = (stamp & ~STATUS_MASK) | status;
+    }
+
+    /**
+     * Has this node been accessed during the specified run?
+     * Only the lowest bits of the run id fitting into the stamp are compared.
+     */
+    bool is_current(uint32_t run_id) const
+    {
+        return (stamp >> STATUS_BITS) == (run_id & GENERATION_MASK);
+    }
+
+    /**
+     * Resets the node to its default state (infinite distance, status 0) for the specified run.
+     */
+    void reset(uint32_t run_id)
+    {
+        distance = INFINITE_DISTANCE;
+        stamp = (run_id & GENERATION_MASK) << STATUS_BITS;
+    }
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SearchNode<float>) == 8, "SearchNode should stay 8 bytes large.");
+static_assert(sizeof(SearchNode<int32_t>) == 8, "SearchNode should stay 8 bytes large.");
+static_assert(sizeof(SearchNode<int64_t>) == 12, "SearchNode with 64-bit integer distances should be 12 bytes large.");
+static_assert(sizeof(SearchNode<float, uint16_t>) == 6, "SearchNode with narrow stamps should be 6 bytes large.");
+
+#endif
\ No newline at end of file
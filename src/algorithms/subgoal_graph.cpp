@@ -0,0 +1,518 @@
+#include "algorithms/subgoal_graph.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/radix_heap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <thread>
+
+/**
+ * The header of the saved graph after the common header (see PreprocessedKey).
+ */
+struct SubgoalGraphHeader
+{
+    uint32_t two_level;
+    uint32_t node_count;
+    uint32_t first_global;
+    uint32_t edge_count;
+};
+
+static constexpr char SUBGOAL_GRAPH_MAGIC[4] = {'S', 'U', 'B', 'G'};
+static constexpr uint32_t SUBGOAL_GRAPH_VERSION = 2;
+
+/**
+ * A cell never reached by the scans, for finding only the subgoals.
+ */
+static constexpr Point NO_TARGET = {-1, -1};
+
+/**
+ * Gets the direction of the movement (dx, dy), where dx and dy are -1, 0 or 1 and not both 0.
+ */
+static dir_t direction_of(int dx, int dy)
+{
+    for(int i = 0; i < 8; ++i)
+    {
+        if(directions[i]->movement == std::pair{dx, dy})
+            return directions[i];
+    }
+    return nullptr;
+}
+
+/**
+ * Adds an edge, or shortens the existing edge between the nodes.
+ */
+static void add_edge(std::vector<SubgoalGraph::Edge>& edges, uint32_t to, int32_t cost, uint32_t middle)
+{
+    for(auto& edge : edges)
+    {
+        if(edge.to == to)
+        {
+            if(cost < edge.cost)
+                edge = {to, cost, middle};
+            return;
+        }
+    }
+    edges.push_back({to, cost, middle});
+}
+
+struct SubgoalGraph::Contraction
+{
+    // The edges between the subgoals not removed yet, in both directions.
+    // A removed subgoal keeps its edges to the subgoals that were left.
+    std::vector<std::vector<Edge>> adjacency;
+
+    // The buffers of the witness searches; distances are only valid when the stamp is the current run
+    std::vector<int32_t> distances;
+    std::vector<uint32_t> stamps;
+    uint32_t run_id = 0;
+    RadixHeap<int32_t> open;
+
+    // The shortcuts needed for removing the current subgoal
+    std::vector<std::pair<std::pair<uint32_t, uint32_t>, int32_t>> shortcuts;
+
+    explicit Contraction(std::vector<std::vector<Edge>>&& adjacency)
+        : adjacency(std::move(adjacency)), distances(this->adjacency.size()), stamps(this->adjacency.size(), 0)
+    {
+    }
+
+    int32_t get_distance(uint32_t node) const
+    {
+        return stamps[node] == run_id ? distances[node] : std::numeric_limits<int32_t>::max();
+    }
+
+    /**
+     * Runs a Dijkstra search from the source around the avoided node, up to max_distance or WITNESS_SETTLE_LIMIT settled nodes.
+     */
+    void witness_search(uint32_t source, uint32_t avoided, int32_t max_distance)
+    {
+        run_id++;
+        distances[source] = 0;
+        stamps[source] = run_id;
+        open.init(0);
+        open.push(0, source);
+
+        int settled = 0;
+        while(!open.empty() && settled++ < WITNESS_SETTLE_LIMIT)
+        {
+            auto [distance, node] = open.top();
+            open.pop();
+            if(distance > get_distance(node))
+                continue;
+
+            for(const Edge& edge : adjacency[node])
+            {
+                int32_t new_distance = distance + edge.cost;
+                if(edge.to != avoided && new_distance <= max_distance && new_distance < get_distance(edge.to))
+                {
+                    distances[edge.to] = new_distance;
+                    stamps[edge.to] = run_id;
+                    open.push(new_distance, edge.to);
+                }
+            }
+        }
+    }
+
+    /**
+     * Removes the node from the graph if all the shortcuts needed between its neighbours are as long as their octile distances,
+     * and adds the shortcuts.
+     *
+     * @returns Whether the node was removed, i.e. made local.
+     */
+    bool remove(const SubgoalGraph& graph, uint32_t node)
+    {
+        const std::vector<Edge>& edges = adjacency[node];
+        shortcuts.clear();
+        for(size_t i = 0; i + 1 < edges.size(); ++i)
+        {
+            int32_t max_distance = 0;
+            for(size_t j = i + 1; j < edges.size(); ++j)
+                max_distance = std::max(max_distance, edges[i].cost + edges[j].cost);
+
+            witness_search(edges[i].to, node, max_distance);
+            Point from = graph.get_cell(edges[i].to);
+            for(size_t j = i + 1; j < edges.size(); ++j)
+            {
+                int32_t distance = edges[i].cost + edges[j].cost;
+                if(get_distance(edges[j].to) <= distance)
+                    continue;
+
+                Point to = graph.get_cell(edges[j].to);
+                if(distance != OctileIntegerCost<>::heuristic(from.x, from.y, to.x, to.y))
+                    return false;
+                shortcuts.push_back({{edges[i].to, edges[j].to}, distance});
+            }
+        }
+
+        for(auto [ends, distance] : shortcuts)
+        {
+            add_edge(adjacency[ends.first], ends.second, distance, node);
+            add_edge(adjacency[ends.second], ends.first, distance, node);
+        }
+        for(const Edge& edge : edges)
+        {
+            auto& neighbour_edges = adjacency[edge.to];
+            neighbour_edges.erase(std::find_if(neighbour_edges.begin(), neighbour_edges.end(), [&](const Edge& e) { return e.to == node; }));
+        }
+        return true;
+    }
+};
+
+bool SubgoalGraph::update(const State& s, const Grid& grid, bool levels)
+{
+    build_time = 0;
+    if(key.is_current(s, grid) && two_level == levels)
+        return false;
+
+    build(s, grid, levels);
+    return true;
+}
+
+void SubgoalGraph::index_nodes(const State& s)
+{
+    cell_nodes.assign(size_t(key.width) * key.height, NO_NODE);
+    for(uint32_t node = 0; node < node_cells.size(); ++node)
+        cell_nodes[node_cells[node]] = node;
+
+    // Only built once from the copy, so the grid never compares its source with another state.
+    State blocked;
+    blocked.width = key.width;
+    blocked.height = key.height;
+    blocked.map = s.map;
+    for(auto cell : node_cells)
+        blocked.map[cell] = Node::WALL;
+    blockers.build(blocked, false, true);
+}
+
+void SubgoalGraph::build(const State& s, const Grid& grid, bool levels)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    key.set(s, grid);
+    two_level = levels;
+
+    // The subgoals in the map order
+    node_cells.clear();
+    for(int y = 0; y < key.height; ++y)
+    {
+        for(int x = 0; x < key.width; ++x)
+        {
+            if(grid.is_wall(x, y))
+                continue;
+
+            for(int i = 1; i < 8; i += 2)
+            {
+                auto [dx, dy] = directions[i]->movement;
+                if(grid.is_wall(x + dx, y + dy) && grid.is_empty(x + dx, y) && grid.is_empty(x, y + dy))
+                {
+                    node_cells.push_back(y * key.width + x);
+                    break;
+                }
+            }
+        }
+    }
+    index_nodes(s);
+
+    // Each thread takes the next subgoal and only writes its edges, so no locking is needed.
+    uint32_t node_count = node_cells.size();
+    std::vector<std::vector<Edge>> adjacency(node_count);
+    std::atomic<uint32_t> next_node = 0;
+    auto work = [&]()
+    {
+        for(uint32_t node = next_node++; node < node_count; node = next_node++)
+        {
+            Point cell = get_cell(node);
+            find_direct_h_reachable(grid, cell.x, cell.y, NO_TARGET, NO_NODE, adjacency[node]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned int i = 1; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        threads.emplace_back(work);
+    work();
+    for(auto& thread : threads)
+        thread.join();
+
+    // The scans are not always symmetric, so the edges are added in both directions.
+    for(uint32_t node = 0; node < node_count; ++node)
+    {
+        for(size_t i = 0; i < adjacency[node].size(); ++i)
+        {
+            Edge edge = adjacency[node][i];
+            add_edge(adjacency[edge.to], node, edge.cost, NO_NODE);
+        }
+    }
+
+    // Remove the local subgoals, and number them first in the order of removal.
+    Contraction contraction(std::move(adjacency));
+    std::vector<uint32_t> order;
+    order.reserve(node_count);
+    std::vector<bool> removed(node_count, false);
+    if(two_level)
+    {
+        for(uint32_t node = 0; node < node_count; ++node)
+        {
+            if(contraction.remove(*this, node))
+            {
+                order.push_back(node);
+                removed[node] = true;
+            }
+        }
+    }
+    first_global = order.size();
+    for(uint32_t node = 0; node < node_count; ++node)
+    {
+        if(!removed[node])
+            order.push_back(node);
+    }
+
+    std::vector<uint32_t> ids(node_count);
+    for(uint32_t id = 0; id < node_count; ++id)
+        ids[order[id]] = id;
+
+    std::vector<uint32_t> cells = node_cells;
+    edge_offsets.assign(node_count + 1, 0);
+    edges.clear();
+    shortcut_count = 0;
+    for(uint32_t id = 0; id < node_count; ++id)
+    {
+        uint32_t node = order[id];
+        node_cells[id] = cells[node];
+        cell_nodes[cells[node]] = id;
+        for(const Edge& edge : contraction.adjacency[node])
+        {
+            edges.push_back({ids[edge.to], edge.cost, edge.middle == NO_NODE ? NO_NODE : ids[edge.middle]});
+            shortcut_count += edge.middle != NO_NODE;
+        }
+        edge_offsets[id + 1] = edges.size();
+    }
+    edges.shrink_to_fit();
+
+    build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+int SubgoalGraph::clearance(const Grid& grid, int x, int y, dir_t dir, Point target, uint32_t target_node, uint32_t& hit) const
+{
+    auto [dx, dy] = dir->movement;
+    if(!dir->straight)
+    {
+        int steps = 0;
+        while(Util::is_move_valid(grid, x, y, dir))
+        {
+            x += dx;
+            y += dy;
+            if(x == target.x && y == target.y)
+            {
+                hit = target_node;
+                return steps;
+            }
+            if(cell_nodes[y * key.width + x] != NO_NODE)
+            {
+                hit = cell_nodes[y * key.width + x];
+                return steps;
+            }
+            steps++;
+        }
+        hit = NO_NODE;
+        return steps;
+    }
+
+    // The straight scans read 64 cells of the blockers at a time, like JPS-B.
+    int steps = 0;
+    while(true)
+    {
+        int run;
+        if(dx > 0)
+            run = std::countr_one(blockers.row_from(x + 1 + steps, y));
+        else if(dx < 0)
+            run = std::countl_one(blockers.row_until(x - 1 - steps, y));
+        else if(dy > 0)
+            run = std::countr_one(blockers.column_from(x, y + 1 + steps));
+        else
+            run = std::countl_one(blockers.column_until(x, y - 1 - steps));
+
+        steps += run;
+        if(run < 64)
+            break;
+    }
+
+    int target_steps = dx != 0 ? (target.x - x) * dx : (target.y - y) * dy;
+    bool on_line = dx != 0 ? target.y == y : target.x == x;
+    if(on_line && target_steps >= 1 && target_steps <= steps)
+    {
+        hit = target_node;
+        return target_steps - 1;
+    }
+
+    // The cell after the free steps is either a wall or a subgoal.
+    int next_x = x + (steps + 1) * dx;
+    int next_y = y + (steps + 1) * dy;
+    hit = grid.is_empty(next_x, next_y) ? cell_nodes[next_y * key.width + next_x] : NO_NODE;
+    return steps;
+}
+
+void SubgoalGraph::find_direct_h_reachable(const Grid& grid, int x, int y, Point target, uint32_t target_node, std::vector<Edge>& found) const
+{
+    using Cost = OctileIntegerCost<>;
+
+    // The subgoals in a straight line from (x, y)
+    uint32_t hit;
+    for(int i = 0; i < 8; ++i)
+    {
+        int steps = clearance(grid, x, y, directions[i], target, target_node, hit);
+        if(hit != NO_NODE)
+            found.push_back({hit, int32_t((steps + 1) * Cost::move(directions[i])), NO_NODE});
+    }
+
+    // The subgoals reached by moving diagonally, and then straight in one of the components of the diagonal.
+    // Once a subgoal (or a wall) is found in a straight direction, the scans further along the diagonal stop before it,
+    // as the paths past it would go through it or around it.
+    for(int i = 1; i < 8; i += 2)
+    {
+        dir_t diagonal = directions[i];
+        dir_t components[2] = {diagonal->components.first, diagonal->components.second};
+        int max_steps[2];
+        for(int k = 0; k < 2; ++k)
+            max_steps[k] = clearance(grid, x, y, components[k], target, target_node, hit);
+
+        int diagonal_steps = clearance(grid, x, y, diagonal, target, target_node, hit);
+        for(int d = 1; d <= diagonal_steps && (max_steps[0] >= 0 || max_steps[1] >= 0); ++d)
+        {
+            int cell_x = x + d * diagonal->movement.first;
+            int cell_y = y + d * diagonal->movement.second;
+            for(int k = 0; k < 2; ++k)
+            {
+                int steps = clearance(grid, cell_x, cell_y, components[k], target, target_node, hit);
+                if(steps <= max_steps[k] && hit != NO_NODE)
+                {
+                    found.push_back({hit, int32_t(d * Cost::DIAGONAL + (steps + 1) * Cost::STRAIGHT), NO_NODE});
+                    steps--;
+                }
+                max_steps[k] = std::min(max_steps[k], steps);
+            }
+        }
+    }
+}
+
+void SubgoalGraph::append_edge(const Grid& grid, Point a, Point b, std::vector<Point>& cells)
+{
+    int diff_x = b.x - a.x;
+    int diff_y = b.y - a.y;
+    int diagonal_steps = std::min(std::abs(diff_x), std::abs(diff_y));
+    int straight_steps = std::max(std::abs(diff_x), std::abs(diff_y)) - diagonal_steps;
+    if(diagonal_steps + straight_steps == 0)
+        return;
+
+    int dx = (diff_x > 0) - (diff_x < 0);
+    int dy = (diff_y > 0) - (diff_y < 0);
+    dir_t diagonal = diagonal_steps > 0 ? direction_of(dx, dy) : nullptr;
+    dir_t straight = std::abs(diff_x) > std::abs(diff_y) ? direction_of(dx, 0) : direction_of(0, dy);
+
+    auto walk = [&](dir_t first, int first_steps, dir_t second, int second_steps, bool append)
+    {
+        int x = a.x;
+        int y = a.y;
+        for(int i = 0; i < first_steps + second_steps; ++i)
+        {
+            dir_t dir = i < first_steps ? first : second;
+            if(!append && !Util::is_move_valid(grid, x, y, dir))
+                return false;
+            x += dir->movement.first;
+            y += dir->movement.second;
+            if(append)
+                cells.push_back({x, y});
+        }
+        return true;
+    };
+
+    // The edges found from a are free diagonally first, the edges found from b the other way around.
+    if(walk(diagonal, diagonal_steps, straight, straight_steps, false))
+        walk(diagonal, diagonal_steps, straight, straight_steps, true);
+    else
+        walk(straight, straight_steps, diagonal, diagonal_steps, true);
+}
+
+const SubgoalGraph::Edge* SubgoalGraph::find_edge(uint32_t a, uint32_t b) const
+{
+    auto [first, last] = get_edges(std::min(a, b));
+    for(auto edge = first; edge != last; ++edge)
+    {
+        if(edge->to == std::max(a, b))
+            return edge;
+    }
+    return nullptr;
+}
+
+void SubgoalGraph::unpack(const Grid& grid, uint32_t a, uint32_t b, std::vector<Point>& cells) const
+{
+    // The edges still to unpack, the next one on the top
+    std::vector<std::pair<uint32_t, uint32_t>> stack = {{a, b}};
+    while(!stack.empty())
+    {
+        auto [from, to] = stack.back();
+        stack.pop_back();
+
+        // The middle subgoal of a shortcut was removed before both of its ends, so both halves are its edges.
+        const Edge* edge = find_edge(from, to);
+        if(edge->middle == NO_NODE)
+        {
+            append_edge(grid, get_cell(from), get_cell(to), cells);
+        }
+        else
+        {
+            stack.push_back({edge->middle, to});
+            stack.push_back({from, edge->middle});
+        }
+    }
+}
+
+bool SubgoalGraph::save(std::ostream& out) const
+{
+    if(!key.write(out, SUBGOAL_GRAPH_MAGIC, SUBGOAL_GRAPH_VERSION))
+        return false;
+
+    SubgoalGraphHeader header{two_level, uint32_t(node_cells.size()), first_global, uint32_t(edges.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(node_cells.data()), node_cells.size() * sizeof(node_cells[0]));
+    out.write(reinterpret_cast<const char*>(edge_offsets.data()), edge_offsets.size() * sizeof(edge_offsets[0]));
+    out.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(edges[0]));
+    return out.good();
+}
+
+bool SubgoalGraph::load(const State& s, bool levels, std::istream& in)
+{
+    PreprocessedKey loaded_key;
+    if(!loaded_key.read(s, in, SUBGOAL_GRAPH_MAGIC, SUBGOAL_GRAPH_VERSION))
+        return false;
+
+    SubgoalGraphHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good()
+    || header.two_level != levels
+    || header.first_global > header.node_count)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> loaded_cells(header.node_count);
+    std::vector<uint32_t> loaded_edge_offsets(header.node_count + 1);
+    std::vector<Edge> loaded_edges(header.edge_count);
+    in.read(reinterpret_cast<char*>(loaded_cells.data()), loaded_cells.size() * sizeof(loaded_cells[0]));
+    in.read(reinterpret_cast<char*>(loaded_edge_offsets.data()), loaded_edge_offsets.size() * sizeof(loaded_edge_offsets[0]));
+    in.read(reinterpret_cast<char*>(loaded_edges.data()), loaded_edges.size() * sizeof(loaded_edges[0]));
+    if(!in.good())
+        return false;
+
+    node_cells = std::move(loaded_cells);
+    edge_offsets = std::move(loaded_edge_offsets);
+    edges = std::move(loaded_edges);
+    first_global = header.first_global;
+    shortcut_count = std::count_if(edges.begin(), edges.end(), [](const Edge& edge) { return edge.middle != NO_NODE; });
+
+    key = loaded_key;
+    two_level = levels;
+    index_nodes(s);
+    build_time = 0;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#ifndef SUBGOAL_GRAPH_HPP
+#define SUBGOAL_GRAPH_HPP
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "state.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/preprocessed_key.hpp"
+#include "algorithms/util.hpp"
+
+/**
+ * A subgoal graph of the map, as described in Uras et al., 2013 ("Subgoal Graphs for Optimal Pathfinding in Eight-Neighbor Grids").
+ *
+ * The subgoals are the empty cells at the convex corners of the walls: cells with a wall diagonally next to them,
+ * while both of the cells between them and the wall are empty. Two subgoals are connected if they are direct-h-reachable:
+ * there is a path between them as long as the octile distance (h-reachable), found by moving diagonally first and then straight,
+ * without passing another subgoal (see find_direct_h_reachable()). Every shortest path can be turned into an equally long
+ * path through subgoals, so a search over the subgoals (and the beginning and the end, connected in the same way) is optimal.
+ * An edge is refined into cells by moving diagonally first and straight then, or the other way around (see append_edge()).
+ *
+ * In the two-level graph, the subgoals that are not needed for shortest paths between the other subgoals are made local:
+ * a subgoal is removed from the graph if every pair of its neighbours either has another path that is at most as long,
+ * or the path through it is as long as their octile distance, in which case the neighbours are connected directly.
+ * The remaining subgoals are global. A query only searches the global graph, plus the local subgoals reachable from the
+ * beginning and the end by moving to subgoals removed later, like a search in a contraction hierarchy (see contraction_hierarchy.hpp).
+ *
+ * The local subgoals are numbered first, by the order of their removal, then the global subgoals.
+ * A local subgoal keeps its edges to the subgoals that were left when it was removed (the subgoals with higher ids),
+ * and a global subgoal its edges to the other global subgoals (see get_edges()).
+ *
+ * The lengths are in the units of OctileIntegerCost, so that they are exact.
+ */
+class SubgoalGraph
+{
+public:
+    static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * The maximum amount of nodes settled by a witness search when deciding whether a subgoal is local.
+     * When the limit is reached, the subgoal is assumed to be needed.
+     */
+    static constexpr int WITNESS_SETTLE_LIMIT = 100;
+
+    // The cost of every edge, shortcuts included, is the octile distance between its ends, so it fits into 32 bits.
+    // The lengths of whole paths are summed in the 64-bit distances of OctileIntegerCost (see SubgoalGraphSearch).
+    struct Edge
+    {
+        uint32_t to;
+        int32_t cost;
+        // The local subgoal the edge passes through, or NO_NODE for a direct-h-reachable pair
+        uint32_t middle;
+    };
+
+    /**
+     * Builds the graph of the state, unless it is already up to date (the same state, revision, size and level count).
+     * The grid must be up to date.
+     *
+     * @returns Whether the graph was built.
+     */
+    bool update(const State& state, const Grid& grid, bool two_level);
+
+    /**
+     * Builds the graph of the state. The grid must be up to date.
+     *
+     * @param two_level Whether to make the subgoals not needed by the others local.
+     */
+    void build(const State& state, const Grid& grid, bool two_level);
+
+    /**
+     * Gets the subgoal of the cell (x, y), or NO_NODE if it is not a subgoal.
+     */
+    uint32_t get_node(int x, int y) const
+    {
+        return cell_nodes[y * key.width + x];
+    }
+
+    Point get_cell(uint32_t node) const
+    {
+        return {int(node_cells[node] % key.width), int(node_cells[node] / key.width)};
+    }
+
+    size_t get_node_count() const
+    {
+        return node_cells.size();
+    }
+
+    /**
+     * Gets the id of the first global subgoal. The subgoals before it are local.
+     */
+    uint32_t get_first_global() const
+    {
+        return first_global;
+    }
+
+    /**
+     * Gets the range [first, last) of the edges from the subgoal:
+     * the edges to subgoals with higher ids for a local subgoal, and to the other global subgoals for a global subgoal.
+     */
+    std::pair<const Edge*, const Edge*> get_edges(uint32_t node) const
+    {
+        return {edges.data() + edge_offsets[node], edges.data() + edge_offsets[node + 1]};
+    }
+
+    size_t get_edge_count() const
+    {
+        return edges.size();
+    }
+
+    size_t get_shortcut_count() const
+    {
+        return shortcut_count;
+    }
+
+    /**
+     * Finds the subgoals direct-h-reachable from (x, y) and appends the edges to them into found.
+     * The target cell is treated like a subgoal with the node target_node, e.g. for connecting the beginning of a query to the end.
+     * The edges are found by moving diagonally first and then straight, so the path along an edge from (x, y) is the
+     * diagonal-first one.
+     */
+    void find_direct_h_reachable(const Grid& grid, int x, int y, Point target, uint32_t target_node, std::vector<Edge>& found) const;
+
+    /**
+     * Refines the edge from the subgoal a to the subgoal b into cells,
+     * and appends them to cells without the cell of a, with the cell of b.
+     */
+    void unpack(const Grid& grid, uint32_t a, uint32_t b, std::vector<Point>& cells) const;
+
+    /**
+     * Appends the cells of the h-reachable path from a to b into cells, without a, with b:
+     * the diagonal moves first if that path is free, otherwise the straight moves first.
+     */
+    static void append_edge(const Grid& grid, Point a, Point b, std::vector<Point>& cells);
+
+    /**
+     * Gets the time (in microseconds) spent building the graph during the last update(), or 0 if it was up to date.
+     */
+    double get_build_time() const
+    {
+        return build_time;
+    }
+
+    /**
+     * Gets the amount of memory taken by the graph in bytes.
+     */
+    size_t get_memory_usage() const
+    {
+        return cell_nodes.capacity() * sizeof(cell_nodes[0])
+            + node_cells.capacity() * sizeof(node_cells[0])
+            + edge_offsets.capacity() * sizeof(edge_offsets[0])
+            + edges.capacity() * sizeof(edges[0])
+            + blockers.get_memory_usage();
+    }
+
+    /**
+     * Writes the graph into the stream.
+     *
+     * @returns Whether the graph was written. False if it has not been built.
+     */
+    bool save(std::ostream& out) const;
+
+    /**
+     * Reads a graph written by save(), so that the next update() with the state and level count does not build it again.
+     *
+     * @returns Whether the graph was loaded. False if the data is invalid or was made for another map or level count.
+     */
+    bool load(const State& state, bool two_level, std::istream& in);
+
+private:
+    // The subgoal of each cell (by map index), NO_NODE for other cells
+    std::vector<uint32_t> cell_nodes;
+
+    // The map index of the cell of each subgoal
+    std::vector<uint32_t> node_cells;
+    uint32_t first_global = 0;
+
+    // The edges from node i are edges[edge_offsets[i]] to edges[edge_offsets[i + 1] - 1]
+    std::vector<uint32_t> edge_offsets;
+    std::vector<Edge> edges;
+    size_t shortcut_count = 0;
+
+    // The cells where the scans of find_direct_h_reachable() stop: walls and subgoals are walls of this grid
+    Grid blockers;
+
+    PreprocessedKey key;
+    bool two_level = false;
+
+    double build_time = 0;
+
+    /**
+     * The graph during the removal of the local subgoals, and the buffers of the witness searches.
+     */
+    struct Contraction;
+
+    /**
+     * Counts the steps that can be taken from (x, y) in the direction before the next move is invalid
+     * or leads into a subgoal or the target, and sets hit to the node of the cell after them, or NO_NODE if the move is invalid.
+     */
+    int clearance(const Grid& grid, int x, int y, dir_t dir, Point target, uint32_t target_node, uint32_t& hit) const;
+
+    /**
+     * Builds the blockers and the cell_nodes of the state from the node_cells.
+     */
+    void index_nodes(const State& state);
+
+    /**
+     * Finds the edge between the subgoals, or nullptr if there is none.
+     */
+    const Edge* find_edge(uint32_t a, uint32_t b) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "algorithms/subgoal_search.hpp"
+#include "algorithms/cost.hpp"
+
+#include <algorithm>
+
+template<typename Policy>
+void SubgoalGraphSearch<Policy>::init(State* s)
+{
+    state = s;
+    grid.update(*s);
+    graph.update(*s, grid, two_level);
+
+    result = Algorithm::Result{};
+
+    uint32_t node_count = graph.get_node_count();
+    begin_node = node_count;
+    end_node = node_count + 1;
+    nodes.begin_run(node_count + 2, {s, s->revision});
+    open.init(node_count + 2);
+    begin_edges.clear();
+    end_edges.clear();
+
+    // With an empty open list the search fails on the first update.
+    if(grid.is_wall(s->begin.x, s->begin.y) || grid.is_wall(s->end.x, s->end.y))
+        return;
+
+    // The beginning and the end are connected like subgoals, and to the subgoals in their own cells.
+    graph.find_direct_h_reachable(grid, s->begin.x, s->begin.y, s->end, end_node, begin_edges);
+    if(uint32_t subgoal = graph.get_node(s->begin.x, s->begin.y); subgoal != SubgoalGraph::NO_NODE)
+        begin_edges.push_back({subgoal, 0, SubgoalGraph::NO_NODE});
+    if(s->begin == s->end)
+        begin_edges.push_back({end_node, 0, SubgoalGraph::NO_NODE});
+
+    scan.clear();
+    graph.find_direct_h_reachable(grid, s->end.x, s->end.y, s->begin, begin_node, scan);
+    if(uint32_t subgoal = graph.get_node(s->end.x, s->end.y); subgoal != SubgoalGraph::NO_NODE)
+        scan.push_back({subgoal, 0, SubgoalGraph::NO_NODE});
+
+    // The local subgoals are only connected upwards (see subgoal_graph.hpp),
+    // so the edges from the global subgoals down to the end are followed in reverse from the end.
+    uint32_t first_global = graph.get_first_global();
+    local_marks.resize(node_count, 0);
+    run_id++;
+    end_locals.clear();
+    for(const Edge& edge : scan)
+    {
+        end_edges.push_back({edge.to, {end_node, edge.cost, SubgoalGraph::NO_NODE}});
+        if(edge.to < first_global && local_marks[edge.to] != run_id)
+        {
+            local_marks[edge.to] = run_id;
+            end_locals.push_back(edge.to);
+        }
+    }
+    for(size_t i = 0; i < end_locals.size(); ++i)
+    {
+        uint32_t local = end_locals[i];
+        auto [first, last] = graph.get_edges(local);
+        for(auto edge = first; edge != last; ++edge)
+        {
+            end_edges.push_back({edge->to, {local, edge->cost, SubgoalGraph::NO_NODE}});
+            if(edge->to < first_global && local_marks[edge->to] != run_id)
+            {
+                local_marks[edge->to] = run_id;
+                end_locals.push_back(edge->to);
+            }
+        }
+    }
+    std::sort(end_edges.begin(), end_edges.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    nodes.touch(begin_node).distance = 0;
+    nodes.parent(begin_node) = NULL_NODE_IDX;
+    open.push(OctileIntegerCost<>::heuristic(s->begin.x, s->begin.y, s->end.x, s->end.y), begin_node);
+}
+
+template<typename Policy>
+Algorithm::Result::Type SubgoalGraphSearch<Policy>::update()
+{
+    // Skip the stale entries of already examined nodes, like in AStar.
+    uint32_t node;
+    do
+    {
+        if(open.empty())
+        {
+            result.type = Result::Type::FAILURE;
+            return Result::Type::FAILURE;
+        }
+
+        node = open.top().second;
+        open.pop();
+    }
+    while(nodes[node].status() == SubgoalNode::Status::EXAMINED);
+
+    if(node == end_node)
+    {
+        build_path();
+        result.type = Result::Type::SUCCESS;
+        return Result::Type::SUCCESS;
+    }
+
+    auto& record = nodes[node];
+    record.set_status(SubgoalNode::Status::EXAMINED);
+    result.expanded++;
+    // Copied, as relaxing may move the record (see node_store.hpp)
+    distance_t distance = record.distance;
+
+    Point cell = get_cell(node);
+    Observer::expanded(*state, cell.y * state->width + cell.x);
+
+    if(node == begin_node)
+    {
+        for(const Edge& edge : begin_edges)
+            relax(node, edge.to, distance + edge.cost);
+    }
+    else
+    {
+        auto [first, last] = graph.get_edges(node);
+        for(auto edge = first; edge != last; ++edge)
+            relax(node, edge->to, distance + edge->cost);
+    }
+
+    auto [first, last] = std::equal_range(end_edges.begin(), end_edges.end(), std::pair{node, Edge{}},
+                                          [](const auto& a, const auto& b) { return a.first < b.first; });
+    for(auto entry = first; entry != last; ++entry)
+        relax(node, entry->second.to, distance + entry->second.cost);
+
+    return Result::Type::EXECUTING;
+}
+
+template<typename Policy>
+void SubgoalGraphSearch<Policy>::relax(uint32_t prev, uint32_t node, distance_t distance)
+{
+    result.examined++;
+
+    auto& record = nodes.touch(node);
+    if(distance >= record.distance)
+        return;
+
+    record.distance = distance;
+    nodes.parent(node) = prev;
+
+    Point cell = get_cell(node);
+    Observer::examined(*state, cell.y * state->width + cell.x);
+    open.push(distance + OctileIntegerCost<>::heuristic(cell.x, cell.y, state->end.x, state->end.y), node);
+}
+
+template<typename Policy>
+Point SubgoalGraphSearch<Policy>::get_cell(uint32_t node) const
+{
+    if(node == begin_node)
+        return state->begin;
+    if(node == end_node)
+        return state->end;
+    return graph.get_cell(node);
+}
+
+template<typename Policy>
+void SubgoalGraphSearch<Policy>::build_path()
+{
+    chain.clear();
+    for(node_index node = end_node; node != NULL_NODE_IDX; node = nodes.parent(node))
+        chain.push_back(node);
+    std::reverse(chain.begin(), chain.end());
+
+    // The edges from the beginning and to the end are direct-h-reachable, the others may be shortcuts.
+    for(size_t i = 0; i + 1 < chain.size(); ++i)
+    {
+        if(chain[i] == begin_node || chain[i + 1] == end_node)
+            SubgoalGraph::append_edge(grid, get_cell(chain[i]), get_cell(chain[i + 1]), result.path);
+        else
+            graph.unpack(grid, chain[i], chain[i + 1], result.path);
+    }
+
+    for(auto point : result.path)
+        Observer::path(*state, point.y * state->width + point.x);
+
+    result.length = OctileIntegerCost<>::to_float(nodes[end_node].distance);
+}
+
+template<typename Policy>
+size_t SubgoalGraphSearch<Policy>::get_memory_usage()
+{
+    return nodes.get_memory_usage()
+        + open.get_memory_usage()
+        + grid.get_memory_usage()
+        + get_preprocessed_memory_usage();
+}
+
+template<typename Policy>
+double SubgoalGraphSearch<Policy>::get_preprocessing_time()
+{
+    return graph.get_build_time();
+}
+
+template<typename Policy>
+size_t SubgoalGraphSearch<Policy>::get_preprocessed_memory_usage()
+{
+    return graph.get_memory_usage();
+}
+
+template<typename Policy>
+std::vector<std::pair<std::string, double>> SubgoalGraphSearch<Policy>::get_preprocessed_statistics()
+{
+    return {
+        {"subgoals", graph.get_node_count()},
+        {"global_subgoals", graph.get_node_count() - graph.get_first_global()},
+        {"edges", graph.get_edge_count()},
+        {"shortcuts", graph.get_shortcut_count()}
+    };
+}
+
+template<typename Policy>
+bool SubgoalGraphSearch<Policy>::save_preprocessed(std::ostream& out)
+{
+    return graph.save(out);
+}
+
+template<typename Policy>
+bool SubgoalGraphSearch<Policy>::load_preprocessed(const State& s, std::istream& in)
+{
+    return graph.load(s, two_level, in);
+}
+
+template class SubgoalGraphSearch<HeadlessPolicy>;
+template class SubgoalGraphSearch<VisualPolicy>;
\ No newline at end of file
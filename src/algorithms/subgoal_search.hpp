@@ -0,0 +1,110 @@
+#ifndef SUBGOAL_SEARCH_HPP
+#define SUBGOAL_SEARCH_HPP
+
+#include <utility>
+#include <vector>
+
+#include "algorithms/algorithm.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/subgoal_graph.hpp"
+#include "algorithms/policies.hpp"
+
+/**
+ * Optimal searches over a subgoal graph of the map (see subgoal_graph.hpp), simple or two-level.
+ *
+ * A query connects the beginning to the subgoals direct-h-reachable from it, and the end to the subgoals direct-h-reachable from it,
+ * like a subgoal of the graph. With a two-level graph, the local subgoals connected to the end are followed up to the global subgoals,
+ * and their edges are added in reverse, so that the search can come back down to the end from the global graph.
+ * The graph is then searched with A*, one expanded node per update(), and the edges of the path are refined into cells.
+ *
+ * The searches are small, as the subgoals are only at the corners of the walls, but connecting the beginning and the end
+ * scans the cells visible from them. The results are optimal.
+ */
+template<typename Policy = HeadlessPolicy>
+class SubgoalGraphSearch : public Algorithm
+{
+public:
+    /**
+     * @param two_level Whether to search a two-level subgoal graph instead of a simple one.
+     */
+    explicit SubgoalGraphSearch(bool two_level = false) : two_level(two_level)
+    {
+    }
+
+    void init(State* state);
+    Result::Type update();
+    size_t get_memory_usage();
+
+    double get_preprocessing_time();
+    size_t get_preprocessed_memory_usage();
+    std::vector<std::pair<std::string, double>> get_preprocessed_statistics();
+    bool save_preprocessed(std::ostream& out);
+    bool load_preprocessed(const State& state, std::istream& in);
+
+    const SubgoalGraph& get_graph() const
+    {
+        return graph;
+    }
+
+private:
+    using Observer = typename Policy::Observer;
+    using Edge = SubgoalGraph::Edge;
+
+    /**
+     * The nodes of the search, with distances in the units of OctileIntegerCost.
+     */
+    using distance_t = OctileIntegerCost<>::distance_t;
+
+    struct SubgoalNode : SearchNode<distance_t, typename Policy::Stamp>
+    {
+        enum Status : uint8_t
+        {
+            UNEXAMINED,
+            EXAMINED
+        };
+    };
+
+    bool two_level;
+
+    Grid grid;
+    SubgoalGraph graph;
+
+    /**
+     * The search. The beginning and the end are the nodes after the subgoals.
+     */
+    typename Policy::template NodeStore<SubgoalNode> nodes;
+    typename Policy::template OpenList<distance_t> open;
+    uint32_t begin_node = 0;
+    uint32_t end_node = 0;
+
+    // The edges from the beginning, and the edges towards the end by the node they start from, sorted by the node
+    std::vector<Edge> begin_edges;
+    std::vector<std::pair<uint32_t, Edge>> end_edges;
+
+    // The local subgoals connected to the end, and the buffers for finding them
+    std::vector<uint32_t> end_locals;
+    std::vector<uint32_t> local_marks;
+    uint32_t run_id = 0;
+    std::vector<Edge> scan;
+
+    // The nodes of the path before refining
+    std::vector<uint32_t> chain;
+
+    /**
+     * Gets the cell of a node of the search.
+     */
+    Point get_cell(uint32_t node) const;
+
+    /**
+     * Updates the distance and parent of the node and adds it to the open list if the distance is lower.
+     */
+    void relax(uint32_t prev, uint32_t node, distance_t distance);
+
+    /**
+     * Refines the path to the end into the result.
+     */
+    void build_path();
+};
+
+#endif
\ No newline at end of file
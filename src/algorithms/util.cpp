@@ -37,6 +37,35 @@ dir_t const DIR_SOUTHWEST = directions[5];
 dir_t const DIR_WEST      = directions[6];
 dir_t const DIR_NORTHWEST = directions[7];
 
+std::pair<dir_t, dir_t> const forced[][2] =
+{
+    {{&_sw, &_w}, {&_se, &_e}},
+    {},
+    {{&_nw, &_n}, {&_sw, &_s}},
+    {},
+    {{&_nw, &_w}, {&_ne, &_e}},
+    {},
+    {{&_ne, &_n}, {&_se, &_s}},
+    {}
+};
+
+const std::array<SuccessorList, 256> successor_lists = []
+{
+    std::array<SuccessorList, 256> lists{};
+    for(int mask = 0; mask < 256; ++mask)
+    {
+        auto& list = lists[mask];
+        for(uint8_t dir = 0; dir < 8; ++dir)
+        {
+            if(mask & (1 << dir))
+            {
+                list.directions[list.amount++] = dir;
+            }
+        }
+    }
+    return lists;
+}();
+
 
 bool Util::is_move_valid(const State& state, int x, int y, dir_t dir)
 {
@@ -83,4 +112,48 @@ int Util::get_neighbours(std::pair<node_index, dir_t>* buffer, const State& stat
         }
     }
     return amount_neighbours;
+}
+
+uint8_t Util::canonical_successors(const Grid& grid, int x, int y, int dx, int dy)
+{
+    uint8_t valid = grid.successors(x, y);
+    if(dx == 0 && dy == 0)
+        return valid;
+
+    uint32_t type = 0;
+    while(directions[type]->movement != std::pair{dx, dy})
+        ++type;
+
+    // The directions are ordered clockwise, so the neighbouring types of a direction are 45 degrees off it.
+    if(!directions[type]->straight)
+        return valid & (1 << type | 1 << ((type + 1) % 8) | 1 << ((type + 7) % 8));
+
+    uint8_t mask = 1 << type;
+    for(auto [wall_dir, empty_dir] : forced[type])
+    {
+        if(grid.is_wall(x + wall_dir->movement.first, y + wall_dir->movement.second)
+        && grid.is_empty(x + empty_dir->movement.first, y + empty_dir->movement.second))
+        {
+            // The forced neighbour and the diagonal between it and the direction of arrival
+            uint32_t diagonal = empty_dir->type == (type + 2) % 8 ? (type + 1) % 8 : (type + 7) % 8;
+            mask |= 1 << empty_dir->type | 1 << diagonal;
+        }
+    }
+    return valid & mask;
+}
+
+uint64_t Util::wall_fingerprint(const State& state)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    auto add = [&](uint64_t value)
+    {
+        hash ^= value;
+        hash *= 0x100000001b3;
+    };
+
+    add(state.width);
+    add(state.height);
+    for(auto node : state.map)
+        add(node == Node::WALL);
+    return hash;
 }
\ No newline at end of file
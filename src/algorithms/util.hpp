@@ -1,20 +1,20 @@
 #ifndef UTIL_HPP
 #define UTIL_HPP
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 #include <utility>
 #include <cmath>
 #include <algorithm>
 
 #include "state.hpp"
 #include "algorithms/algorithm.hpp"
-
-/**
- * The main type used by nodes to refer to each other.
- * Represents an index into a flat array of nodes.
- */
-typedef size_t node_index;
-constexpr node_index NULL_NODE_IDX = std::numeric_limits<node_index>::max();
+#include "algorithms/observer.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/layout.hpp"
 
 /**
  * Square root of two rounded upwards.
@@ -63,6 +63,32 @@ extern dir_t const DIR_SOUTHWEST;
 extern dir_t const DIR_WEST;
 extern dir_t const DIR_NORTHWEST;
 
+/**
+ * The directions of the set bits of an 8-bit successor mask (see Grid::successors()), in ascending order.
+ */
+struct SuccessorList
+{
+    uint8_t amount;
+    uint8_t directions[8];
+};
+
+/**
+ * The SuccessorList of every possible successor mask.
+ */
+extern const std::array<SuccessorList, 256> successor_lists;
+
+/**
+ * A matrix of relative positions.
+ * The positions are used to determine whether a node has forced neigbours.
+ * The index into the array is a Direction.type.
+ * Only defined for straight directions, as only they can have forced neigbours.
+ * 
+ * Usage:
+ * The node pair for each direction is a {WALL, EMPTY} pair.
+ * If the WALL direction is a wall, and the EMPTY direction is empty, the node has a forced neighbour.
+ */
+extern std::pair<dir_t, dir_t> const forced[][2];
+
 
 namespace Util
 {
@@ -91,6 +117,59 @@ namespace Util
      */
     bool is_move_valid(const State& state, int x, int y, dir_t dir);
 
+    /**
+     * Checks if the move from (x, y) is valid.
+     * Same as above, but reads the walls from the bit-packed grid without bounds checks.
+     * (x, y) must be within the map.
+     */
+    inline bool is_move_valid(const Grid& grid, int x, int y, dir_t dir)
+    {
+        int new_x = x + dir->movement.first;
+        int new_y = y + dir->movement.second;
+
+        if(dir->straight)
+        {
+            return grid.is_empty(new_x, new_y);
+        }
+
+        // Diagonal: the target and both of the component directions must be empty
+        return grid.is_empty(new_x, new_y)
+            && grid.is_empty(new_x, y)
+            && grid.is_empty(x, new_y);
+    }
+
+    /**
+     * Checks if the node (x, y), reached by moving in the straight direction dir, has a forced neighbour (see forced[][]).
+     * (x, y) must be within the map.
+     */
+    inline bool has_forced_neighbour(const Grid& grid, int x, int y, dir_t dir)
+    {
+        for(auto [wall_dir, empty_dir] : forced[dir->type])
+        {
+            if(grid.is_wall(x + wall_dir->movement.first, y + wall_dir->movement.second)
+            && grid.is_empty(x + empty_dir->movement.first, y + empty_dir->movement.second))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Gets the directions in which a jump point search continues from (x, y), as a successor mask (see Grid::successors()).
+     * (dx, dy) is the direction in which (x, y) was reached, given by the signs of the coordinate differences,
+     * or (0, 0) for the beginning, which continues in every valid direction.
+     * Other nodes only continue in the direction of arrival (and its components, for diagonals)
+     * and towards their forced neighbours: every optimal path through (x, y) has an equally long path in these directions.
+     */
+    uint8_t canonical_successors(const Grid& grid, int x, int y, int dx, int dy);
+
+    /**
+     * Computes a 64-bit FNV-1a hash of the dimensions and the walls of the map.
+     * Used for checking that saved preprocessed data belongs to the map it is loaded for.
+     */
+    uint64_t wall_fingerprint(const State& state);
+
     /**
      * Flattens the input coordinates (x, y) to single-dimensional array coordinates.
      */
@@ -108,6 +187,35 @@ namespace Util
         return {idx % width, idx / width};
     }
 
+    /**
+     * Finds all the possible neighbours of the node in the specified location.
+     * Same as the State version above, but reads the valid moves as a successor mask from the grid (see Grid::successors())
+     * and converts the mask into neighbours with a lookup table.
+     * Used in the hot path of the searches.
+     *
+     * @param layout The layout of the node indices written into the buffer (see layout.hpp).
+     */
+    template<typename Layout>
+    inline int get_neighbours(std::pair<node_index, dir_t>* buffer, const Grid& grid, const Layout& layout, int x, int y)
+    {
+        const SuccessorList& successors = successor_lists[grid.successors(x, y)];
+        node_index idx = layout.flatten(x, y);
+        for(int i = 0; i < successors.amount; ++i)
+        {
+            auto dir = successors.directions[i];
+            buffer[i] = {idx + layout.offsets[dir], directions[dir]};
+        }
+        return successors.amount;
+    }
+
+    /**
+     * Same as above, with the node indices laid out like in the State::map.
+     */
+    inline int get_neighbours(std::pair<node_index, dir_t>* buffer, const Grid& grid, int x, int y)
+    {
+        return get_neighbours(buffer, grid, RowMajorLayout{grid.width, grid.height}, x, y);
+    }
+
     /**
      * Is the specified node within map bounds?
      */
@@ -167,59 +275,149 @@ namespace Util
         return diagonal * SQRT_2 + straight;
     }
 
+    /**
+     * Returns the distance between the two points as if there were no obstacles between them,
+     * with the specified costs for straight and diagonal moves.
+     * Used with the integer cost models (see cost.hpp), for which the result is exact.
+     */
+    template<typename T>
+    inline T diagonal_distance(int x1, int y1, int x2, int y2, T straight_cost, T diagonal_cost)
+    {
+        auto x_diff = std::abs(x2 - x1);
+        auto y_diff = std::abs(y2 - y1);
+        T diagonal = std::min(x_diff, y_diff);
+        T straight = std::max(x_diff, y_diff) - diagonal;
+        return diagonal * diagonal_cost + straight * straight_cost;
+    }
+
+    /**
+     * Returns a reference to the "prev" index of a node.
+     * The node can either be a structure with a node_index member variable called "prev",
+     * or directly a node_index, in which case the nodes are a flat array of parent indices.
+     */
+    template<typename T>
+    auto& prev_of(T& node)
+    {
+        if constexpr(std::is_same_v<std::remove_const_t<T>, node_index>)
+            return node;
+        else
+            return node.prev;
+    }
+
     /**
      *  Builds the path from the nodes when the end has been reached.
-     *  The nodes must be of type T.
-     *  Each node object of type T is expected to have a node_index member variable called "prev".
+     *  The nodes can be anything indexable with a node_index: an array, or the parents() of a node store (see node_store.hpp).
+     *  Each node object is expected to either have a node_index member variable called "prev",
+     *  or to be a node_index itself (see prev_of() above).
      *  This "prev" variable points to the previous point in the path.
      *  The path generation is started from the end node in the state.
+     *  Each node of the path is reported to the Observer (see observer.hpp).
+     *  The nodes are indexed according to the layout (see layout.hpp).
      */
-    template<typename T>
-    void build_path(State& state, T* nodes, Algorithm::Result& res)
+    template<typename Observer = NullObserver, typename Layout, typename Nodes>
+    void build_path(State& state, const Layout& layout, Nodes&& nodes, Algorithm::Result& res)
     {
-        auto end_idx = flatten(state.width, state.end.x, state.end.y);
+        auto end_idx = layout.flatten(state.end.x, state.end.y);
         node_index prev_idx = end_idx;
         while(true)
         {
-                T& prev_node = nodes[prev_idx];
-                if(prev_node.prev == NULL_NODE_IDX)
+                auto& prev_node = nodes[prev_idx];
+                if(prev_of(prev_node) == NULL_NODE_IDX)
                 {
                     break;
                 }
-                auto [x, y] = expand(state.width, prev_idx);
+                auto [x, y] = layout.expand(prev_idx);
+                res.path.push_back({x, y});
+                Observer::path(state, layout.map_index(prev_idx));
+                prev_idx = prev_of(prev_node);
+        }
+        std::reverse(res.path.begin(), res.path.end());
+    }
+
+    /**
+     * Same as above, with the nodes indexed like the State::map.
+     */
+    template<typename Observer = NullObserver, typename Nodes>
+    void build_path(State& state, Nodes&& nodes, Algorithm::Result& res)
+    {
+        build_path<Observer>(state, RowMajorLayout{state.width, state.height}, nodes, res);
+    }
+
+    /**
+     * Like build_path(), but for searches whose consecutive path nodes may be any amount of cells apart
+     * along a straight or a diagonal line, e.g. the jump points of a jump point search.
+     * The cells between consecutive path nodes are filled in, so the path consists of single moves like with build_path().
+     */
+    template<typename Observer = NullObserver, typename Layout, typename Nodes>
+    void build_jump_path(State& state, const Layout& layout, Nodes&& nodes, Algorithm::Result& res)
+    {
+        node_index idx = layout.flatten(state.end.x, state.end.y);
+        while(true)
+        {
+            node_index prev_idx = prev_of(nodes[idx]);
+            if(prev_idx == NULL_NODE_IDX)
+            {
+                break;
+            }
+
+            auto [x, y] = layout.expand(idx);
+            auto [prev_x, prev_y] = layout.expand(prev_idx);
+            int dx = (prev_x > x) - (prev_x < x);
+            int dy = (prev_y > y) - (prev_y < y);
+            while(x != prev_x || y != prev_y)
+            {
                 res.path.push_back({x, y});
-                if(!(x == state.end.x && y == state.end.y))
-                    state.map[prev_idx] = Node::PATH;
-                prev_idx = prev_node.prev;
+                Observer::path(state, layout.map_index(layout.flatten(x, y)));
+                x += dx;
+                y += dy;
+            }
+            idx = prev_idx;
         }
         std::reverse(res.path.begin(), res.path.end());
     }
 
     /**
      * Checks if node is initialized for the specified run.
-     * If not, default-constructs it.
+     * If not, resets it to its default state.
+     * The node type T is expected to derive from SearchNode (see search_node.hpp).
      */
     template<typename T>
     void lazy_initialize(uint32_t run_id, T& node)
     {
-        if(node.last_run != run_id)
+        if(!node.is_current(run_id))
         {
-            node = T{.last_run = run_id};
+            node.reset(run_id);
         }
     }
 
-    template<typename T>
-    void format_bidirectional_nodes(T* nodes, node_index forward_head, node_index backward_head)
+    /**
+     * Reverses the "prev" chain starting from backward_head, read from backward_nodes, and attaches it after forward_head in nodes,
+     * so that the path of a bidirectional search that keeps the parents of the two directions apart can be built with build_path().
+     * The nodes of the backward chain must be writable in nodes, e.g. touched first in a sparse node store.
+     */
+    template<typename Nodes, typename BackwardNodes>
+    void format_bidirectional_nodes(Nodes&& nodes, BackwardNodes&& backward_nodes, node_index forward_head, node_index backward_head)
     {
         while(backward_head != NULL_NODE_IDX)
         {
-            T& node = nodes[backward_head];
-            node_index next_backward_head = node.prev;
-            node.prev = forward_head;
+            node_index next_backward_head = prev_of(backward_nodes[backward_head]);
+            prev_of(nodes[backward_head]) = forward_head;
             forward_head = backward_head;
             backward_head = next_backward_head;
         }
     }
+
+    /**
+     * Reverses the "prev" chain starting from backward_head and attaches it after forward_head,
+     * so that the path of a bidirectional search can be built with build_path().
+     * The nodes can be anything indexable with a node_index, like in build_path().
+     * Both directions share the same nodes.
+     */
+    template<typename Nodes>
+    void format_bidirectional_nodes(Nodes&& nodes, node_index forward_head, node_index backward_head)
+    {
+        format_bidirectional_nodes(nodes, nodes, forward_head, backward_head);
+    }
 }
 
 #endif
\ No newline at end of file
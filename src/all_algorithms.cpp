@@ -1,13 +1,45 @@
 #include "all_algorithms.hpp"
 #include "algorithms/a_star.hpp"
 #include "algorithms/jps.hpp"
+#include "algorithms/jps_b.hpp"
+#include "algorithms/jps_plus.hpp"
 #include "algorithms/bbfs.hpp"
+#include "algorithms/bidirectional_jps.hpp"
+#include "algorithms/canonical_dijkstra.hpp"
+#include "algorithms/ch_search.hpp"
+#include "algorithms/cpd_search.hpp"
+#include "algorithms/hpa_star.hpp"
+#include "algorithms/hub_label_search.hpp"
 #include "algorithms/optimized_a_star.hpp"
+#include "algorithms/subgoal_search.hpp"
+#include "algorithms/policies.hpp"
 
-std::map<std::string, Algorithm*> algorithms =
+std::map<std::string, RegisteredAlgorithm> algorithms =
 {
-    {"A*", new AStar()},
-    {"JPS", new JumpPointSearch()},
-    {"BBFS", new BBFS()},
-    {"OptimizedA*", new OptimizedAStar()},
+    {"A*", {new AStar<RegistryPolicy>()}},
+    {"JPS", {new JumpPointSearch<RegistryPolicy>()}},
+    {"BBFS", {new BBFS<RegistryPolicy>()}},
+    {"OptimizedA*", {new OptimizedAStar<RegistryPolicy>()}},
+    {"OptimizedA*-pow2", {new OptimizedAStar<PowerOfTwoStride<RegistryPolicy>>()}},
+    {"A*-int", {new AStar<IntegerCost<RegistryPolicy>>()}},
+    {"A*-indexed", {new AStar<IndexedOpenList<RegistryPolicy>>()}},
+    {"A*-radix", {new AStar<RadixOpenList<IntegerCost<RegistryPolicy>>>()}},
+    {"A*-hashed", {new AStar<HashedNodes<RegistryPolicy>>()}},
+    {"JPS-B", {new BlockJumpPointSearch<RegistryPolicy>()}},
+    {"JPS+", {new JumpPointSearchPlus<RegistryPolicy>()}},
+    {"JPS-deferred", {new JumpPointSearch<DeferredJumps<RegistryPolicy>>()}},
+    {"JPS-bidirectional", {new BidirectionalJumpPointSearch<RegistryPolicy>()}},
+    {"CanonicalDijkstra", {new CanonicalDijkstra<RegistryPolicy>()}},
+    {"HPA*", {new HierarchicalAStar<RegistryPolicy>()}},
+    {"CH", {.algorithm = new ContractionHierarchySearch<RegistryPolicy>(), .opt_in = true}},
+    {"SSG", {new SubgoalGraphSearch<RegistryPolicy>()}},
+    {"TSG", {new SubgoalGraphSearch<RegistryPolicy>(true)}},
+    {"CPD", {.algorithm = new CompressedPathDatabaseSearch<RegistryPolicy>(), .opt_in = true}},
+    {"HL", {.algorithm = new HubLabelSearch<RegistryPolicy>(), .opt_in = true}},
+    {"HL-distance", {.algorithm = new HubLabelSearch<RegistryPolicy>(false), .opt_in = true}},
+    {"A*-alt4", {new AStar<DifferentialHeuristic<RegistryPolicy, 4>>()}},
+    {"A*-alt", {new AStar<DifferentialHeuristic<RegistryPolicy>>()}},
+    {"A*-alt16", {new AStar<DifferentialHeuristic<RegistryPolicy, 16>>()}},
+    {"A*-bounded", {.algorithm = new AStar<GoalBounding<RegistryPolicy>>(), .opt_in = true}},
+    {"JPS-bounded", {.algorithm = new JumpPointSearch<GoalBounding<RegistryPolicy>>(), .opt_in = true}},
 };
\ No newline at end of file
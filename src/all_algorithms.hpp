@@ -5,6 +5,13 @@
 #include <string>
 #include "algorithms/algorithm.hpp"
 
-extern std::map<std::string, Algorithm*> algorithms;
+struct RegisteredAlgorithm
+{
+    Algorithm* algorithm;
+    // Left out of the benchmarks unless it is named explicitly, because its preprocessing takes too long on large maps.
+    bool opt_in = false;
+};
+
+extern std::map<std::string, RegisteredAlgorithm> algorithms;
 
 #endif
\ No newline at end of file
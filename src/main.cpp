@@ -18,6 +18,8 @@
 State global_state;
 bool pathfinding = false;
 bool cleared = false;
+// The algorithm started last. Only its preprocessed data is repaired when the walls are edited.
+std::atomic<Algorithm*> selected_algorithm = nullptr;
 
 void remove_temp(State& state)
 {
@@ -64,9 +66,20 @@ void render_loop(sf::RenderWindow* window, State* state, std::mutex* mut)
         if(!pathfinding && check_coords(*state, x, y))
         {
             int index = y * global_state.width + x;
+            bool walls_changed = (global_state.map[index] == Node::WALL) != (type == Node::WALL);
             global_state.map[index] = type;
             state->map[index] = type;
 
+            if(walls_changed)
+            {
+                global_state.revision++;
+
+                // Repair the preprocessed data of the selected algorithm (e.g. JPS+) instead of preprocessing the whole map again.
+                // The other algorithms see the new revision and preprocess the map again if they are started.
+                if(auto algo = selected_algorithm.load())
+                    algo->update_preprocessed(global_state, x, y);
+            }
+
             return true;
         }
         else
@@ -243,7 +256,7 @@ void console_loop(sf::RenderWindow* window, State* render_state, std::mutex* ren
             auto algo_name = get_next_token();
             Algorithm* algo;
             if(algorithms.contains(algo_name))
-                algo = algorithms[algo_name];
+                algo = algorithms[algo_name].algorithm;
             else
             {
                 std::cout << "unknown algorithm." << std::endl;
@@ -259,6 +272,7 @@ void console_loop(sf::RenderWindow* window, State* render_state, std::mutex* ren
             {
                 sleep_duration = std::chrono::microseconds(std::stoi(str));
             }
+            selected_algorithm = algo;
             pathfinding = true;
             pathfinding_loop(algo, &global_state, render_state, render_update_mutex, sleep_duration);
             cleared = false;
@@ -1,6 +1,7 @@
 #ifndef STATE_HPP
 #define STATE_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -27,6 +28,58 @@ enum Node : uint8_t
     PATH
 };
 
+/**
+ * The revision of the walls of a State (see State::revision).
+ *
+ * Every revision that is constructed, copied or assigned starts a new range of values taken from a process-wide counter,
+ * so two states never share a revision, even when one is assigned over the other or allocated at the address of a destroyed one.
+ * Incrementing it for an edit of the walls stays within the range.
+ */
+class Revision
+{
+public:
+    Revision() : value(next_range()) {}
+    Revision(const Revision&) : value(next_range()) {}
+
+    Revision& operator=(const Revision&)
+    {
+        value = next_range();
+        return *this;
+    }
+
+    operator uint64_t() const
+    {
+        return value;
+    }
+
+    Revision& operator++()
+    {
+        ++value;
+        return *this;
+    }
+
+    uint64_t operator++(int)
+    {
+        return value++;
+    }
+
+    Revision& operator+=(uint64_t amount)
+    {
+        value += amount;
+        return *this;
+    }
+
+private:
+    static uint64_t next_range()
+    {
+        // A range leaves room for 2^32 edits before it reaches the next one
+        static std::atomic<uint64_t> ranges = 1;
+        return ranges.fetch_add(1, std::memory_order_relaxed) << 32;
+    }
+
+    uint64_t value;
+};
+
 struct State
 {
     std::vector<Node> map;
@@ -36,6 +89,12 @@ struct State
     Point end;
 
     std::string map_name;
+
+    // Incremented every time walls are added to or removed from the map, and unique to the state otherwise (see Revision),
+    // so copying or assigning another map into a state changes it as well.
+    // The algorithms use it to know when their preprocessed data (for example the Grid) has to be rebuilt,
+    // and do not read the walls again while it stays the same.
+    Revision revision;
 };
 
 #endif
\ No newline at end of file
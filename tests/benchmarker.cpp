@@ -3,6 +3,10 @@
 #include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
 
 #include "benchmarker.hpp"
 #include "main.hpp"
@@ -22,7 +26,17 @@ inline bool approx_equal(float a, float b)
 }
 
 
-void Benchmarker::benchmark()
+/**
+ * Gets the file of the preprocessed data of the algorithm for the map.
+ */
+static std::filesystem::path preprocessed_file(const std::filesystem::path& dir, const std::string& map_name, const std::string& algo_name)
+{
+    auto file_name = std::filesystem::path(map_name).filename().string() + "." + algo_name + ".pre";
+    std::replace(file_name.begin(), file_name.end(), '*', 's');
+    return dir / file_name;
+}
+
+void Benchmarker::benchmark(const std::filesystem::path& preprocessed_dir)
 {
     std::cout << std::fixed << std::setprecision(1);
     std::cout << "map_name,scenario_distance,";
@@ -32,6 +46,15 @@ void Benchmarker::benchmark()
     }
     std::cout << std::endl;
 
+    // Totals for the summary printed after the scenarios
+    std::vector<double> total_times(algos.size(), 0.0);
+    std::vector<double> total_expanded(algos.size(), 0.0);
+    std::vector<double> bytes_per_cell(algos.size(), 0.0);
+    std::vector<double> preprocessing_times(algos.size(), 0.0);
+    std::vector<double> preprocessed_bytes_per_cell(algos.size(), 0.0);
+    // (algorithm, map, statistic, value) for every preprocessed map, see Algorithm::get_preprocessed_statistics()
+    std::vector<std::tuple<std::string, std::string, std::string, double>> statistics;
+
     State* previous_state = nullptr;
     for(const auto& scenario : scenarios)
     {
@@ -43,12 +66,31 @@ void Benchmarker::benchmark()
             << "," << scenario.optimal_length
             << ",";
 
-        for(const auto [algo_name, algo] : algos)
+        for(int i = 0; i < algos.size(); ++i)
         {
+            auto [algo_name, algo] = algos[i];
             if(state != previous_state)
             {
                 // For allocating and preprocessing maps
+                bool loaded = false;
+                if(!preprocessed_dir.empty())
+                {
+                    std::ifstream in{preprocessed_file(preprocessed_dir, state->map_name, algo_name), std::ios::binary};
+                    loaded = in && algo->load_preprocessed(*state, in);
+                }
+
                 algo->init(state);
+                preprocessing_times[i] += algo->get_preprocessing_time();
+                preprocessed_bytes_per_cell[i] = std::max(preprocessed_bytes_per_cell[i],
+                    (double)algo->get_preprocessed_memory_usage() / state->map.size());
+                for(const auto& [name, value] : algo->get_preprocessed_statistics())
+                    statistics.emplace_back(algo_name, state->map_name, name, value);
+
+                if(!preprocessed_dir.empty() && !loaded)
+                {
+                    std::ofstream out{preprocessed_file(preprocessed_dir, state->map_name, algo_name), std::ios::binary};
+                    algo->save_preprocessed(out);
+                }
             }
 
             auto start = std::chrono::high_resolution_clock::now();
@@ -61,14 +103,17 @@ void Benchmarker::benchmark()
             auto res = algo->get_result();
             auto end = std::chrono::high_resolution_clock::now();
 
+            float total = std::chrono::duration<float, std::micro>(end - start).count();
+            total_times[i] += total;
+            total_expanded[i] += res.expanded;
+            bytes_per_cell[i] = std::max(bytes_per_cell[i], (double)algo->get_memory_usage() / state->map.size());
+
             if(!approx_equal(res.length, scenario.optimal_length))
             {
                 std::cout << "NON_OPTIMAL_DIFF:" << std::abs(scenario.optimal_length - res.length) << ",";
             }
             else
             {
-                float total = std::chrono::duration<float, std::micro>(end - start).count();
-
                 std::cout << total << ",";
             }
         }
@@ -76,4 +121,28 @@ void Benchmarker::benchmark()
 
         previous_state = state;
     }
+
+    // Summary: the speedup and the expansions saved are relative to the first benchmarked algorithm.
+    // The preprocessing time is the total over all the maps and not included in the total time.
+    std::cout << std::endl << "algorithm,total_time,speedup,bytes_per_cell,preprocessing_time,preprocessed_bytes_per_cell,expanded,expansions_saved" << std::endl;
+    for(int i = 0; i < algos.size(); ++i)
+    {
+        std::cout << algos[i].first
+            << "," << total_times[i]
+            << "," << std::setprecision(2) << total_times[0] / total_times[i]
+            << "," << bytes_per_cell[i] << std::setprecision(1)
+            << "," << preprocessing_times[i]
+            << "," << std::setprecision(2) << preprocessed_bytes_per_cell[i] << std::setprecision(1)
+            << "," << total_expanded[i]
+            << "," << std::setprecision(2) << (total_expanded[0] > 0 ? 1.0 - total_expanded[i] / total_expanded[0] : 0.0) << std::setprecision(1)
+            << std::endl;
+    }
+
+    if(!statistics.empty())
+    {
+        std::cout << std::endl << "algorithm,map_name,statistic,value" << std::endl;
+        std::cout << std::setprecision(2);
+        for(const auto& [algo_name, map_name, name, value] : statistics)
+            std::cout << algo_name << "," << map_name << "," << name << "," << value << std::endl;
+    }
 }
\ No newline at end of file
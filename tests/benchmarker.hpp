@@ -1,9 +1,17 @@
 #ifndef BENCHMARKER_HPP
 #define BENCHMARKER_HPP
 
+#include <filesystem>
+
 namespace Benchmarker
 {
-    void benchmark();
+    /**
+     * Runs all the scenarios with all the algorithms and prints the results.
+     *
+     * @param preprocessed_dir If not empty, the preprocessed data of the algorithms (see Algorithm::save_preprocessed())
+     *      is loaded from this directory instead of preprocessing the maps, or saved into it after preprocessing.
+     */
+    void benchmark(const std::filesystem::path& preprocessed_dir = {});
 }
 
 #endif
\ No newline at end of file
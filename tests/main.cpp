@@ -73,6 +73,7 @@ int main(int argc, char** argv)
 
     std::string benchmark_str;
     std::string algos_str;
+    std::string preprocessed_str;
     int benchmark_amount = 0;
 
     using namespace Catch::Clara;
@@ -82,7 +83,9 @@ int main(int argc, char** argv)
         | Opt(benchmark_amount, "benchmark amount")
         ["--amount"]("only execute this amount of benchmarking scenarios, sampled randomly from all files")
         | Opt(algos_str, "algorithms")
-        ["--algorithms"]("only benchmark the specified algorithms, delimited by a comma: --algorithms A*,JPS");
+        ["--algorithms"]("only benchmark the specified algorithms, delimited by a comma: --algorithms A*,JPS (some algorithms are only benchmarked when specified)")
+        | Opt(preprocessed_str, "preprocessed directory")
+        ["--preprocessed"]("load the preprocessed data of the algorithms from this directory, or save it there if it is missing");
 
     session.cli(cli);
     int ret = session.applyCommandLine(argc, argv);
@@ -95,17 +98,21 @@ int main(int argc, char** argv)
         while((idx = algos_str.find(',')) != std::string::npos)
         {
             auto substr = algos_str.substr(0, idx);
-            algos.emplace_back(substr, algorithms.at(substr));
+            algos.emplace_back(substr, algorithms.at(substr).algorithm);
             algos_str.erase(0, idx + 1);
         }
         if(algos_str != "")
         {
-            algos.emplace_back(algos_str, algorithms.at(algos_str));
+            algos.emplace_back(algos_str, algorithms.at(algos_str).algorithm);
         }
     }
     else
     {
-        algos = {algorithms.begin(), algorithms.end()};
+        for(auto& [name, entry] : algorithms)
+        {
+            if(!entry.opt_in)
+                algos.emplace_back(name, entry.algorithm);
+        }
     }
     
     if(benchmark_str != "")
@@ -158,7 +165,9 @@ int main(int argc, char** argv)
         }
 
 benchmark:
-        Benchmarker::benchmark();
+        if(preprocessed_str != "")
+            std::filesystem::create_directories(preprocessed_str);
+        Benchmarker::benchmark(preprocessed_str);
         return 0;
     }
 
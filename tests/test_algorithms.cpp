@@ -1,4 +1,9 @@
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <span>
+#include <sstream>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
@@ -6,8 +11,127 @@
 #include "algorithms/algorithm.hpp"
 #include "algorithms/a_star.hpp"
 #include "algorithms/jps.hpp"
+#include "algorithms/jps_b.hpp"
+#include "algorithms/jps_plus.hpp"
+#include "algorithms/bbfs.hpp"
+#include "algorithms/bidirectional_jps.hpp"
+#include "algorithms/canonical_dijkstra.hpp"
+#include "algorithms/ch_search.hpp"
+#include "algorithms/cpd_search.hpp"
+#include "algorithms/hpa_star.hpp"
+#include "algorithms/hub_label_search.hpp"
+#include "algorithms/optimized_a_star.hpp"
+#include "algorithms/subgoal_search.hpp"
 #include "main.hpp"
 
+using Query = std::pair<Point, Point>;
+
+/**
+ * Runs the algorithm on the state until it finishes.
+ */
+static Algorithm::Result run(Algorithm& algo, State& s)
+{
+    algo.init(&s);
+    while(algo.update() == Algorithm::Result::Type::EXECUTING) {}
+    return algo.get_result();
+}
+
+/**
+ * An empty map with rectangular obstacles scattered over it.
+ * The three rows and columns at the top and left border and the last row and column are left empty.
+ */
+static State make_obstacle_map(int width, int height, int obstacles)
+{
+    State s;
+    s.width = width;
+    s.height = height;
+    s.map = std::vector<Node>(width * height, Node::UNVISITED);
+    for(int i = 0; i < obstacles; ++i)
+    {
+        int left = 3 + (i * 37) % (width - 6);
+        int top = 3 + (i * 23) % (height - 6);
+        for(int y = top; y < std::min(top + 2 + i % 6, height - 1); ++y)
+        {
+            for(int x = left; x < std::min(left + 1 + i % 4, width - 1); ++x)
+                s.map[y * width + x] = Node::WALL;
+        }
+    }
+    return s;
+}
+
+/**
+ * Surrounds a cell near the top right corner of the map with walls, so that it cannot be reached.
+ *
+ * @returns The enclosed cell.
+ */
+static Point enclose_cell(State& s)
+{
+    Point cell{s.width - 4, 2};
+    for(int y = cell.y - 1; y <= cell.y + 1; ++y)
+    {
+        for(int x = cell.x - 1; x <= cell.x + 1; ++x)
+        {
+            if(x != cell.x || y != cell.y)
+                s.map[y * s.width + x] = Node::WALL;
+        }
+    }
+    return cell;
+}
+
+/**
+ * Runs the queries with the algorithm and with the reference.
+ * The paths of the algorithm must be as long as those of the reference and made of valid moves between neighbouring
+ * cells from the beginning to the end of the query. The queries from and to the unreachable cell must fail.
+ */
+template<typename Reference = AStar<HeadlessPolicy>>
+static void require_same_lengths(Algorithm& algo, State& s, std::span<const Query> queries, Point unreachable)
+{
+    Reference reference;
+    for(auto [begin, end] : queries)
+    {
+        s.begin = begin;
+        s.end = end;
+        auto expected = run(reference, s);
+        auto res = run(algo, s);
+        REQUIRE(expected.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(expected.length, 1e-5f));
+        REQUIRE(res.path.size() == expected.path.size());
+
+        float length = 0;
+        Point prev = begin;
+        for(auto point : res.path)
+        {
+            REQUIRE(std::max(std::abs(point.x - prev.x), std::abs(point.y - prev.y)) == 1);
+            REQUIRE(s.map[point.y * s.width + point.x] != Node::WALL);
+            REQUIRE((point.x == prev.x || point.y == prev.y
+                  || (s.map[prev.y * s.width + point.x] != Node::WALL && s.map[point.y * s.width + prev.x] != Node::WALL)));
+            length += point.x != prev.x && point.y != prev.y ? SQRT_2 : 1.0f;
+            prev = point;
+        }
+        REQUIRE(prev == end);
+        REQUIRE_THAT(length, Catch::Matchers::WithinRel(res.length, 1e-5f));
+    }
+
+    s.begin = queries[0].first;
+    s.end = unreachable;
+    REQUIRE(run(algo, s).type == Algorithm::Result::Type::FAILURE);
+    std::swap(s.begin, s.end);
+    REQUIRE(run(algo, s).type == Algorithm::Result::Type::FAILURE);
+}
+
+/**
+ * Requires that the preprocessed data in the stream is not loaded for a map with other walls.
+ */
+static void require_rejected_for_other_walls(Algorithm& algo, const State& s, std::stringstream& data)
+{
+    State other = s;
+    other.map[0] = other.map[0] == Node::WALL ? Node::UNVISITED : Node::WALL;
+    data.clear();
+    data.seekg(0);
+    REQUIRE_FALSE(algo.load_preprocessed(other, data));
+}
+
 TEST_CASE("Amount of expansions and examinations", "[algorithm]")
 {
     std::filesystem::path test_map_path;
@@ -65,4 +189,1516 @@ TEST_CASE("Amount of expansions and examinations", "[algorithm]")
         REQUIRE(jps.update() == Algorithm::Result::SUCCESS);
         REQUIRE_THAT(jps.get_result().length, Catch::Matchers::WithinAbs(6.8284, 0.0001));
     }
+
+    SECTION("JPS with deferred jumps")
+    {
+        JumpPointSearch<DeferredJumps<HeadlessPolicy>> jps;
+        jps.init(&s);
+        jps.update();
+
+        // Every cell scanned by the jumps is examined, but only the jump points become nodes.
+        REQUIRE(jps.get_result().expanded == 1);
+        REQUIRE(jps.get_result().examined == 44);
+
+        jps.update();
+        REQUIRE(jps.get_result().expanded == 2);
+        REQUIRE(jps.get_result().examined == (44 + 6));
+
+        jps.update();
+        REQUIRE(jps.get_result().expanded == 3);
+        REQUIRE(jps.get_result().examined == (44 + 6 + 10));
+
+        REQUIRE(jps.update() == Algorithm::Result::SUCCESS);
+        REQUIRE(jps.get_result().path.size() == 6);
+        REQUIRE_THAT(jps.get_result().length, Catch::Matchers::WithinAbs(6.8284, 0.0001));
+    }
+}
+
+TEST_CASE("Observer policies", "[algorithm]")
+{
+    std::filesystem::path test_map_path;
+
+    if(std::filesystem::exists(std::filesystem::current_path() / "test_map.map"))
+        test_map_path = std::filesystem::current_path() / "test_map.map";
+    else
+        test_map_path = std::filesystem::current_path() / "tests" / "test_map.map";
+
+    load_map("test_map", test_map_path.c_str());
+
+    State& s = maps.at("test_map");
+    s.begin = {4, 4};
+    s.end = {8, 2};
+    const auto original_map = s.map;
+
+    SECTION("headless algorithms do not write into the map")
+    {
+        AStar<HeadlessPolicy> a_star;
+        JumpPointSearch<HeadlessPolicy> jps;
+        BBFS<HeadlessPolicy> bbfs;
+        OptimizedAStar<HeadlessPolicy> optimized_a_star;
+
+        for(Algorithm* algo : std::initializer_list<Algorithm*>{&a_star, &jps, &bbfs, &optimized_a_star})
+        {
+            algo->init(&s);
+            while(algo->update() == Algorithm::Result::Type::EXECUTING) {}
+            REQUIRE(algo->get_result().type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(s.map == original_map);
+        }
+    }
+
+    SECTION("visual algorithms record their progress")
+    {
+        AStar<VisualPolicy> a_star;
+        a_star.init(&s);
+        while(a_star.update() == Algorithm::Result::Type::EXECUTING) {}
+
+        for(auto [x, y] : a_star.get_result().path)
+        {
+            if(Point{x, y} != s.end)
+                REQUIRE(s.map[Util::flatten(s.width, x, y)] == Node::PATH);
+        }
+        REQUIRE(std::count(s.map.begin(), s.map.end(), Node::EXPANDED_1) > 0);
+        REQUIRE(std::count(s.map.begin(), s.map.end(), Node::EXAMINED_1) > 0);
+
+        // Other tests use the same map
+        s.map = original_map;
+    }
+}
+
+TEST_CASE("Power-of-two layout gives the same results", "[algorithm]")
+{
+    std::filesystem::path test_map_path;
+
+    if(std::filesystem::exists(std::filesystem::current_path() / "test_map.map"))
+        test_map_path = std::filesystem::current_path() / "test_map.map";
+    else
+        test_map_path = std::filesystem::current_path() / "tests" / "test_map.map";
+
+    load_map("test_map", test_map_path.c_str());
+
+    State& s = maps.at("test_map");
+    s.begin = {0, 9};
+    s.end = {9, 0};
+
+    AStar<HeadlessPolicy> a_star;
+    AStar<PowerOfTwoStride<HeadlessPolicy>> a_star_padded;
+    auto res = run(a_star, s);
+    auto res_padded = run(a_star_padded, s);
+    REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+    REQUIRE(res_padded.path == res.path);
+    REQUIRE(res_padded.length == res.length);
+    REQUIRE(res_padded.expanded == res.expanded);
+
+    JumpPointSearch<HeadlessPolicy> jps;
+    JumpPointSearch<PowerOfTwoStride<HeadlessPolicy>> jps_padded;
+    res = run(jps, s);
+    res_padded = run(jps_padded, s);
+    REQUIRE(res_padded.path == res.path);
+    REQUIRE(res_padded.length == res.length);
+}
+
+TEST_CASE("Integer cost model gives the same results", "[algorithm]")
+{
+    std::filesystem::path test_map_path;
+
+    if(std::filesystem::exists(std::filesystem::current_path() / "test_map.map"))
+        test_map_path = std::filesystem::current_path() / "test_map.map";
+    else
+        test_map_path = std::filesystem::current_path() / "tests" / "test_map.map";
+
+    load_map("test_map", test_map_path.c_str());
+
+    State& s = maps.at("test_map");
+    s.begin = {0, 9};
+    s.end = {9, 0};
+
+    AStar<HeadlessPolicy> reference;
+    auto expected = run(reference, s);
+    REQUIRE(expected.type == Algorithm::Result::Type::SUCCESS);
+
+    auto check = [&](Algorithm& algo)
+    {
+        auto res = run(algo, s);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(expected.length, 1e-5));
+        REQUIRE(res.path.back() == s.end);
+    };
+
+    SECTION("A*")
+    {
+        AStar<IntegerCost<HeadlessPolicy>> algo;
+        check(algo);
+    }
+
+    SECTION("JPS")
+    {
+        JumpPointSearch<IntegerCost<HeadlessPolicy>> algo;
+        check(algo);
+    }
+
+    SECTION("BBFS")
+    {
+        BBFS<IntegerCost<HeadlessPolicy>> algo;
+        check(algo);
+    }
+
+    SECTION("OptimizedA*")
+    {
+        OptimizedAStar<IntegerCost<HeadlessPolicy>> algo;
+        check(algo);
+    }
+}
+
+TEST_CASE("Indexed open list gives the same results", "[algorithm]")
+{
+    std::filesystem::path test_map_path;
+
+    if(std::filesystem::exists(std::filesystem::current_path() / "test_map.map"))
+        test_map_path = std::filesystem::current_path() / "test_map.map";
+    else
+        test_map_path = std::filesystem::current_path() / "tests" / "test_map.map";
+
+    load_map("test_map", test_map_path.c_str());
+
+    State& s = maps.at("test_map");
+    s.begin = {0, 9};
+    s.end = {9, 0};
+
+    // Both open lists order the nodes by (key, node index), so the same nodes are expanded in the same order.
+    AStar<HeadlessPolicy> a_star;
+    AStar<IndexedOpenList<HeadlessPolicy>> a_star_indexed;
+    auto res = run(a_star, s);
+    auto res_indexed = run(a_star_indexed, s);
+    REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+    REQUIRE(res_indexed.path == res.path);
+    REQUIRE(res_indexed.length == res.length);
+    REQUIRE(res_indexed.expanded == res.expanded);
+
+    JumpPointSearch<HeadlessPolicy> jps;
+    JumpPointSearch<IndexedOpenList<HeadlessPolicy>> jps_indexed;
+    res = run(jps, s);
+    res_indexed = run(jps_indexed, s);
+    REQUIRE(res_indexed.path == res.path);
+    REQUIRE(res_indexed.length == res.length);
+    REQUIRE(res_indexed.expanded == res.expanded);
+}
+
+TEST_CASE("Switching between maps reuses the node arrays", "[algorithm]")
+{
+    auto make_map = [](int width, int height)
+    {
+        State s;
+        s.width = width;
+        s.height = height;
+        s.map = std::vector<Node>(width * height, Node::UNVISITED);
+        for(int y = 1; y < height - 1; ++y)
+            s.map[y * width + width / 2] = Node::WALL;
+        s.begin = {0, height / 2};
+        s.end = {width - 1, height / 2};
+        return s;
+    };
+
+    State small = make_map(10, 10);
+    State large = make_map(40, 30);
+
+    AStar<HeadlessPolicy> reference_small;
+    AStar<HeadlessPolicy> reference_large;
+    auto expected_small = run(reference_small, small);
+    auto expected_large = run(reference_large, large);
+
+    AStar<HeadlessPolicy> a_star;
+    BBFS<HeadlessPolicy> bbfs;
+    OptimizedAStar<HeadlessPolicy> optimized_a_star;
+    run(a_star, large);
+    run(bbfs, large);
+    run(optimized_a_star, large);
+    auto bytes = a_star.get_memory_usage();
+
+    for(int i = 0; i < 5; ++i)
+    {
+        auto res = run(a_star, i % 2 ? large : small);
+        auto& expected = i % 2 ? expected_large : expected_small;
+        REQUIRE(res.path == expected.path);
+        REQUIRE(res.expanded == expected.expanded);
+
+        // The node arrays of the large map are returned into the scratch pool for the small map, and leased again for the large map.
+        if(i % 2)
+            REQUIRE(a_star.get_memory_usage() == bytes);
+        else
+            REQUIRE(a_star.get_memory_usage() <= bytes);
+
+        REQUIRE(run(bbfs, i % 2 ? large : small).type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE_THAT(run(optimized_a_star, i % 2 ? large : small).length, Catch::Matchers::WithinRel(expected.length, 1e-5));
+    }
+}
+
+TEST_CASE("Walls edited between queries are seen after a new revision", "[algorithm]")
+{
+    State s;
+    s.width = 20;
+    s.height = 10;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    s.begin = {0, 5};
+    s.end = {19, 5};
+
+    AStar<HeadlessPolicy> a_star;
+    JumpPointSearch<HeadlessPolicy> jps;
+    BlockJumpPointSearch<HeadlessPolicy> jps_b;
+    BBFS<HeadlessPolicy> bbfs;
+    OptimizedAStar<HeadlessPolicy> optimized_a_star;
+    // The preprocessed data is tied to the grid, so it is built again as well.
+    JumpPointSearchPlus<HeadlessPolicy> jps_plus;
+    ContractionHierarchySearch<HeadlessPolicy> ch;
+    SubgoalGraphSearch<HeadlessPolicy> subgoals;
+    CompressedPathDatabaseSearch<HeadlessPolicy> cpd;
+    HubLabelSearch<HeadlessPolicy> labels;
+    std::vector<Algorithm*> algorithms = {&a_star, &jps, &jps_b, &bbfs, &optimized_a_star, &jps_plus, &ch, &subgoals, &cpd, &labels};
+    for(Algorithm* algo : algorithms)
+        REQUIRE_THAT(run(*algo, s).length, Catch::Matchers::WithinAbs(19, 1e-4));
+
+    // A wall across the straight path, left open at the bottom, written directly into the map
+    for(int y = 0; y < s.height - 1; ++y)
+        s.map[y * s.width + 10] = Node::WALL;
+    s.revision++;
+
+    for(Algorithm* algo : algorithms)
+    {
+        auto res = run(*algo, s);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE(res.length > 19.5f);
+        for(Point point : res.path)
+            REQUIRE(s.map[point.y * s.width + point.x] != Node::WALL);
+    }
+}
+
+TEST_CASE("Another map assigned into a state is seen without a new revision", "[algorithm]")
+{
+    State s;
+    s.width = 20;
+    s.height = 10;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    s.begin = {0, 5};
+    s.end = {19, 5};
+
+    // The same map with a wall across all of it
+    State other = s;
+    for(int y = 0; y < other.height; ++y)
+        other.map[y * other.width + 10] = Node::WALL;
+    REQUIRE(other.revision != s.revision);
+
+    AStar<HeadlessPolicy> a_star;
+    OptimizedAStar<HeadlessPolicy> optimized_a_star;
+    JumpPointSearchPlus<HeadlessPolicy> jps_plus;
+    ContractionHierarchySearch<HeadlessPolicy> ch;
+    CompressedPathDatabaseSearch<HeadlessPolicy> cpd;
+    HubLabelSearch<HeadlessPolicy> labels;
+    std::vector<Algorithm*> algorithms = {&a_star, &optimized_a_star, &jps_plus, &ch, &cpd, &labels};
+    for(Algorithm* algo : algorithms)
+        REQUIRE(run(*algo, s).type == Algorithm::Result::Type::SUCCESS);
+
+    s = other;
+    for(Algorithm* algo : algorithms)
+        REQUIRE(run(*algo, s).type == Algorithm::Result::Type::FAILURE);
+}
+
+TEST_CASE("Narrow stamps survive run id rollover", "[algorithm]")
+{
+    std::filesystem::path test_map_path;
+
+    if(std::filesystem::exists(std::filesystem::current_path() / "test_map.map"))
+        test_map_path = std::filesystem::current_path() / "test_map.map";
+    else
+        test_map_path = std::filesystem::current_path() / "tests" / "test_map.map";
+
+    load_map("test_map", test_map_path.c_str());
+
+    State& s = maps.at("test_map");
+    s.begin = {0, 9};
+    s.end = {9, 0};
+
+    AStar<HeadlessPolicy> reference;
+    auto expected = run(reference, s);
+
+    // 16-bit stamps run out of run ids after 8191 runs.
+    AStar<NarrowStamps<HeadlessPolicy>> a_star;
+    for(int i = 0; i < 10000; ++i)
+    {
+        auto res = run(a_star, s);
+        if(res.path != expected.path || res.expanded != expected.expanded)
+        {
+            FAIL("different result on run " << i);
+        }
+    }
+}
+
+TEST_CASE("Hashed node store gives the same results", "[algorithm]")
+{
+    // Large enough for the hash table to grow during the search.
+    State s;
+    s.width = 120;
+    s.height = 90;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    for(int y = 0; y < s.height - 5; ++y)
+        s.map[y * s.width + s.width / 2] = Node::WALL;
+    s.begin = {5, 10};
+    s.end = {s.width - 5, 10};
+
+    auto check = [&](Algorithm& dense, Algorithm& hashed)
+    {
+        auto expected = run(dense, s);
+        REQUIRE(expected.type == Algorithm::Result::Type::SUCCESS);
+        for(int i = 0; i < 3; ++i)
+        {
+            auto res = run(hashed, s);
+            REQUIRE(res.path == expected.path);
+            REQUIRE(res.length == expected.length);
+            REQUIRE(res.expanded == expected.expanded);
+        }
+    };
+
+    SECTION("A*")
+    {
+        AStar<HeadlessPolicy> dense;
+        AStar<HashedNodes<HeadlessPolicy>> hashed;
+        check(dense, hashed);
+    }
+
+    SECTION("JPS")
+    {
+        JumpPointSearch<HeadlessPolicy> dense;
+        JumpPointSearch<HashedNodes<HeadlessPolicy>> hashed;
+        check(dense, hashed);
+    }
+
+    SECTION("OptimizedA*")
+    {
+        OptimizedAStar<HeadlessPolicy> dense;
+        OptimizedAStar<HashedNodes<HeadlessPolicy>> hashed;
+        check(dense, hashed);
+    }
+
+    SECTION("adaptive A*")
+    {
+        AStar<HeadlessPolicy> dense;
+        AStar<AdaptiveNodes<HeadlessPolicy>> adaptive;
+        check(dense, adaptive);
+    }
+}
+
+TEST_CASE("Block-based JPS gives the same results", "[algorithm]")
+{
+    // An open map with scattered rectangular obstacles, so that the jumps cross several 64-cell blocks.
+    State s = make_obstacle_map(300, 200, 40);
+    Point enclosed = enclose_cell(s);
+
+    BlockJumpPointSearch<HeadlessPolicy> jps_b;
+    BlockJumpPointSearch<IntegerCost<HeadlessPolicy>> jps_b_int;
+
+    // The paths are compared cell by cell, so the cells between the jump points must be filled in.
+    Query queries[] = {{{0, 0}, {299, 199}}, {{299, 0}, {0, 199}}, {{150, 199}, {150, 0}}, {{5, 100}, {290, 100}}};
+    require_same_lengths(jps_b, s, queries, enclosed);
+    require_same_lengths(jps_b_int, s, queries, enclosed);
+}
+
+TEST_CASE("JPS+ jump distances", "[algorithm]")
+{
+    // .....
+    // ..#..
+    // .....
+    State s;
+    s.width = 5;
+    s.height = 3;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    s.map[1 * s.width + 2] = Node::WALL;
+    s.begin = {0, 0};
+    s.end = {4, 2};
+
+    JumpPointSearchPlus<HeadlessPolicy> jps_plus;
+    jps_plus.init(&s);
+
+    // (3, 0) has a forced neighbour when moving east: the wall is behind it on the south side.
+    REQUIRE(jps_plus.get_jump_distance(0, 0, DIR_EAST) == 3);
+    REQUIRE(jps_plus.get_jump_distance(3, 0, DIR_EAST) == -1);
+    REQUIRE(jps_plus.get_jump_distance(4, 0, DIR_EAST) == 0);
+    REQUIRE(jps_plus.get_jump_distance(2, 2, DIR_NORTH) == 0);
+    // Moving southeast from (0, 0) is blocked by the corner of the wall at (1, 1).
+    REQUIRE(jps_plus.get_jump_distance(1, 0, DIR_SOUTHEAST) == 0);
+    REQUIRE(jps_plus.get_preprocessed_memory_usage() == s.map.size() * 16);
+
+    // The jump distances of wider maps do not fit in the tables, so they are searched with JPS.
+    State wide;
+    wide.width = JumpPointSearchPlus<HeadlessPolicy>::MAX_SIZE + 1;
+    wide.height = 1;
+    wide.map = std::vector<Node>(wide.width * wide.height, Node::UNVISITED);
+    wide.begin = {0, 0};
+    wide.end = {wide.width - 1, 0};
+    auto res = run(jps_plus, wide);
+    REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+    REQUIRE(res.path.size() == wide.width - 1);
+    REQUIRE(jps_plus.get_preprocessing_time() == 0);
+    std::stringstream tables;
+    REQUIRE_FALSE(jps_plus.save_preprocessed(tables));
+
+    // The tables of the first map are still used for it.
+    REQUIRE(run(jps_plus, s).type == Algorithm::Result::Type::SUCCESS);
+    REQUIRE(jps_plus.get_preprocessing_time() == 0);
+    REQUIRE(jps_plus.save_preprocessed(tables));
+}
+
+TEST_CASE("JPS+ gives the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(300, 200, 60);
+    Point enclosed = enclose_cell(s);
+
+    JumpPointSearchPlus<HeadlessPolicy> jps_plus;
+
+    Query queries[] = {{{0, 0}, {299, 199}}, {{299, 0}, {0, 199}}, {{150, 199}, {150, 0}}, {{5, 100}, {290, 105}}, {{60, 5}, {61, 6}}};
+
+    SECTION("preprocessed once per map")
+    {
+        require_same_lengths(jps_plus, s, queries, enclosed);
+        REQUIRE(jps_plus.get_preprocessing_time() == 0);
+
+        s.revision++;
+        run(jps_plus, s);
+        REQUIRE(jps_plus.get_preprocessing_time() > 0);
+    }
+
+    SECTION("integer distances")
+    {
+        JumpPointSearchPlus<IntegerCost<HeadlessPolicy>> jps_plus_int;
+        require_same_lengths(jps_plus_int, s, queries, enclosed);
+    }
+
+    SECTION("saved and loaded tables")
+    {
+        run(jps_plus, s);
+        std::stringstream tables;
+        REQUIRE(jps_plus.save_preprocessed(tables));
+
+        JumpPointSearchPlus<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, tables));
+        require_same_lengths(loaded, s, queries, enclosed);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+
+        require_rejected_for_other_walls(loaded, s, tables);
+
+        std::stringstream garbage{"not a table"};
+        REQUIRE_FALSE(loaded.load_preprocessed(s, garbage));
+    }
+
+    SECTION("tables repaired after map edits")
+    {
+        run(jps_plus, s);
+
+        // Walls added next to the obstacles and in the open, obstacles removed, a wall across the map with a gap
+        // that is then closed, and edits at the border
+        std::vector<Point> edits;
+        for(int i = 0; i < 60; ++i)
+            edits.push_back({(i * 89 + 7) % s.width, (i * 43 + 3) % s.height});
+        for(int y = 1; y < s.height - 1; ++y)
+        {
+            if(y != 120)
+                edits.push_back({200, y});
+        }
+        edits.push_back({200, 120});
+        edits.push_back({0, 50});
+        edits.push_back({s.width - 1, s.height - 2});
+
+        for(auto [x, y] : edits)
+        {
+            auto& cell = s.map[y * s.width + x];
+            cell = cell == Node::WALL ? Node::UNVISITED : Node::WALL;
+            s.revision++;
+            REQUIRE(jps_plus.update_preprocessed(s, x, y));
+        }
+
+        JumpPointSearchPlus<HeadlessPolicy> rebuilt;
+        run(rebuilt, s);
+        for(int y = 0; y < s.height; ++y)
+        {
+            for(int x = 0; x < s.width; ++x)
+            {
+                for(int i = 0; i < 8; ++i)
+                    REQUIRE(jps_plus.get_jump_distance(x, y, directions[i]) == rebuilt.get_jump_distance(x, y, directions[i]));
+            }
+        }
+
+        require_same_lengths(jps_plus, s, queries, enclosed);
+        REQUIRE(jps_plus.get_preprocessing_time() == 0);
+
+        // The repaired tables are saved for the walls they were repaired for.
+        std::stringstream tables;
+        REQUIRE(jps_plus.save_preprocessed(tables));
+        JumpPointSearchPlus<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, tables));
+
+        // A change that was not reported cannot be repaired.
+        s.map[5 * s.width + 5] = Node::WALL;
+        s.map[6 * s.width + 5] = Node::WALL;
+        s.revision += 2;
+        REQUIRE_FALSE(jps_plus.update_preprocessed(s, 5, 6));
+        run(jps_plus, s);
+        REQUIRE(jps_plus.get_preprocessing_time() > 0);
+    }
+}
+
+TEST_CASE("Goal bounding boxes", "[algorithm]")
+{
+    // .....
+    // ..#..
+    // .....
+    State s;
+    s.width = 5;
+    s.height = 3;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    s.map[1 * s.width + 2] = Node::WALL;
+    s.begin = {0, 1};
+    s.end = {4, 1};
+
+    Grid grid{s};
+    GoalBounds bounds;
+    REQUIRE(bounds.update(s, grid));
+    REQUIRE_FALSE(bounds.update(s, grid));
+
+    // The optimal paths from (1, 1) to the right side go around the wall from above or from below.
+    auto& north = bounds.get_box(1, 1, DIR_NORTH);
+    REQUIRE(north.contains(4, 1));
+    REQUIRE(north.contains(1, 0));
+    REQUIRE_FALSE(north.contains(1, 2));
+    REQUIRE(bounds.contains(1, 1, DIR_SOUTH, 4, 1));
+    REQUIRE_FALSE(bounds.contains(1, 1, DIR_WEST, 4, 1));
+    // The wall blocks the move east.
+    REQUIRE(bounds.get_box(1, 1, DIR_EAST).empty());
+    REQUIRE(bounds.get_memory_usage() == s.map.size() * 64);
+}
+
+TEST_CASE("Goal bounding gives the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(60, 40, 25);
+    // An enclosed area that cannot be reached
+    for(int x = 50; x < 55; ++x)
+    {
+        s.map[33 * s.width + x] = Node::WALL;
+        s.map[37 * s.width + x] = Node::WALL;
+    }
+    for(int y = 33; y < 38; ++y)
+    {
+        s.map[y * s.width + 50] = Node::WALL;
+        s.map[y * s.width + 54] = Node::WALL;
+    }
+
+    Query queries[] = {{{0, 0}, {59, 39}}, {{59, 0}, {0, 39}}, {{30, 39}, {30, 0}}, {{1, 20}, {58, 21}}, {{10, 1}, {11, 2}}};
+
+    auto check = [&](Algorithm& plain, Algorithm& bounded)
+    {
+        for(auto [begin, end] : queries)
+        {
+            s.begin = begin;
+            s.end = end;
+            auto expected = run(plain, s);
+            auto res = run(bounded, s);
+            REQUIRE(expected.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(expected.length, 1e-5));
+            REQUIRE(res.path.back() == end);
+            REQUIRE(res.expanded <= expected.expanded);
+        }
+
+        // The enclosed area is reached by no optimal path, but it may still lie within the boxes.
+        s.begin = {0, 0};
+        s.end = {52, 35};
+        REQUIRE(run(bounded, s).type == Algorithm::Result::Type::FAILURE);
+    };
+
+    SECTION("A*")
+    {
+        AStar<HeadlessPolicy> a_star;
+        AStar<GoalBounding<HeadlessPolicy>> bounded;
+        check(a_star, bounded);
+    }
+
+    SECTION("JPS")
+    {
+        JumpPointSearch<HeadlessPolicy> jps;
+        JumpPointSearch<GoalBounding<HeadlessPolicy>> bounded;
+        check(jps, bounded);
+    }
+
+    SECTION("built once per map, saved and loaded")
+    {
+        AStar<GoalBounding<HeadlessPolicy>> bounded;
+        run(bounded, s);
+        REQUIRE(bounded.get_preprocessing_time() > 0);
+        run(bounded, s);
+        REQUIRE(bounded.get_preprocessing_time() == 0);
+
+        std::stringstream tables;
+        REQUIRE(bounded.save_preprocessed(tables));
+
+        JumpPointSearch<GoalBounding<HeadlessPolicy>> loaded;
+        JumpPointSearch<HeadlessPolicy> jps;
+        REQUIRE(loaded.load_preprocessed(s, tables));
+        check(jps, loaded);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+
+        require_rejected_for_other_walls(loaded, s, tables);
+
+        // Algorithms without goal bounding have nothing to save.
+        std::stringstream nothing;
+        REQUIRE_FALSE(jps.save_preprocessed(nothing));
+    }
+}
+
+TEST_CASE("JPS with deferred jumps gives the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(300, 200, 40);
+    Point enclosed = enclose_cell(s);
+
+    JumpPointSearch<DeferredJumps<HeadlessPolicy>> deferred;
+    JumpPointSearch<DeferredJumps<HashedNodes<HeadlessPolicy>>> deferred_hashed;
+
+    // The paths are compared cell by cell, so the cells between the jump points must be filled in.
+    Query queries[] = {{{0, 0}, {299, 199}}, {{299, 0}, {0, 199}}, {{150, 199}, {150, 0}}, {{5, 100}, {290, 100}}, {{60, 5}, {61, 6}}};
+    require_same_lengths(deferred, s, queries, enclosed);
+    require_same_lengths(deferred_hashed, s, queries, enclosed);
+}
+
+TEST_CASE("JPS jumps along long corridors without recursing", "[algorithm]")
+{
+    // A single row: the straight jump from the beginning passes a million cells.
+    State s;
+    s.width = 1 << 20;
+    s.height = 1;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    s.begin = {0, 0};
+    s.end = {s.width - 1, 0};
+
+    JumpPointSearch<HeadlessPolicy> jps;
+    JumpPointSearch<DeferredJumps<HashedNodes<HeadlessPolicy>>> deferred;
+    for(Algorithm* algo : {(Algorithm*)&jps, (Algorithm*)&deferred})
+    {
+        auto res = run(*algo, s);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE(res.path.size() == s.width - 1);
+        REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(s.width - 1.0, 1e-5));
+    }
+
+    // Only the beginning and the end are nodes, so the hash table stays at its initial size.
+    REQUIRE(deferred.get_memory_usage() < jps.get_memory_usage() / 4);
+}
+
+TEST_CASE("Bidirectional JPS gives the same results", "[algorithm]")
+{
+    // A maze of walls with gaps, so that the paths wind back and forth
+    State s;
+    s.width = 121;
+    s.height = 81;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    for(int x = 4; x < s.width; x += 4)
+    {
+        for(int y = 0; y < s.height; ++y)
+        {
+            if((y + x * 7) % 9 > 2)
+                s.map[y * s.width + x] = Node::WALL;
+        }
+    }
+    for(int y = 6; y < s.height; y += 12)
+    {
+        for(int x = 0; x < s.width; ++x)
+        {
+            if((x + y * 5) % 17 > 3)
+                s.map[y * s.width + x] = Node::WALL;
+        }
+    }
+    Point enclosed = enclose_cell(s);
+
+    BidirectionalJumpPointSearch<HeadlessPolicy> bidirectional;
+    BidirectionalJumpPointSearch<IntegerCost<HeadlessPolicy>> bidirectional_int;
+    BidirectionalJumpPointSearch<HashedNodes<HeadlessPolicy>> bidirectional_hashed;
+
+    // The halves are joined into one path of neighbouring cells.
+    Query queries[] =
+    {
+        {{0, 0}, {119, 77}}, {{119, 0}, {0, 80}}, {{61, 40}, {0, 40}}, {{5, 79}, {117, 4}},
+        {{9, 9}, {10, 10}}, {{2, 2}, {100, 40}}, {{100, 40}, {2, 2}}
+    };
+    JumpPointSearch<HeadlessPolicy> jps;
+    for(Algorithm* algo : {(Algorithm*)&bidirectional, (Algorithm*)&bidirectional_int, (Algorithm*)&bidirectional_hashed})
+    {
+        require_same_lengths(*algo, s, queries, enclosed);
+
+        // A query from a cell to itself is answered like by JPS.
+        s.begin = {50, 50};
+        s.end = {50, 50};
+        REQUIRE(run(*algo, s).type == run(jps, s).type);
+    }
+}
+
+TEST_CASE("Canonical Dijkstra distance fields", "[algorithm]")
+{
+    State s = make_obstacle_map(120, 80, 30);
+    Point enclosed = enclose_cell(s);
+    s.begin = {60, 40};
+    s.end = {0, 0};
+
+    CanonicalDijkstra<HeadlessPolicy> dijkstra;
+    CanonicalDijkstra<IntegerCost<HeadlessPolicy>> dijkstra_int;
+    AStar<HeadlessPolicy> a_star;
+
+    dijkstra.compute(&s);
+    REQUIRE(dijkstra.get_result().type == Algorithm::Result::Type::SUCCESS);
+    dijkstra_int.compute(&s);
+
+    REQUIRE(dijkstra.get_distance(60, 40) == 0);
+    REQUIRE(dijkstra.get_parent_direction(60, 40) == nullptr);
+    REQUIRE(std::isinf(dijkstra.get_distance(enclosed.x, enclosed.y)));
+    REQUIRE(dijkstra.get_parent_direction(enclosed.x, enclosed.y) == nullptr);
+    std::vector<Point> path;
+    REQUIRE_FALSE(dijkstra.get_path(enclosed, path));
+
+    // The fields of one search answer the queries to every target.
+    for(int y = 0; y < s.height; y += 3)
+    {
+        for(int x = 0; x < s.width; x += 7)
+        {
+            if(s.map[y * s.width + x] == Node::WALL || Point{x, y} == enclosed || (x == 60 && y == 40))
+                continue;
+
+            s.end = {x, y};
+            float expected = run(a_star, s).length;
+
+            REQUIRE_THAT(dijkstra.get_distance(x, y), Catch::Matchers::WithinRel(expected, 1e-5f));
+            REQUIRE_THAT(dijkstra_int.get_distance(x, y), Catch::Matchers::WithinRel(expected, 1e-3f));
+
+            // The parent direction is the last move of a shortest path.
+            dir_t dir = dijkstra.get_parent_direction(x, y);
+            REQUIRE(dir != nullptr);
+            float parent_distance = dijkstra.get_distance(x - dir->movement.first, y - dir->movement.second);
+            REQUIRE_THAT(parent_distance + (dir->straight ? 1.0f : SQRT_2), Catch::Matchers::WithinRel(expected, 1e-5f));
+
+            REQUIRE(dijkstra.get_path({x, y}, path));
+            Point prev = s.begin;
+            for(auto point : path)
+            {
+                REQUIRE(std::abs(point.x - prev.x) <= 1);
+                REQUIRE(std::abs(point.y - prev.y) <= 1);
+                REQUIRE(s.map[point.y * s.width + point.x] != Node::WALL);
+                prev = point;
+            }
+            REQUIRE(prev == s.end);
+        }
+    }
+}
+
+TEST_CASE("HPA* cluster graph", "[algorithm]")
+{
+    // Two 16x16 clusters side by side. The first column of the right cluster is open on 3 cells (y = 2..4)
+    // and on its last 6 cells (y = 10..15), so the border has one short and one long entrance.
+    State s;
+    s.width = 32;
+    s.height = 16;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    for(int y = 0; y < 10; ++y)
+    {
+        if(y < 2 || y > 4)
+            s.map[y * s.width + 16] = Node::WALL;
+    }
+
+    Grid grid{s};
+    ClusterGraph graph;
+    REQUIRE(graph.update(s, grid, 16));
+    REQUIRE_FALSE(graph.update(s, grid, 16));
+
+    auto node_at = [&](Point cell)
+    {
+        for(uint32_t node = 0; node < graph.get_node_count(); ++node)
+        {
+            if(graph.get_cell(node) == cell)
+                return node;
+        }
+        FAIL("no node at " << cell.x << ", " << cell.y);
+        return uint32_t(0);
+    };
+    auto cost = [&](Point a, Point b)
+    {
+        auto [first, last] = graph.get_edges(node_at(a));
+        auto edge = std::find_if(first, last, [&](const ClusterGraph::Edge& e) { return e.to == node_at(b); });
+        return edge == last ? ClusterGraph::UNREACHABLE : edge->cost;
+    };
+
+    // The short entrance is crossed in its middle, the long one at both ends.
+    REQUIRE(graph.get_node_count() == 6);
+    auto [first, last] = graph.get_cluster_nodes(graph.get_cluster(0, 0));
+    REQUIRE(last - first == 3);
+    for(int y : {3, 10, 15})
+    {
+        REQUIRE(graph.get_cluster(15, y) == graph.get_cluster(0, 0));
+        REQUIRE(cost({15, y}, {16, y}) == OctileIntegerCost<>::STRAIGHT);
+        REQUIRE(cost({16, y}, {15, y}) == OctileIntegerCost<>::STRAIGHT);
+    }
+
+    // The nodes of a cluster are connected by the shortest paths inside the cluster.
+    REQUIRE(cost({15, 3}, {15, 10}) == 7 * OctileIntegerCost<>::STRAIGHT);
+    REQUIRE(cost({15, 3}, {15, 15}) == 12 * OctileIntegerCost<>::STRAIGHT);
+    REQUIRE(cost({16, 10}, {16, 15}) == 5 * OctileIntegerCost<>::STRAIGHT);
+    // Around the wall through (17, 4) to (17, 10)
+    REQUIRE(cost({16, 3}, {16, 10}) == 7 * OctileIntegerCost<>::STRAIGHT + OctileIntegerCost<>::DIAGONAL);
+    REQUIRE(cost({16, 10}, {16, 3}) == cost({16, 3}, {16, 10}));
+    REQUIRE(cost({15, 3}, {16, 10}) == ClusterGraph::UNREACHABLE);
+    REQUIRE(graph.get_edge_count() == 18);
+}
+
+TEST_CASE("HPA* gives near-optimal results", "[algorithm]")
+{
+    State s = make_obstacle_map(300, 200, 60);
+    Point enclosed = enclose_cell(s);
+
+    // The length of a path of neighbouring empty cells from the beginning, or -1 if it is not one
+    auto path_length = [&](const std::vector<Point>& path)
+    {
+        float length = 0;
+        Point prev = s.begin;
+        for(auto point : path)
+        {
+            int dx = point.x - prev.x;
+            int dy = point.y - prev.y;
+            if(std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0) || s.map[point.y * s.width + point.x] == Node::WALL)
+                return -1.0f;
+            length += dx != 0 && dy != 0 ? SQRT_2 : 1.0f;
+            prev = point;
+        }
+        return length;
+    };
+
+    AStar<HeadlessPolicy> a_star;
+    HierarchicalAStar<HeadlessPolicy> hpa;
+    HierarchicalAStar<HeadlessPolicy> hpa_lazy(16, true);
+
+    Query queries[] = {{{0, 0}, {299, 199}}, {{299, 0}, {0, 199}}, {{150, 199}, {150, 0}}, {{5, 100}, {290, 105}}, {{60, 5}, {61, 6}}};
+
+    SECTION("refined paths")
+    {
+        for(auto [begin, end] : queries)
+        {
+            s.begin = begin;
+            s.end = end;
+            auto expected = run(a_star, s);
+            auto res = run(hpa, s);
+            REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(res.length >= expected.length - 1e-3f);
+            REQUIRE(res.length <= expected.length * 1.1f);
+            REQUIRE(res.path.back() == end);
+            REQUIRE_THAT(path_length(res.path), Catch::Matchers::WithinRel(res.length, 1e-5f));
+        }
+
+        s.begin = {0, 0};
+        s.end = enclosed;
+        REQUIRE(run(hpa, s).type == Algorithm::Result::Type::FAILURE);
+    }
+
+    SECTION("lazily refined paths")
+    {
+        for(auto [begin, end] : queries)
+        {
+            s.begin = begin;
+            s.end = end;
+            auto expected = run(hpa, s);
+            auto res = run(hpa_lazy, s);
+            REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(res.length == expected.length);
+            REQUIRE(res.path.size() + 1 == hpa_lazy.get_waypoints().size());
+            REQUIRE(res.path.back() == end);
+
+            std::vector<Point> path;
+            for(size_t i = 0; i < res.path.size(); ++i)
+                REQUIRE(hpa_lazy.refine_segment(i, path));
+            REQUIRE_FALSE(hpa_lazy.refine_segment(res.path.size(), path));
+            REQUIRE(path == expected.path);
+        }
+    }
+
+    SECTION("saved and loaded graph")
+    {
+        s.begin = {0, 0};
+        s.end = {299, 199};
+        auto expected = run(hpa, s);
+        REQUIRE(hpa.get_preprocessing_time() > 0);
+        REQUIRE(hpa.get_graph().get_node_count() > 0);
+        std::stringstream graph;
+        REQUIRE(hpa.save_preprocessed(graph));
+
+        HierarchicalAStar<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, graph));
+        auto res = run(loaded, s);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+        REQUIRE(res.length == expected.length);
+        REQUIRE(res.path == expected.path);
+
+        // Graphs of other cluster sizes or maps are rejected.
+        graph.clear();
+        graph.seekg(0);
+        HierarchicalAStar<HeadlessPolicy> other_size(8);
+        REQUIRE_FALSE(other_size.load_preprocessed(s, graph));
+
+        require_rejected_for_other_walls(loaded, s, graph);
+    }
+}
+
+TEST_CASE("Contraction hierarchy edges", "[algorithm]")
+{
+    using Cost = OctileIntegerCost<>;
+
+    State s = make_obstacle_map(60, 40, 15);
+    Grid grid{s};
+    ContractionHierarchy hierarchy;
+    REQUIRE(hierarchy.update(s, grid));
+    REQUIRE_FALSE(hierarchy.update(s, grid));
+    REQUIRE(hierarchy.get_node_count() == std::count(s.map.begin(), s.map.end(), Node::UNVISITED));
+
+    auto find_edge = [&](uint32_t from, uint32_t to) -> const ContractionHierarchy::Edge*
+    {
+        auto [first, last] = hierarchy.get_upward_edges(from);
+        auto edge = std::find_if(first, last, [&](const ContractionHierarchy::Edge& e) { return e.to == to; });
+        return edge == last ? nullptr : edge;
+    };
+
+    size_t shortcuts = 0;
+    for(uint32_t node = 0; node < hierarchy.get_node_count(); ++node)
+    {
+        Point cell = hierarchy.get_cell(node);
+        REQUIRE(hierarchy.get_node(cell.x, cell.y) == node);
+
+        auto [first, last] = hierarchy.get_upward_edges(node);
+        for(auto edge = first; edge != last; ++edge)
+        {
+            // The node ids are the ranks, and only the edges to higher ranks are kept.
+            REQUIRE(edge->to > node);
+            Point to = hierarchy.get_cell(edge->to);
+
+            if(edge->middle == ContractionHierarchy::NO_NODE)
+            {
+                int dx = to.x - cell.x;
+                int dy = to.y - cell.y;
+                REQUIRE(std::max(std::abs(dx), std::abs(dy)) == 1);
+                REQUIRE(edge->cost == (dx != 0 && dy != 0 ? Cost::DIAGONAL : Cost::STRAIGHT));
+                continue;
+            }
+
+            // A shortcut passes through a node contracted before both of its ends, along the upward edges of that node.
+            shortcuts++;
+            REQUIRE(edge->middle < node);
+            auto down = find_edge(edge->middle, node);
+            auto up = find_edge(edge->middle, edge->to);
+            REQUIRE(down != nullptr);
+            REQUIRE(up != nullptr);
+            REQUIRE(edge->cost == down->cost + up->cost);
+        }
+    }
+    REQUIRE(shortcuts == hierarchy.get_shortcut_count());
+    REQUIRE(shortcuts > 0);
+
+    for(int y = 0; y < s.height; ++y)
+    {
+        for(int x = 0; x < s.width; ++x)
+        {
+            if(s.map[y * s.width + x] == Node::WALL)
+                REQUIRE(hierarchy.get_node(x, y) == ContractionHierarchy::NO_NODE);
+        }
+    }
+}
+
+TEST_CASE("Contraction hierarchies give the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(120, 80, 30);
+    Point enclosed = enclose_cell(s);
+
+    ContractionHierarchySearch<HeadlessPolicy> ch;
+
+    Query queries[] = {{{0, 0}, {119, 79}}, {{119, 0}, {0, 79}}, {{60, 79}, {60, 0}}, {{5, 40}, {110, 42}}, {{30, 5}, {31, 6}}};
+
+    SECTION("built once per map")
+    {
+        require_same_lengths(ch, s, queries, enclosed);
+        REQUIRE(ch.get_preprocessing_time() == 0);
+
+        s.revision++;
+        run(ch, s);
+        REQUIRE(ch.get_preprocessing_time() > 0);
+
+        auto statistics = ch.get_preprocessed_statistics();
+        auto shortcuts = std::find_if(statistics.begin(), statistics.end(), [](const auto& statistic) { return statistic.first == "shortcuts"; });
+        REQUIRE(shortcuts != statistics.end());
+        REQUIRE(shortcuts->second == ch.get_hierarchy().get_shortcut_count());
+        REQUIRE(ch.get_hierarchy().get_shortcut_count() > 0);
+    }
+
+    SECTION("saved and loaded hierarchy")
+    {
+        run(ch, s);
+        std::stringstream hierarchy;
+        REQUIRE(ch.save_preprocessed(hierarchy));
+
+        ContractionHierarchySearch<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, hierarchy));
+        require_same_lengths(loaded, s, queries, enclosed);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+        REQUIRE(loaded.get_hierarchy().get_shortcut_count() == ch.get_hierarchy().get_shortcut_count());
+
+        require_rejected_for_other_walls(loaded, s, hierarchy);
+    }
+}
+
+TEST_CASE("Subgoal graphs give the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(120, 80, 30);
+    Point enclosed = enclose_cell(s);
+
+    SubgoalGraphSearch<HeadlessPolicy> simple;
+    SubgoalGraphSearch<HeadlessPolicy> two_level(true);
+
+    // Including queries from and to subgoals, and between cells that see each other
+    Query queries[] = {{{0, 0}, {119, 79}}, {{119, 0}, {0, 79}}, {{60, 79}, {60, 0}}, {{5, 40}, {110, 42}},
+                       {{30, 5}, {31, 6}}, {{4, 4}, {100, 70}}, {{0, 40}, {119, 40}}};
+
+    SECTION("simple graph")
+    {
+        require_same_lengths(simple, s, queries, enclosed);
+
+        // The subgoals are at the corners of the walls, and all of them are global.
+        const SubgoalGraph& graph = simple.get_graph();
+        REQUIRE(graph.get_node_count() > 0);
+        REQUIRE(graph.get_first_global() == 0);
+        REQUIRE(graph.get_shortcut_count() == 0);
+        for(uint32_t node = 0; node < graph.get_node_count(); ++node)
+        {
+            Point cell = graph.get_cell(node);
+            REQUIRE(graph.get_node(cell.x, cell.y) == node);
+            bool corner = false;
+            for(int i = 1; i < 8; i += 2)
+            {
+                auto [dx, dy] = directions[i]->movement;
+                corner |= Util::is_wall(s, cell.x + dx, cell.y + dy)
+                    && Util::is_empty(s, cell.x + dx, cell.y) && Util::is_empty(s, cell.x, cell.y + dy);
+            }
+            REQUIRE(corner);
+        }
+    }
+
+    SECTION("two-level graph")
+    {
+        require_same_lengths(two_level, s, queries, enclosed);
+
+        const SubgoalGraph& graph = two_level.get_graph();
+        run(simple, s);
+        REQUIRE(graph.get_node_count() == simple.get_graph().get_node_count());
+        REQUIRE(graph.get_first_global() > 0);
+        REQUIRE(graph.get_shortcut_count() > 0);
+
+        auto statistics = two_level.get_preprocessed_statistics();
+        auto global = std::find_if(statistics.begin(), statistics.end(), [](const auto& statistic) { return statistic.first == "global_subgoals"; });
+        REQUIRE(global != statistics.end());
+        REQUIRE(global->second == graph.get_node_count() - graph.get_first_global());
+    }
+
+    SECTION("queries from a cell to itself")
+    {
+        s.begin = {7, 7};
+        s.end = {7, 7};
+        for(Algorithm* algo : {(Algorithm*)&simple, (Algorithm*)&two_level})
+        {
+            auto res = run(*algo, s);
+            REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(res.length == 0);
+            REQUIRE(res.path.empty());
+        }
+    }
+
+    SECTION("saved and loaded graph")
+    {
+        run(two_level, s);
+        std::stringstream graph;
+        REQUIRE(two_level.save_preprocessed(graph));
+
+        SubgoalGraphSearch<HeadlessPolicy> loaded(true);
+        REQUIRE(loaded.load_preprocessed(s, graph));
+        require_same_lengths(loaded, s, queries, enclosed);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+        REQUIRE(loaded.get_graph().get_first_global() == two_level.get_graph().get_first_global());
+
+        // Made for the two-level graph
+        graph.clear();
+        graph.seekg(0);
+        REQUIRE_FALSE(simple.load_preprocessed(s, graph));
+
+        require_rejected_for_other_walls(loaded, s, graph);
+    }
+}
+
+TEST_CASE("Compressed path database first moves", "[algorithm]")
+{
+    State s = make_obstacle_map(60, 40, 15);
+    Point enclosed = enclose_cell(s);
+
+    Grid grid{s};
+    CompressedPathDatabase database;
+    REQUIRE(database.update(s, grid));
+    REQUIRE_FALSE(database.update(s, grid));
+    REQUIRE(database.get_cell_count() == std::count(s.map.begin(), s.map.end(), Node::UNVISITED));
+
+    // The moves are symmetric, so the distance field from a target gives the distances of every source to it.
+    CanonicalDijkstra<IntegerCost<HeadlessPolicy>> dijkstra;
+    for(Point target : {Point{0, 0}, Point{31, 17}, Point{59, 39}})
+    {
+        s.begin = target;
+        dijkstra.compute(&s);
+        uint32_t target_id = database.get_id(target.x, target.y);
+        REQUIRE(database.get_cell(target_id) == target);
+        REQUIRE_FALSE(database.is_reachable(database.get_id(enclosed.x, enclosed.y), target_id));
+
+        for(int y = 0; y < s.height; ++y)
+        {
+            for(int x = 0; x < s.width; ++x)
+            {
+                if(s.map[y * s.width + x] == Node::WALL || Point{x, y} == target || Point{x, y} == enclosed)
+                    continue;
+
+                // The first move is valid and leads to a cell one move closer to the target.
+                uint32_t source_id = database.get_id(x, y);
+                REQUIRE(database.is_reachable(source_id, target_id));
+                dir_t dir = database.first_move(source_id, target_id);
+                REQUIRE(Util::is_move_valid(s, x, y, dir));
+                float next = dijkstra.get_distance(x + dir->movement.first, y + dir->movement.second);
+                REQUIRE_THAT(next + (dir->straight ? 1.0f : SQRT_2), Catch::Matchers::WithinAbs(dijkstra.get_distance(x, y), 1e-3f));
+            }
+        }
+    }
+}
+
+TEST_CASE("Compressed path database gives the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(60, 40, 15);
+    Point enclosed = enclose_cell(s);
+
+    CompressedPathDatabaseSearch<HeadlessPolicy> cpd;
+
+    Query queries[] = {{{0, 0}, {59, 39}}, {{59, 0}, {0, 39}}, {{30, 39}, {30, 0}}, {{2, 20}, {57, 21}}, {{15, 5}, {16, 6}}};
+
+    SECTION("built once per map")
+    {
+        require_same_lengths(cpd, s, queries, enclosed);
+        REQUIRE(cpd.get_preprocessing_time() == 0);
+
+        const CompressedPathDatabase& database = cpd.get_database();
+        REQUIRE(database.get_compression_ratio() > 1);
+        REQUIRE(database.get_run_count() < database.get_cell_count() * database.get_cell_count() / 4);
+
+        s.revision++;
+        run(cpd, s);
+        REQUIRE(cpd.get_preprocessing_time() > 0);
+    }
+
+    SECTION("first moves only")
+    {
+        s.begin = {0, 0};
+        s.end = {59, 39};
+        auto whole = run(cpd, s);
+
+        CompressedPathDatabaseSearch<HeadlessPolicy> first_moves(5);
+        auto res = run(first_moves, s);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE(res.path.size() == 5);
+        REQUIRE(std::equal(res.path.begin(), res.path.end(), whole.path.begin()));
+
+        std::vector<Point> cells;
+        REQUIRE(first_moves.get_database().extract(s.begin, s.end, 3, cells));
+        REQUIRE(std::equal(cells.begin(), cells.end(), whole.path.begin()));
+        REQUIRE(cells.size() == 3);
+    }
+
+    SECTION("saved and loaded database")
+    {
+        run(cpd, s);
+        std::stringstream database;
+        REQUIRE(cpd.save_preprocessed(database));
+
+        CompressedPathDatabaseSearch<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, database));
+        require_same_lengths(loaded, s, queries, enclosed);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+        REQUIRE(loaded.get_database().get_run_count() == cpd.get_database().get_run_count());
+
+        require_rejected_for_other_walls(loaded, s, database);
+    }
+}
+
+TEST_CASE("Differential heuristic gives the same results", "[algorithm]")
+{
+    // A serpentine of corridors, where the octile distance underestimates badly
+    State s;
+    s.width = 60;
+    s.height = 40;
+    s.map = std::vector<Node>(s.width * s.height, Node::UNVISITED);
+    for(int i = 1; i < 6; ++i)
+    {
+        int gap = i % 2 == 0 ? 0 : s.height - 1;
+        for(int y = 0; y < s.height; ++y)
+        {
+            if(std::abs(y - gap) > 2)
+                s.map[y * s.width + i * 10] = Node::WALL;
+        }
+    }
+    Point enclosed = enclose_cell(s);
+
+    Query queries[] = {{{0, 20}, {59, 20}}, {{5, 39}, {58, 0}}, {{35, 0}, {0, 0}}, {{1, 20}, {2, 21}}, {{15, 5}, {25, 35}}};
+
+    auto check = [&](Algorithm& plain, Algorithm& alt, bool optimal)
+    {
+        for(auto [begin, end] : queries)
+        {
+            s.begin = begin;
+            s.end = end;
+            auto expected = run(plain, s);
+            auto res = run(alt, s);
+            REQUIRE(expected.type == Algorithm::Result::Type::SUCCESS);
+            REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+            if(optimal)
+                REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(expected.length, 1e-5f));
+            REQUIRE(res.path.back() == end);
+            REQUIRE(res.expanded <= expected.expanded);
+        }
+
+        s.begin = {0, 0};
+        s.end = enclosed;
+        REQUIRE(run(alt, s).type == Algorithm::Result::Type::FAILURE);
+    };
+
+    SECTION("consistent lower bounds")
+    {
+        Grid grid;
+        grid.update(s, true);
+        Landmarks landmarks;
+        REQUIRE(landmarks.update(s, grid, 8));
+        REQUIRE_FALSE(landmarks.update(s, grid, 8));
+        REQUIRE(landmarks.get_count() == 8);
+        REQUIRE(landmarks.get_memory_per_landmark() == s.map.size() * 2);
+
+        using Cost = OctileIntegerCost<>;
+        AStar<IntegerCost<HeadlessPolicy>> a_star;
+        for(auto [begin, end] : queries)
+        {
+            s.begin = begin;
+            s.end = end;
+            auto distance = run(a_star, s).length * Cost::STRAIGHT;
+            REQUIRE(landmarks.heuristic<Cost>(begin.x, begin.y, end.x, end.y) <= distance);
+
+            // The heuristic decreases by at most the cost of every move.
+            for(int y = 0; y < s.height; ++y)
+            {
+                for(int x = 0; x < s.width; ++x)
+                {
+                    for(int i = 0; i < 8; ++i)
+                    {
+                        dir_t dir = directions[i];
+                        if(!Util::is_move_valid(s, x, y, dir))
+                            continue;
+
+                        Cost::distance_t from = landmarks.heuristic<Cost>(x, y, end.x, end.y);
+                        Cost::distance_t to = landmarks.heuristic<Cost>(x + dir->movement.first, y + dir->movement.second, end.x, end.y);
+                        REQUIRE(from - to <= Cost::move(dir));
+                    }
+                }
+            }
+        }
+
+        // Landmarks are only selected once per cell.
+        State small;
+        small.width = 2;
+        small.height = 1;
+        small.map = std::vector<Node>(2, Node::UNVISITED);
+        grid.update(small, true);
+        landmarks.update(small, grid, 8);
+        REQUIRE(landmarks.get_count() == 2);
+    }
+
+    SECTION("A*")
+    {
+        AStar<HeadlessPolicy> a_star;
+        AStar<DifferentialHeuristic<HeadlessPolicy>> alt;
+        check(a_star, alt, true);
+
+        // Fewer of the cells off the optimal paths are expanded.
+        s.begin = {0, 20};
+        s.end = {59, 20};
+        REQUIRE(run(alt, s).expanded < run(a_star, s).expanded);
+    }
+
+    SECTION("JPS")
+    {
+        JumpPointSearch<HeadlessPolicy> jps;
+        JumpPointSearch<DifferentialHeuristic<HeadlessPolicy>> alt;
+        check(jps, alt, true);
+    }
+
+    SECTION("Optimized A*")
+    {
+        OptimizedAStar<HeadlessPolicy> optimized;
+        OptimizedAStar<DifferentialHeuristic<HeadlessPolicy>> alt;
+        check(optimized, alt, false);
+    }
+
+    SECTION("built once per map, saved and loaded")
+    {
+        AStar<DifferentialHeuristic<HeadlessPolicy>> alt;
+        run(alt, s);
+        REQUIRE(alt.get_preprocessing_time() > 0);
+        run(alt, s);
+        REQUIRE(alt.get_preprocessing_time() == 0);
+
+        std::stringstream landmarks;
+        REQUIRE(alt.save_preprocessed(landmarks));
+
+        JumpPointSearch<DifferentialHeuristic<HeadlessPolicy>> loaded;
+        JumpPointSearch<HeadlessPolicy> jps;
+        REQUIRE(loaded.load_preprocessed(s, landmarks));
+        check(jps, loaded, true);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+
+        // Another amount of landmarks is built again.
+        landmarks.clear();
+        landmarks.seekg(0);
+        AStar<DifferentialHeuristic<HeadlessPolicy, 4>> fewer;
+        REQUIRE_FALSE(fewer.load_preprocessed(s, landmarks));
+    }
+}
+
+TEST_CASE("Hub label contents", "[algorithm]")
+{
+    State s = make_obstacle_map(60, 40, 15);
+    enclose_cell(s);
+
+    Grid grid{s};
+    HubLabels labels;
+    REQUIRE(labels.update(s, grid));
+    REQUIRE_FALSE(labels.update(s, grid));
+
+    // The search of the most important hub is the first one, so it labels only its own cell.
+    uint32_t top = 0;
+    while(labels.get_label_size(top) != 1 || labels.get_label(top).first[0] != 0)
+        top++;
+    CanonicalDijkstra<IntegerCost<HeadlessPolicy>> dijkstra;
+    s.begin = {int(top % s.width), int(top / s.width)};
+    dijkstra.compute(&s);
+
+    size_t entries = 0;
+    for(uint32_t cell = 0; cell < s.map.size(); ++cell)
+    {
+        auto [hubs, distances] = labels.get_label(cell);
+        entries += hubs.size();
+        if(s.map[cell] == Node::WALL)
+        {
+            REQUIRE(hubs.empty());
+            continue;
+        }
+
+        // Sorted by importance, with the cell itself as a hub at distance 0
+        REQUIRE(std::adjacent_find(hubs.begin(), hubs.end(), std::greater_equal<uint32_t>()) == hubs.end());
+        REQUIRE(std::count(distances.begin(), distances.end(), 0) == 1);
+
+        // The search of the first hub is never pruned, so every cell it reaches has it in its label with the exact distance.
+        float distance = dijkstra.get_distance(cell % s.width, cell / s.width);
+        if(std::isinf(distance))
+        {
+            REQUIRE(hubs[0] != 0);
+            continue;
+        }
+        REQUIRE(hubs[0] == 0);
+        REQUIRE(distances[0] == std::lround(distance * OctileIntegerCost<>::STRAIGHT));
+    }
+    REQUIRE(entries == labels.get_entry_count());
+}
+
+TEST_CASE("Hub labels give the same results", "[algorithm]")
+{
+    State s = make_obstacle_map(60, 40, 15);
+    Point enclosed = enclose_cell(s);
+    s.begin = {0, 0};
+    s.end = {59, 39};
+
+    using Reference = AStar<IntegerCost<HeadlessPolicy>>;
+    Reference a_star;
+    HubLabelSearch<HeadlessPolicy> labelled;
+
+    Query queries[] = {{{0, 0}, {59, 39}}, {{59, 0}, {0, 39}}, {{30, 39}, {30, 0}}, {{2, 20}, {57, 21}}, {{15, 5}, {16, 6}}};
+
+    SECTION("exact distances")
+    {
+        run(labelled, s);
+        const HubLabels& labels = labelled.get_labels();
+        REQUIRE(labels.get_cell_count() == std::count(s.map.begin(), s.map.end(), Node::UNVISITED));
+        REQUIRE(labels.get_max_label_size() >= 4);
+        REQUIRE(labels.get_entry_count() < labels.get_cell_count() * labels.get_cell_count() / 4);
+
+        // Every cell from a few sources, so that labels of all sizes are intersected
+        for(Point begin : {Point{0, 0}, Point{31, 17}, Point{59, 39}})
+        {
+            s.begin = begin;
+            for(int y = 0; y < s.height; y += 3)
+            {
+                for(int x = 0; x < s.width; ++x)
+                {
+                    if(s.map[y * s.width + x] == Node::WALL || Point{x, y} == begin)
+                        continue;
+
+                    s.end = {x, y};
+                    auto expected = run(a_star, s);
+                    HubLabels::distance_t distance = labels.distance(begin, s.end);
+                    if(expected.type == Algorithm::Result::Type::FAILURE)
+                        REQUIRE(distance == HubLabels::UNREACHABLE);
+                    else
+                        REQUIRE(distance == std::lround(expected.length * OctileIntegerCost<>::STRAIGHT));
+                }
+            }
+            REQUIRE(labels.distance(begin, begin) == 0);
+        }
+        REQUIRE(labels.distance(Point{0, 0}, enclosed) == HubLabels::UNREACHABLE);
+    }
+
+    SECTION("unpacked paths")
+    {
+        require_same_lengths<Reference>(labelled, s, queries, enclosed);
+        REQUIRE(labelled.get_preprocessing_time() == 0);
+
+        s.revision++;
+        run(labelled, s);
+        REQUIRE(labelled.get_preprocessing_time() > 0);
+    }
+
+    SECTION("distances only")
+    {
+        HubLabelSearch<HeadlessPolicy> distances(false);
+        s.begin = {0, 0};
+        s.end = {59, 39};
+        auto expected = run(a_star, s);
+        auto res = run(distances, s);
+        REQUIRE(res.type == Algorithm::Result::Type::SUCCESS);
+        REQUIRE_THAT(res.length, Catch::Matchers::WithinRel(expected.length, 1e-5f));
+        REQUIRE(res.path.empty());
+        REQUIRE(res.expanded == 1);
+    }
+
+    SECTION("saved and loaded labels")
+    {
+        run(labelled, s);
+        std::stringstream labels;
+        REQUIRE(labelled.save_preprocessed(labels));
+
+        HubLabelSearch<HeadlessPolicy> loaded;
+        REQUIRE(loaded.load_preprocessed(s, labels));
+        require_same_lengths<Reference>(loaded, s, queries, enclosed);
+        REQUIRE(loaded.get_preprocessing_time() == 0);
+        REQUIRE(loaded.get_labels().get_entry_count() == labelled.get_labels().get_entry_count());
+
+        require_rejected_for_other_walls(loaded, s, labels);
+    }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 
 #include "algorithms/bucket_queue.hpp"
+#include "algorithms/cost.hpp"
 
 TEST_CASE("basic insertion & popping", "[data_structure]")
 {
@@ -209,4 +210,160 @@ TEST_CASE("benchmark against std::priority_queue", "[!benchmark]")
     };
 
     INFO("realloc: " << realloc);
+}
+
+TEST_CASE("v2 basic insertion & popping", "[data_structure]")
+{
+    BucketQueueV2<char> queue{1.0f, 5};
+    REQUIRE(queue.get_bucket_amount() == 8);
+
+    queue.push(0.0, 123);
+    queue.push(1.1, 5);
+    queue.push(0.5, 61);
+    queue.push(3.0, 0);
+
+    auto e = queue.pop();
+    REQUIRE_THAT(e.value, Catch::Matchers::WithinAbs(0.0, 0.0001));
+    REQUIRE(e.object == 123);
+
+    e = queue.pop();
+    REQUIRE_THAT(e.value, Catch::Matchers::WithinAbs(0.5, 0.0001));
+    REQUIRE(e.object == 61);
+
+    e = queue.pop();
+    REQUIRE(e.object == 5);
+
+    e = queue.pop();
+    REQUIRE(e.object == 0);
+
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("v2 buckets grow independently", "[data_structure]")
+{
+    BucketQueueV2<int> q{1.0f, 4};
+
+    for(int i = 0; i < 100; ++i)
+        q.push(0.5f, i);
+    q.push(2.5f, 1000);
+    int reallocs = q.get_realloc_amount();
+
+    // Elements of a bucket come out in insertion order.
+    for(int i = 0; i < 100; ++i)
+        REQUIRE(q.pop().object == i);
+    REQUIRE(q.pop().object == 1000);
+    REQUIRE(q.empty());
+
+    // The buckets keep their memory after clear(), so the same load needs no more allocations.
+    q.clear();
+    for(int i = 0; i < 100; ++i)
+        q.push(0.5f, i);
+    q.push(2.5f, 1000);
+    REQUIRE(q.get_realloc_amount() == reallocs);
+}
+
+TEST_CASE("v2 wraps around the ring", "[data_structure]")
+{
+    BucketQueueV2<int> q{1.0f, 4};
+
+    float curr = 0.0f;
+    q.push(curr, 0);
+    for(int i = 1; i < 50; ++i)
+    {
+        auto e = q.pop();
+        REQUIRE(e.object == i - 1);
+        REQUIRE(q.empty());
+
+        curr = e.value + 2.5f;
+        q.push(curr, i);
+        q.update_write();
+    }
+}
+
+TEST_CASE("v2 sizing from the cost model", "[data_structure]")
+{
+    auto float_queue = BucketQueueV2<int, float>::for_cost<FloatCost>(10);
+    REQUIRE_THAT(float_queue.get_interval(), Catch::Matchers::WithinAbs(0.1, 0.0001));
+    REQUIRE(float_queue.get_bucket_amount() == 32);
+
+    using Integer = OctileIntegerCost<>;
+    auto integer_queue = BucketQueueV2<int, Integer::distance_t>::for_cost<Integer>(10);
+    REQUIRE(integer_queue.get_interval() == Integer::STRAIGHT / 10);
+    REQUIRE(integer_queue.get_bucket_amount() * integer_queue.get_interval() > 2 * Integer::DIAGONAL);
+}
+
+TEST_CASE("v2 repeated access", "[data_structure]")
+{
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<int> dist{0, 2 * 3363};
+    auto queue = BucketQueueV2<unsigned int, int>::for_cost<OctileIntegerCost<>>();
+    queue.push(2378, 420);
+
+    int curr_val = 0;
+
+    for(int i = 0; i < 10000; ++i)
+    {
+        auto [val, obj] = queue.pop();
+        REQUIRE(val >= curr_val - queue.get_interval());
+        REQUIRE(obj == 420);
+
+        curr_val = val;
+
+        for(int i = 0; i < 4; ++i)
+        {
+            queue.push(val + dist(gen), 420);
+        }
+        queue.update_write();
+    }
+}
+
+TEST_CASE("benchmark BucketQueueV2 against BucketQueue", "[!benchmark]")
+{
+    int amount = 5000;
+    float start = 10;
+    unsigned int start_val = 0;
+
+    int realloc = 0;
+    BENCHMARK("BucketQueue")
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+
+        BucketQueue<unsigned int> queue{0.1, 30, 5};
+        queue.push(start, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.push(val + dist(gen), obj + 1);
+            }
+            queue.update_write();
+        }
+        realloc = queue.get_realloc_amount();
+        return queue.pop();
+    };
+
+    int realloc_v2 = 0;
+    BENCHMARK("BucketQueueV2")
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+
+        auto queue = BucketQueueV2<unsigned int>::for_cost<FloatCost>();
+        queue.push(start, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.push(val + dist(gen), obj + 1);
+            }
+            queue.update_write();
+        }
+        realloc_v2 = queue.get_realloc_amount();
+        return queue.pop();
+    };
+
+    INFO("realloc: " << realloc << ", v2 bucket growths: " << realloc_v2);
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "state.hpp"
+#include "algorithms/node_store.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/a_star.hpp"
+#include "algorithms/jps.hpp"
+
+TEST_CASE("hashed node store", "[data_structure]")
+{
+    HashedNodeStore<SearchNode<>> store;
+
+    SECTION("nodes are reset when first touched in a run")
+    {
+        store.begin_run(1000);
+        store.touch(3).distance = 5.0f;
+        store.parent(3) = 7;
+        REQUIRE(store.touch(3).distance == 5.0f);
+        REQUIRE(store[3].distance == 5.0f);
+        REQUIRE(store.lookup(3) == &store[3]);
+        REQUIRE(store.lookup(4) == nullptr);
+        REQUIRE(store.parents()[3] == 7);
+        REQUIRE(store.size() == 1);
+
+        store.begin_run(1000);
+        REQUIRE(store.size() == 0);
+        REQUIRE(store.lookup(3) == nullptr);
+        REQUIRE(store.touch(3).distance == std::numeric_limits<float>::infinity());
+    }
+
+    SECTION("growing keeps the touched nodes")
+    {
+        // Scattered indices of a large map, far more than the initial capacity.
+        constexpr node_index amount = 20000;
+        auto key = [](node_index i) { return i * 7919 % 100000007; };
+
+        store.begin_run(100000007);
+        for(node_index i = 0; i < amount; ++i)
+        {
+            auto& node = store.touch(key(i));
+            node.distance = i;
+            node.set_status(i % 2);
+            store.parent(key(i)) = i + 1;
+        }
+        REQUIRE(store.size() == amount);
+        REQUIRE(store.get_capacity() >= 2 * amount);
+
+        for(node_index i = 0; i < amount; ++i)
+        {
+            REQUIRE(store[key(i)].distance == i);
+            REQUIRE(store[key(i)].status() == i % 2);
+            REQUIRE(store.parent(key(i)) == i + 1);
+        }
+
+        // The capacity is kept for the next run, whose nodes start out fresh.
+        auto capacity = store.get_capacity();
+        store.begin_run(100000007);
+        REQUIRE(store.get_capacity() == capacity);
+        REQUIRE(store.touch(key(5)).distance == std::numeric_limits<float>::infinity());
+        REQUIRE(store.touch(key(5)).status() == 0);
+    }
+}
+
+TEST_CASE("adaptive node store", "[data_structure]")
+{
+    AdaptiveNodeStore<SearchNode<>> store;
+
+    store.begin_run(100);
+    REQUIRE_FALSE(store.is_hashed());
+    store.touch(10).distance = 1.0f;
+    store.parent(10) = 4;
+    REQUIRE(store.parents()[10] == 4);
+    REQUIRE(store.lookup(10)->distance == 1.0f);
+    REQUIRE(store.lookup(11) == nullptr);
+
+    store.begin_run(AdaptiveNodeStore<SearchNode<>>::HASHED_THRESHOLD);
+    REQUIRE(store.is_hashed());
+    REQUIRE(store.touch(10).distance == std::numeric_limits<float>::infinity());
+    store.parent(10) = 5;
+    REQUIRE(store.parents()[10] == 5);
+    REQUIRE(store.lookup(10) != nullptr);
+    REQUIRE(store.lookup(11) == nullptr);
+    REQUIRE(store.get_memory_usage() < AdaptiveNodeStore<SearchNode<>>::HASHED_THRESHOLD);
+}
+
+TEST_CASE("benchmark hashed node store against the dense layout", "[!benchmark]")
+{
+    // Short queries (at most 30 cells in each direction) on maps of increasing size with 12% random walls.
+    // The dense arrays cover the whole map, the hash table only the visited area.
+    for(int size : {256, 1024, 2048, 4096})
+    {
+        State s;
+        s.width = size;
+        s.height = size;
+        s.map = std::vector<Node>((size_t)size * size, Node::UNVISITED);
+
+        std::mt19937 gen{0};
+        for(auto& cell : s.map)
+        {
+            if(gen() % 100 < 12)
+                cell = Node::WALL;
+        }
+
+        std::uniform_int_distribution<int> position{30, size - 31};
+        std::uniform_int_distribution<int> offset{-30, 30};
+        std::vector<std::pair<Point, Point>> queries;
+        while(queries.size() < 100)
+        {
+            Point begin{position(gen), position(gen)};
+            Point end{begin.x + offset(gen), begin.y + offset(gen)};
+            if(s.map[begin.y * size + begin.x] != Node::WALL && s.map[end.y * size + end.x] != Node::WALL && begin != end)
+                queries.emplace_back(begin, end);
+        }
+
+        auto run = [&](Algorithm& algo)
+        {
+            size_t expanded = 0;
+            for(auto [begin, end] : queries)
+            {
+                s.begin = begin;
+                s.end = end;
+                algo.init(&s);
+                while(algo.update() == Algorithm::Result::Type::EXECUTING) {}
+                expanded += algo.get_result().expanded;
+            }
+            return expanded;
+        };
+
+        AStar<HeadlessPolicy> a_star;
+        AStar<HashedNodes<HeadlessPolicy>> a_star_hashed;
+        JumpPointSearch<HeadlessPolicy> jps;
+        JumpPointSearch<HashedNodes<HeadlessPolicy>> jps_hashed;
+
+        auto name = std::to_string(size) + "x" + std::to_string(size);
+        BENCHMARK("A* dense " + name) { return run(a_star); };
+        BENCHMARK("A* hashed " + name) { return run(a_star_hashed); };
+        BENCHMARK("JPS dense " + name) { return run(jps); };
+        BENCHMARK("JPS hashed " + name) { return run(jps_hashed); };
+
+        WARN(name << ": A* uses " << a_star.get_memory_usage() << " bytes dense, "
+            << a_star_hashed.get_memory_usage() << " bytes hashed");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "algorithms/open_list.hpp"
+
+TEST_CASE("lazy binary heap keeps duplicates", "[data_structure]")
+{
+    LazyBinaryHeap<float> heap;
+    heap.init(10);
+
+    heap.push(3.0f, 1);
+    heap.push(1.0f, 2);
+    heap.push(2.0f, 1);
+    REQUIRE(heap.size() == 3);
+
+    REQUIRE(heap.top() == std::pair<float, node_index>{1.0f, 2});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<float, node_index>{2.0f, 1});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<float, node_index>{3.0f, 1});
+    heap.pop();
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("indexed heap decrease-key", "[data_structure]")
+{
+    IndexedDaryHeap<int> heap;
+    heap.init(10);
+
+    heap.push(50, 1);
+    heap.push(40, 2);
+    heap.push(30, 3);
+    REQUIRE(heap.contains(1));
+    REQUIRE_FALSE(heap.contains(4));
+
+    // Lowering the key moves the node in place, a higher key is ignored.
+    heap.push(10, 1);
+    heap.push(60, 2);
+    REQUIRE(heap.size() == 3);
+
+    REQUIRE(heap.top() == std::pair<int, node_index>{10, 1});
+    heap.pop();
+    REQUIRE_FALSE(heap.contains(1));
+    REQUIRE(heap.top() == std::pair<int, node_index>{30, 3});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int, node_index>{40, 2});
+    heap.pop();
+    REQUIRE(heap.empty());
+
+    SECTION("positions from previous searches are not trusted")
+    {
+        heap.push(5, 7);
+        heap.init(10);
+        REQUIRE_FALSE(heap.contains(7));
+        heap.push(8, 3);
+        heap.push(6, 7);
+        REQUIRE(heap.size() == 2);
+        REQUIRE(heap.top().second == 7);
+    }
+}
+
+TEST_CASE("indexed heap matches a reference queue", "[data_structure]")
+{
+    constexpr node_index node_count = 1000;
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<int> key_dist{0, 10000};
+    std::uniform_int_distribution<node_index> node_dist{0, node_count - 1};
+
+    IndexedDaryHeap<int> heap;
+    heap.init(node_count);
+
+    // Reference: the lowest pushed key of each node currently in the heap
+    std::vector<int> keys(node_count, -1);
+
+    for(int i = 0; i < 20000; ++i)
+    {
+        if(i % 3 != 2)
+        {
+            auto node = node_dist(gen);
+            auto key = key_dist(gen);
+            heap.push(key, node);
+            if(keys[node] == -1 || key < keys[node])
+                keys[node] = key;
+        }
+        else if(!heap.empty())
+        {
+            auto [key, node] = heap.top();
+            heap.pop();
+            std::pair<int, node_index> lowest{std::numeric_limits<int>::max(), 0};
+            for(node_index other = 0; other < node_count; ++other)
+            {
+                if(keys[other] != -1)
+                    lowest = std::min(lowest, {keys[other], other});
+            }
+            REQUIRE(lowest == std::pair{key, node});
+            keys[node] = -1;
+        }
+    }
+
+    size_t amount = 0;
+    for(auto key : keys)
+        amount += key != -1;
+    REQUIRE(heap.size() == amount);
+}
+
+TEST_CASE("benchmark indexed heap against the lazy binary heap", "[!benchmark]")
+{
+    int amount = 5000;
+    node_index node_count = 4096;
+
+    auto run = [&](auto& heap)
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+        std::uniform_int_distribution<node_index> node_dist{0, node_count - 1};
+
+        heap.init(node_count);
+        heap.push(10.0f, 0);
+        for(int i = 0; i < amount && !heap.empty(); ++i)
+        {
+            auto [val, obj] = heap.top();
+            heap.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                heap.push(val + dist(gen), node_dist(gen));
+            }
+        }
+        return heap.size();
+    };
+
+    BENCHMARK("LazyBinaryHeap")
+    {
+        LazyBinaryHeap<float> heap;
+        return run(heap);
+    };
+
+    BENCHMARK("IndexedDaryHeap")
+    {
+        IndexedDaryHeap<float> heap;
+        return run(heap);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "algorithms/radix_heap.hpp"
+#include "algorithms/bucket_queue.hpp"
+
+TEST_CASE("radix heap insertion & popping", "[data_structure]")
+{
+    RadixHeap<int> heap;
+    heap.init(0);
+
+    heap.push(0, 123);
+    heap.push(11, 5);
+    heap.push(5, 61);
+    heap.push(30, 0);
+    REQUIRE(heap.size() == 4);
+
+    REQUIRE(heap.top() == std::pair<int, node_index>{0, 123});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int, node_index>{5, 61});
+    heap.pop();
+
+    heap.push(7, 8);
+    REQUIRE(heap.top() == std::pair<int, node_index>{7, 8});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int, node_index>{11, 5});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int, node_index>{30, 0});
+    heap.pop();
+
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("radix heap float keys", "[data_structure]")
+{
+    RadixHeap<float> heap;
+    heap.init(0);
+
+    heap.push(1.5f, 1);
+    heap.push(0.25f, 2);
+    heap.push(1.41421356f, 3);
+
+    REQUIRE_THAT(heap.top().first, Catch::Matchers::WithinAbs(0.25, 0.0001));
+    REQUIRE(heap.top().second == 2);
+    heap.pop();
+    REQUIRE(heap.top().second == 3);
+    heap.pop();
+    REQUIRE(heap.top().second == 1);
+    heap.pop();
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("radix heap 64-bit keys", "[data_structure]")
+{
+    RadixHeap<int64_t> heap;
+    heap.init(0);
+
+    // Keys above 2^32, which differ only in their high bits or only in their low bits
+    heap.push(int64_t{5} << 32, 1);
+    heap.push((int64_t{3} << 32) + 7, 2);
+    heap.push(int64_t{3} << 32, 3);
+    heap.push(9, 4);
+
+    REQUIRE(heap.top() == std::pair<int64_t, node_index>{9, 4});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int64_t, node_index>{int64_t{3} << 32, 3});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int64_t, node_index>{(int64_t{3} << 32) + 7, 2});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int64_t, node_index>{int64_t{5} << 32, 1});
+    heap.pop();
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("radix heap keys below the last popped key", "[data_structure]")
+{
+    RadixHeap<int> heap;
+    heap.init(0);
+
+    heap.push(10, 1);
+    heap.push(20, 2);
+    heap.pop();
+
+    // No window: a lower key is popped next, as if it was equal to the last popped key.
+    heap.push(0, 3);
+    REQUIRE(heap.top() == std::pair<int, node_index>{10, 3});
+    heap.pop();
+    REQUIRE(heap.top().second == 2);
+}
+
+TEST_CASE("radix heap init", "[data_structure]")
+{
+    RadixHeap<int> heap;
+    heap.init(0);
+
+    heap.push(1000, 1);
+    heap.push(2000, 2);
+    heap.pop();
+
+    heap.init(0);
+    REQUIRE(heap.empty());
+    heap.push(3, 3);
+    heap.push(1, 4);
+    REQUIRE(heap.top() == std::pair<int, node_index>{1, 4});
+    heap.pop();
+    REQUIRE(heap.top() == std::pair<int, node_index>{3, 3});
+}
+
+TEST_CASE("radix heap matches std::priority_queue", "[data_structure]")
+{
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<int> dist{0, 3363 * 2};
+
+    RadixHeap<int> heap;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> reference;
+    heap.init(0);
+    heap.push(2378, 0);
+    reference.push(2378);
+
+    for(int i = 0; i < 10000 && !heap.empty(); ++i)
+    {
+        auto [key, node] = heap.top();
+        REQUIRE(key == reference.top());
+        heap.pop();
+        reference.pop();
+
+        for(int i = 0; i < 3; ++i)
+        {
+            auto new_key = key + dist(gen);
+            heap.push(new_key, i);
+            reference.push(new_key);
+        }
+        REQUIRE(heap.size() == reference.size());
+    }
+}
+
+TEST_CASE("benchmark radix heap against std::priority_queue and BucketQueue", "[!benchmark]")
+{
+    int amount = 5000;
+    float start = 10;
+    unsigned int start_val = 0;
+
+    BENCHMARK("std::priority_queue")
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+
+        std::priority_queue<std::pair<float, unsigned int>> queue;
+        queue.emplace(start, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.top();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.emplace(val + dist(gen), obj + 1);
+            }
+            queue.pop();
+        }
+        return queue.top();
+    };
+
+    BENCHMARK("BucketQueue")
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+
+        BucketQueue<unsigned int> queue{0.1, 30, 5};
+        queue.push(start, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.push(val + dist(gen), obj + 1);
+            }
+            queue.update_write();
+        }
+        return queue.pop();
+    };
+
+    BENCHMARK("RadixHeap")
+    {
+        std::mt19937 gen{0};
+        std::uniform_real_distribution dist{0.0f, 2.82842712f};
+
+        RadixHeap<float> queue;
+        queue.init(0);
+        queue.push(start, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.top();
+            queue.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.push(val + dist(gen), obj + 1);
+            }
+        }
+        return queue.top();
+    };
+
+    BENCHMARK("RadixHeap (integer keys)")
+    {
+        std::mt19937 gen{0};
+        std::uniform_int_distribution<int> dist{0, 3363 * 2};
+
+        RadixHeap<int> queue;
+        queue.init(0);
+        queue.push(start * 2378, start_val);
+        for(int i = 0; i < amount; ++i)
+        {
+            auto [val, obj] = queue.top();
+            queue.pop();
+            for(int i = 0; i < 5; ++i)
+            {
+                queue.push(val + dist(gen), obj + 1);
+            }
+        }
+        return queue.top();
+    };
+}
\ No newline at end of file
@@ -1,9 +1,18 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <limits>
+#include <thread>
 #include <utility>
 
 #include "state.hpp"
 #include "algorithms/util.hpp"
+#include "algorithms/search_node.hpp"
+#include "algorithms/grid.hpp"
+#include "algorithms/layout.hpp"
+#include "algorithms/cost.hpp"
+#include "algorithms/scratch_pool.hpp"
+#include "algorithms/scratch_arena.hpp"
 
 using namespace Util;
 
@@ -100,6 +109,42 @@ TEST_CASE("heuristic functions", "[maths]")
 
     auto diagonal_heuristic = diagonal_distance(0, 0, 3, 3);
     REQUIRE_THAT(diagonal_heuristic, Catch::Matchers::WithinAbs(3 * std::sqrt(2), 0.0001));
+
+    auto integer_heuristic = diagonal_distance(0, 0, 5, 3, 10, 14);
+    REQUIRE(integer_heuristic == 3 * 14 + 2 * 10);
+}
+
+TEST_CASE("cost models", "[maths]")
+{
+    REQUIRE(FloatCost::move(DIR_NORTH) == 1.0f);
+    REQUIRE(FloatCost::move(DIR_NORTHEAST) == SQRT_2);
+
+    using Integer = OctileIntegerCost<>;
+    REQUIRE(Integer::move(DIR_EAST) == Integer::STRAIGHT);
+    REQUIRE(Integer::move(DIR_SOUTHWEST) == Integer::DIAGONAL);
+    REQUIRE_THAT((double)Integer::DIAGONAL / Integer::STRAIGHT, Catch::Matchers::WithinRel(std::sqrt(2), 1e-7));
+
+    // Integer sums are exact: two different orders of the same moves give exactly the same distance.
+    Integer::distance_t a = 0, b = 0;
+    for(int i = 0; i < 1000; ++i)
+    {
+        a += Integer::DIAGONAL;
+        b += Integer::STRAIGHT;
+    }
+    for(int i = 0; i < 1000; ++i)
+    {
+        a += Integer::STRAIGHT;
+        b += Integer::DIAGONAL;
+    }
+    REQUIRE(a == b);
+    REQUIRE(Integer::heuristic(0, 0, 1000, 2000) == a);
+    REQUIRE_THAT(Integer::to_float(a), Catch::Matchers::WithinRel(1000 + 1000 * std::sqrt(2), 1e-6));
+
+    // A path through a 16384x16384 maze can visit half of its cells, far more moves than a 32-bit distance allows.
+    Integer::distance_t maze_path = Integer::distance_t(16384) * 16384 / 2 * Integer::DIAGONAL;
+    REQUIRE(maze_path > std::numeric_limits<int32_t>::max());
+    REQUIRE(maze_path + Integer::heuristic(0, 0, 16383, 16383) > maze_path);
+    REQUIRE_THAT(Integer::to_float(maze_path), Catch::Matchers::WithinRel(16384.0 * 16384 / 2 * std::sqrt(2), 1e-6));
 }
 
 TEST_CASE("building path", "[map]")
@@ -171,9 +216,404 @@ TEST_CASE("bidirectional node formatting", "[map]")
         10, 11, 8
     };
 
+    // The backward chain can also be read from separate nodes, which are left untouched.
+    I forward_nodes[12];
+    std::copy(std::begin(nodes), std::end(nodes), std::begin(forward_nodes));
+    Util::format_bidirectional_nodes(forward_nodes, nodes, 3, 6);
+    for(int i = 0; i < 12; ++i)
+    {
+        REQUIRE(forward_nodes[i] == target[i]);
+    }
+
     Util::format_bidirectional_nodes(nodes, 3, 6);
     for(int i = 0; i < 12; ++i)
     {
         REQUIRE(nodes[i] == target[i]);
     }
+}
+
+TEST_CASE("compact node records", "[map]")
+{
+    REQUIRE(sizeof(SearchNode<float>) == 8);
+    REQUIRE(sizeof(SearchNode<int32_t>) == 8);
+    REQUIRE(sizeof(SearchNode<int64_t>) == 12);
+    REQUIRE(sizeof(node_index) == 4);
+
+    SearchNode node;
+    Util::lazy_initialize(1, node);
+    REQUIRE(node.is_current(1));
+    REQUIRE(node.status() == 0);
+
+    node.distance = 2.0f;
+    node.set_status(5);
+    REQUIRE(node.status() == 5);
+    REQUIRE(node.is_current(1));
+
+    // Same run: nothing changes
+    Util::lazy_initialize(1, node);
+    REQUIRE(node.status() == 5);
+    REQUIRE(node.distance == 2.0f);
+
+    // New run: the node is reset
+    Util::lazy_initialize(2, node);
+    REQUIRE(node.is_current(2));
+    REQUIRE_FALSE(node.is_current(1));
+    REQUIRE(node.status() == 0);
+    REQUIRE(node.distance == std::numeric_limits<float>::infinity());
+}
+
+TEST_CASE("bit-packed grid", "[map]")
+{
+    State s = {
+        .map = {Node::WALL, Node::UNVISITED, Node::END,
+                Node::UNVISITED, Node::UNVISITED, Node::WALL,
+                Node::UNVISITED, Node::START, Node::UNVISITED},
+        .width = 3,
+        .height = 3
+    };
+    Grid grid{s};
+
+    SECTION("walls and the border")
+    {
+        REQUIRE(grid.is_wall(0, 0));
+        REQUIRE(grid.is_wall(2, 1));
+        REQUIRE(grid.is_empty(2, 0));
+        REQUIRE(grid.is_empty(1, 2));
+        for(int i = -1; i <= 3; ++i)
+        {
+            REQUIRE(grid.is_wall(i, -1));
+            REQUIRE(grid.is_wall(i, 3));
+            REQUIRE(grid.is_wall(-1, i));
+            REQUIRE(grid.is_wall(3, i));
+        }
+    }
+
+    SECTION("same moves and neighbours as with the state")
+    {
+        for(int y = 0; y < s.height; ++y)
+        {
+            for(int x = 0; x < s.width; ++x)
+            {
+                for(int i = 0; i < 8; ++i)
+                {
+                    dir_t dir = directions[i];
+                    REQUIRE(Util::is_move_valid(grid, x, y, dir) == Util::is_move_valid(s, x, y, dir));
+                }
+
+                std::pair<node_index, dir_t> state_buffer[8];
+                std::pair<node_index, dir_t> grid_buffer[8];
+                int amount = Util::get_neighbours(state_buffer, s, x, y);
+                REQUIRE(Util::get_neighbours(grid_buffer, grid, x, y) == amount);
+                for(int i = 0; i < amount; ++i)
+                {
+                    REQUIRE(state_buffer[i] == grid_buffer[i]);
+                }
+            }
+        }
+    }
+
+    SECTION("precomputed successor masks")
+    {
+        Grid precomputed;
+        precomputed.build(s, true);
+        for(int y = 0; y < s.height; ++y)
+        {
+            for(int x = 0; x < s.width; ++x)
+            {
+                REQUIRE(precomputed.successors(x, y) == grid.compute_successors(x, y));
+                for(int i = 0; i < 8; ++i)
+                {
+                    bool valid = (precomputed.successors(x, y) >> i) & 1;
+                    REQUIRE(valid == Util::is_move_valid(s, x, y, directions[i]));
+                }
+            }
+        }
+        REQUIRE(precomputed.get_memory_usage() > grid.get_memory_usage());
+    }
+
+    SECTION("rebuilt only when the walls change")
+    {
+        REQUIRE_FALSE(grid.update(s));
+
+        s.map[0] = Node::UNVISITED;
+        s.revision++;
+        REQUIRE(grid.update(s));
+        REQUIRE(grid.is_empty(0, 0));
+        REQUIRE_FALSE(grid.update(s));
+    }
+
+    SECTION("wide maps span multiple words per row")
+    {
+        State wide = {.map = std::vector<Node>(100 * 2, Node::UNVISITED), .width = 100, .height = 2};
+        wide.map[Util::flatten(100, 70, 1)] = Node::WALL;
+        Grid wide_grid{wide};
+        REQUIRE(wide_grid.is_wall(70, 1));
+        REQUIRE(wide_grid.is_empty(70, 0));
+        REQUIRE(wide_grid.is_empty(99, 1));
+        REQUIRE(wide_grid.is_wall(100, 1));
+
+        REQUIRE_FALSE(wide_grid.update(wide));
+        wide.map[Util::flatten(100, 10, 0)] = Node::WALL;
+        wide.revision++;
+        REQUIRE(wide_grid.update(wide));
+        REQUIRE(wide_grid.is_wall(10, 0));
+    }
+
+    SECTION("rows and columns are read 64 cells at a time")
+    {
+        State large = {.map = std::vector<Node>(150 * 130, Node::UNVISITED), .width = 150, .height = 130};
+        for(size_t i = 0; i < large.map.size(); i += 7)
+            large.map[i] = Node::WALL;
+        Grid blocks;
+        blocks.build(large, false, true);
+
+        for(int y = -1; y <= large.height; y += 13)
+        {
+            for(int x = -1; x <= large.width; x += 11)
+            {
+                for(int i = 0; i < 64; ++i)
+                {
+                    // Only the cells up to the border are specified.
+                    if(x + i <= large.width)
+                        REQUIRE(((blocks.row_from(x, y) >> i) & 1) == blocks.is_empty(x + i, y));
+                    if(x - i >= -1)
+                        REQUIRE(((blocks.row_until(x, y) >> (63 - i)) & 1) == blocks.is_empty(x - i, y));
+                    if(y + i <= large.height)
+                        REQUIRE(((blocks.column_from(x, y) >> i) & 1) == blocks.is_empty(x, y + i));
+                    if(y - i >= -1)
+                        REQUIRE(((blocks.column_until(x, y) >> (63 - i)) & 1) == blocks.is_empty(x, y - i));
+                }
+            }
+        }
+
+        // The columns are kept when the grid is updated without them.
+        REQUIRE_FALSE(blocks.update(large));
+        REQUIRE(blocks.get_memory_usage() > Grid{large}.get_memory_usage());
+    }
+}
+
+TEST_CASE("node index layouts", "[map]")
+{
+    RowMajorLayout row_major{5, 3};
+    PowerOfTwoLayout power_of_two{5, 3};
+
+    REQUIRE(row_major.size() == 15);
+    REQUIRE(power_of_two.size() == 8 * 3);
+
+    for(int y = 0; y < 3; ++y)
+    {
+        for(int x = 0; x < 5; ++x)
+        {
+            REQUIRE(row_major.expand(row_major.flatten(x, y)) == std::pair<int, int>{x, y});
+            REQUIRE(power_of_two.expand(power_of_two.flatten(x, y)) == std::pair<int, int>{x, y});
+            REQUIRE(row_major.map_index(row_major.flatten(x, y)) == Util::flatten(5, x, y));
+            REQUIRE(power_of_two.map_index(power_of_two.flatten(x, y)) == Util::flatten(5, x, y));
+
+            for(int i = 0; i < 8; ++i)
+            {
+                auto [dx, dy] = directions[i]->movement;
+                if(x + dx < 0 || x + dx >= 5 || y + dy < 0 || y + dy >= 3)
+                    continue;
+                REQUIRE(power_of_two.flatten(x, y) + power_of_two.offsets[i] == power_of_two.flatten(x + dx, y + dy));
+                REQUIRE(row_major.flatten(x, y) + row_major.offsets[i] == row_major.flatten(x + dx, y + dy));
+            }
+        }
+    }
+
+    // Powers of two are not padded any further
+    REQUIRE(PowerOfTwoLayout{8, 2}.size() == 16);
+    REQUIRE(PowerOfTwoLayout{1, 2}.size() == 4);
+}
+
+TEST_CASE("scratch pool", "[data_structure]")
+{
+    struct Node : SearchNode<>
+    {
+        int tag = 0;
+    };
+
+    SECTION("buffers only grow")
+    {
+        ScratchBuffer<Node> buffer;
+        buffer.lease(100);
+        REQUIRE(buffer.size() == 100);
+        auto bytes = buffer.get_memory_usage();
+
+        buffer.lease(10);
+        REQUIRE(buffer.size() == 100);
+        REQUIRE(buffer.get_memory_usage() == bytes);
+    }
+
+    SECTION("generations continue across blocks and owners")
+    {
+        uint32_t last_run;
+        {
+            ScratchBuffer<Node> buffer;
+            buffer.lease(50);
+            buffer.next_generation();
+            last_run = buffer.next_generation();
+            Util::lazy_initialize(last_run, buffer[7]);
+            buffer[7].tag = 1;
+        }
+
+        // The block of the destroyed buffer is reused, and its old stamps are stale for the new owner.
+        ScratchBuffer<Node> buffer;
+        buffer.lease(50);
+        auto run = buffer.next_generation();
+        REQUIRE(run > last_run);
+        REQUIRE_FALSE(buffer[7].is_current(run));
+
+        // Growing into a new block keeps the counter monotonic.
+        buffer.lease(1000);
+        REQUIRE(buffer.next_generation() > run);
+    }
+
+    SECTION("blocks are leased for one map at a time")
+    {
+        struct Record : SearchNode<>
+        {
+            int tag = 0;
+        };
+        auto& pool = ScratchPool<Record>::shared();
+        int map_a, map_b;
+
+        {
+            ScratchBuffer<Record> a;
+            ScratchBuffer<Record> b;
+            a.lease(100, {&map_a});
+            a[0].tag = 1;
+            b.lease(100, {&map_b});
+            b[0].tag = 2;
+        }
+        auto pooled = pool.get_memory_usage();
+
+        // A buffer gets the block last used for its map.
+        ScratchBuffer<Record> buffer;
+        buffer.lease(100, {&map_b});
+        REQUIRE(buffer[0].tag == 2);
+
+        // On a map change the block goes back into the pool, and the block of the other map is taken without allocating.
+        buffer.lease(50, {&map_a});
+        REQUIRE(buffer[0].tag == 1);
+        REQUIRE(buffer.size() == 100);
+        REQUIRE(pool.get_memory_usage() + buffer.get_memory_usage() == pooled);
+
+        // A larger map grows one of the free blocks instead of allocating another one.
+        buffer.lease(1000, {&map_b});
+        REQUIRE(buffer.size() == 1000);
+        REQUIRE(pool.get_memory_usage() == pooled / 2);
+    }
+
+    SECTION("the blocks of a thread go back into the shared list when it exits")
+    {
+        struct Record : SearchNode<>
+        {
+            int tag = 0;
+        };
+        auto& pool = ScratchPool<Record>::shared();
+        int map;
+
+        std::thread([&]()
+        {
+            ScratchBuffer<Record> buffer;
+            buffer.lease(100, {&map});
+            buffer[0].tag = 3;
+        }).join();
+        REQUIRE(pool.get_memory_usage() == 100 * sizeof(Record));
+
+        ScratchBuffer<Record> buffer;
+        buffer.lease(100, {&map});
+        REQUIRE(buffer[0].tag == 3);
+        REQUIRE(pool.get_memory_usage() == 0);
+    }
+
+    SECTION("a thread keeps a limited amount of free blocks")
+    {
+        struct Record : SearchNode<>
+        {
+            int tag = 0;
+        };
+        auto& pool = ScratchPool<Record>::shared();
+        constexpr size_t amount = ScratchPool<Record>::THREAD_BLOCKS + 2;
+
+        // The blocks above the limit are in the shared list, so another thread can take them.
+        {
+            std::vector<ScratchBuffer<Record>> buffers(amount);
+            for(auto& buffer : buffers)
+                buffer.lease(10);
+        }
+        size_t shared = 0;
+        bool reused = false;
+        std::thread([&]()
+        {
+            shared = pool.get_memory_usage();
+            ScratchBuffer<Record> buffer;
+            buffer.lease(10);
+            reused = pool.get_memory_usage() < shared;
+        }).join();
+        REQUIRE(shared == (amount - ScratchPool<Record>::THREAD_BLOCKS) * 10 * sizeof(Record));
+        REQUIRE(reused);
+    }
+}
+
+TEST_CASE("scratch arena", "[data_structure]")
+{
+    SECTION("nodes are reset when first touched in a run")
+    {
+        ScratchArena<SearchNode<>> arena;
+        arena.begin_run(10);
+        arena.touch(3).distance = 5.0f;
+        REQUIRE(arena.touch(3).distance == 5.0f);
+
+        arena.begin_run(10);
+        REQUIRE(arena.touch(3).distance == std::numeric_limits<float>::infinity());
+    }
+
+    SECTION("run ids roll over into a new epoch")
+    {
+        typedef SearchNode<float, uint16_t> NarrowNode;
+        REQUIRE(sizeof(NarrowNode) == 6);
+
+        ScratchArena<NarrowNode> arena;
+        arena.begin_run(10);
+        arena.touch(1).distance = 1.0f;
+        arena.touch(1).set_status(3);
+
+        for(uint32_t i = 1; i < NarrowNode::GENERATION_MASK; ++i)
+        {
+            arena.begin_run(10);
+            REQUIRE(arena.get_run_id() == i + 1);
+        }
+        REQUIRE(arena.get_epoch() == 0);
+
+        // The next run id would not fit into the stamp: all nodes are reset and the ids start again from 1.
+        arena.begin_run(10);
+        REQUIRE(arena.get_epoch() == 1);
+        REQUIRE(arena.get_run_id() == 1);
+
+        // Node 1 was stamped with run id 1 in the previous epoch, but it is still reset.
+        REQUIRE(arena.touch(1).distance == std::numeric_limits<float>::infinity());
+        REQUIRE(arena.touch(1).status() == 0);
+    }
+
+    SECTION("a rollover only resets the nodes of the current run in bulk")
+    {
+        typedef SearchNode<float, uint16_t> NarrowNode;
+
+        ScratchArena<NarrowNode> arena;
+        arena.begin_run(100);
+        auto stamped_run = arena.begin_run(100);
+        arena.touch(50).distance = 1.0f;
+
+        while(arena.get_epoch() == 0)
+            arena.begin_run(10);
+        REQUIRE(arena[50].distance == 1.0f);
+
+        // The rest of the nodes are reset before a run needs them, so node 50 is not taken as valid
+        // when the run ids reach its old stamp again.
+        while(arena.get_run_id() + 1 < stamped_run)
+            arena.begin_run(10);
+        REQUIRE(arena.begin_run(100) == stamped_run);
+        REQUIRE(arena.lookup(50) == nullptr);
+    }
 }
\ No newline at end of file